@@ -0,0 +1,649 @@
+/** @file
+   Pomiary wydajności operacji na wielomianach
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "poly.h"
+#include "poly_batch.h"
+#include "poly_dist.h"
+#include "poly_roots.h"
+#include "poly_sched.h"
+#include "poly_vec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ROOTS "roots"
+#define DIST "dist"
+#define MUL_THREADS "mul-threads"
+#define SCHED "sched"
+#define BATCH "batch"
+#define VEC "vec"
+#define SUM_DOT "sum-dot"
+#define FMA "fma"
+
+/** Domyślny maksymalny stopień wielomianów w pomiarach */
+#define DEFAULT_MAX_DEG 3000
+
+/** Domyślny wykładnik w teście Fatemana */
+#define DEFAULT_FATEMAN_EXP 10
+
+/** Domyślna największa liczba wątków w pomiarach skalowania */
+#define DEFAULT_MAX_THREADS 8
+
+/** Wykładnik w teście Fatemana przy pomiarach skalowania */
+#define SCALING_FATEMAN_EXP 12
+
+/** Liczba operacji we wsadzie */
+#define BATCH_OPS 20000
+
+/** Liczba różnych wielomianów, na których działają operacje wsadu */
+#define BATCH_POLYS 256
+
+/** Domyślna liczba wielomianów (pasów) w pomiarze wektorów wielomianów */
+#define DEFAULT_VEC_LANES 4096
+
+/** Liczba powtórzeń operacji w pomiarze wektorów wielomianów */
+#define VEC_ROUNDS 20
+
+/** Domyślna liczba sumowanych wielomianów w pomiarze PolySumN i PolyDot */
+#define DEFAULT_SUM_COUNT 1000
+
+/** Stopień wielomianów w pomiarze PolySumN i PolyDot */
+#define SUM_DEG 100000
+
+/** Domyślna liczba kroków `acc = acc + p * q` w pomiarze PolyFma */
+#define DEFAULT_FMA_ROUNDS 2000
+
+/** Stopień akumulatora w pomiarze PolyFma */
+#define FMA_DEG 4000
+
+/** Liczba różnych czynników w pomiarze PolyFma */
+#define FMA_POLYS 64
+
+void PrintHelp(char *program_name);
+
+/**
+ * Zwraca czas zegara monotonicznego.
+ * @return czas w sekundach
+ */
+static double Now() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + (double) t.tv_nsec * 1e-9;
+}
+
+/**
+ * Losuje wielomian zmiennej @f$x_0@f$ o współczynnikach z przedziału
+ * `[-100, 100]`. Wielomian rzadki ma oprócz wyrazu wolnego
+ * i wiodącego średnio osiem jednomianów.
+ * @param deg : stopień
+ * @param sparse : czy wielomian ma być rzadki
+ * @return wielomian
+ */
+static Poly RandomUnivariate(poly_exp_t deg, bool sparse) {
+    Mono *monos = malloc(((size_t) deg + 1) * sizeof(struct Mono));
+    unsigned count = 0;
+    for (poly_exp_t i = 0; i <= deg; i++) {
+        if (sparse && i != 0 && i != deg && rand() % (deg / 8 + 1) != 0) {
+            continue;
+        }
+        poly_coeff_t c = rand() % 201 - 100;
+        if (c == 0) {
+            c = 1;
+        }
+        Poly p = PolyFromCoeff(c);
+        monos[count++] = MonoFromPoly(&p, i);
+    }
+    Poly res = PolyAddMonos(count, monos);
+    free(monos);
+    return res;
+}
+
+/**
+ * Mierzy czas izolacji pierwiastków rzeczywistych wielomianów gęstych
+ * i rzadkich stopni od 100 do @p max_deg (najwyżej 3000 - zob.
+ * PolyRealRootIntervals).
+ * @param max_deg : maksymalny stopień
+ */
+static void BenchRoots(poly_exp_t max_deg) {
+    const poly_exp_t degrees[] = {100, 300, 1000, 3000};
+    printf("%-8s %-8s %-8s %-8s %s\n", "degree", "kind", "terms", "roots", "seconds");
+    for (size_t i = 0; i < sizeof(degrees) / sizeof(degrees[0]); i++) {
+        if (degrees[i] > max_deg) {
+            break;
+        }
+        for (int sparse = 0; sparse <= 1; sparse++) {
+            srand((unsigned) degrees[i]);
+            Poly p = RandomUnivariate(degrees[i], sparse);
+            unsigned terms = (p.coeff != 0);
+            for (MonoList l = p.list; l != NULL; l = l->tail) {
+                terms++;
+            }
+
+            RootInterval *out = malloc((size_t) degrees[i] * sizeof(RootInterval));
+            size_t count;
+            double start = Now();
+            bool ok = PolyRealRootIntervals(&p, out, &count);
+            double time = Now() - start;
+            if (ok) {
+                printf("%-8d %-8s %-8u %-8zu %.3f\n", degrees[i],
+                       sparse ? "sparse" : "dense", terms, count, time);
+            }
+            else {
+                printf("%-8d %-8s %-8u %-8s %.3f\n", degrees[i],
+                       sparse ? "sparse" : "dense", terms, "failed", time);
+            }
+            free(out);
+            PolyDestroy(&p);
+        }
+    }
+}
+
+/**
+ * Liczy @f$(1 + x_0 + x_1 + x_2 + x_3)^e@f$.
+ * @param e : wykładnik
+ * @return wielomian
+ */
+static Poly FatemanBase(unsigned e) {
+    // 1 + x_3, potem kolejno dokładamy x_2, x_1 i x_0
+    Poly one = PolyFromCoeff(1);
+    Mono m = MonoFromPoly(&one, 1);
+    Poly s = PolyAddMonos(1, &m);
+    s.coeff = 1;
+    for (int v = 0; v < 3; v++) {
+        Poly x = PolyFromCoeff(1);
+        Mono mx = MonoFromPoly(&x, 1);
+        Mono ms = MonoFromPoly(&s, 0);
+        Mono monos[2] = {ms, mx};
+        s = PolyAddMonos(2, monos);
+    }
+
+    Poly res = PolyFromCoeff(1);
+    for (unsigned i = 0; i < e; i++) {
+        Poly next = PolyMul(&res, &s);
+        PolyDestroy(&res);
+        res = next;
+    }
+    PolyDestroy(&s);
+    return res;
+}
+
+/**
+ * Mierzy mnożenie @f$f \cdot (f + 1)@f$ dla
+ * @f$f = (1 + x_0 + x_1 + x_2 + x_3)^e@f$ (test Fatemana) w reprezentacji
+ * rekurencyjnej i rozproszonej w każdym porządku.
+ * @param e : wykładnik
+ */
+static void BenchDist(unsigned e) {
+    Poly f = FatemanBase(e);
+    Poly one = PolyFromCoeff(1);
+    Poly g = PolyAdd(&f, &one);
+    printf("f = (1 + x0 + x1 + x2 + x3)^%u, %zu terms\n", e, PolyTermCount(&f));
+    printf("%-12s %-10s %-10s %-10s %-8s %s\n", "method", "to dist", "multiply", "to poly",
+           "terms", "bytes");
+
+    double start = Now();
+    Poly h = PolyMul(&f, &g);
+    printf("%-12s %-10s %-10.3f %-10s %-8zu %s\n", "recursive", "-", Now() - start, "-",
+           PolyTermCount(&h), "-");
+
+    const PolyOrder orders[] = {POLY_LEX, POLY_GRLEX, POLY_GREVLEX};
+    const char *names[] = {"lex", "grlex", "grevlex"};
+    for (int k = 0; k < 3; k++) {
+        PolyDist df, dg, dh;
+        start = Now();
+        PolyDistFromPoly(&f, 4, orders[k], &df);
+        PolyDistFromPoly(&g, 4, orders[k], &dg);
+        double convert = Now() - start;
+        start = Now();
+        PolyDistMul(&df, &dg, &dh);
+        double mul = Now() - start;
+        start = Now();
+        Poly back = PolyDistToPoly(&dh);
+        double back_time = Now() - start;
+        printf("%-12s %-10.3f %-10.3f %-10.3f %-8zu %zu (%u-byte coeffs)%s\n", names[k],
+               convert, mul, back_time, dh.count, PolyDistBytes(&dh), dh.coeff_bytes,
+               PolyIsEq(&back, &h) ? "" : " MISMATCH");
+        PolyDestroy(&back);
+        PolyDistDestroy(&df);
+        PolyDistDestroy(&dg);
+        PolyDistDestroy(&dh);
+    }
+    PolyDestroy(&f);
+    PolyDestroy(&g);
+    PolyDestroy(&h);
+}
+
+/**
+ * Mierzy mnożenie @f$f \cdot (f + 1)@f$ z testu Fatemana funkcją
+ * PolyMulParallel dla od 1 do @p max_threads wątków.
+ * @param max_threads : największa liczba wątków
+ */
+static void BenchMulThreads(unsigned max_threads) {
+    Poly f = FatemanBase(SCALING_FATEMAN_EXP);
+    Poly one = PolyFromCoeff(1);
+    Poly g = PolyAdd(&f, &one);
+    printf("f = (1 + x0 + x1 + x2 + x3)^%u, %zu terms\n", SCALING_FATEMAN_EXP,
+           PolyTermCount(&f));
+    printf("%-8s %-10s %s\n", "threads", "multiply", "speedup");
+
+    Poly expected = PolyMul(&f, &g);
+    double base = 0;
+    for (unsigned t = 1; t <= max_threads; t++) {
+        double start = Now();
+        Poly h = PolyMulParallel(&f, &g, t);
+        double time = Now() - start;
+        base = (t == 1) ? time : base;
+        printf("%-8u %-10.3f %.2f%s\n", t, time, base / time,
+               PolyIsEq(&h, &expected) ? "" : " MISMATCH");
+        PolyDestroy(&h);
+    }
+    PolyDestroy(&expected);
+    PolyDestroy(&f);
+    PolyDestroy(&g);
+}
+
+/**
+ * Mierzy mnożenie @f$f \cdot (f + 1)@f$ z testu Fatemana funkcją
+ * PolySchedMul dla od 1 do @p max_threads wątków planisty.
+ * @param max_threads : największa liczba wątków
+ */
+static void BenchSched(unsigned max_threads) {
+    Poly f = FatemanBase(SCALING_FATEMAN_EXP);
+    Poly one = PolyFromCoeff(1);
+    Poly g = PolyAdd(&f, &one);
+    printf("f = (1 + x0 + x1 + x2 + x3)^%u, %zu terms\n", SCALING_FATEMAN_EXP,
+           PolyTermCount(&f));
+    printf("%-8s %-10s %s\n", "threads", "multiply", "speedup");
+
+    double start = Now();
+    Poly expected = PolyMul(&f, &g);
+    double base = Now() - start;
+    printf("%-8s %-10.3f %.2f\n", "PolyMul", base, 1.0);
+    for (unsigned t = 1; t <= max_threads; t++) {
+        PolySched *s = PolySchedNew(t);
+        start = Now();
+        Poly h = PolySchedMul(s, &f, &g);
+        double time = Now() - start;
+        printf("%-8u %-10.3f %.2f%s\n", t, time, base / time,
+               PolyIsEq(&h, &expected) ? "" : " MISMATCH");
+        PolyDestroy(&h);
+        PolySchedDestroy(s);
+    }
+    PolyDestroy(&expected);
+    PolyDestroy(&f);
+    PolyDestroy(&g);
+}
+
+/**
+ * Mierzy wykonanie wsadu małych, niezależnych operacji (mnożenie,
+ * dodawanie, wartość, stopień) na losowych wielomianach: po kolei
+ * w jednym wątku oraz funkcją PolyBatchRun dla od 1 do @p max_threads
+ * wątków planisty. Opóźnienie to czas do otrzymania wyników całego wsadu.
+ * @param max_threads : największa liczba wątków
+ */
+static void BenchBatch(unsigned max_threads) {
+    srand(45);
+    Poly *polys = malloc(BATCH_POLYS * sizeof(Poly));
+    for (unsigned i = 0; i < BATCH_POLYS; i++) {
+        polys[i] = RandomUnivariate(8 + rand() % 25, i % 2 == 0);
+    }
+    const PolyBatchKind kinds[] = {POLY_BATCH_MUL, POLY_BATCH_ADD, POLY_BATCH_AT,
+                                   POLY_BATCH_DEG};
+    PolyBatchOp *ops = malloc(BATCH_OPS * sizeof(PolyBatchOp));
+    for (unsigned i = 0; i < BATCH_OPS; i++) {
+        ops[i] = (PolyBatchOp) {.kind = kinds[i % 4], .p = &polys[rand() % BATCH_POLYS],
+                                .q = &polys[rand() % BATCH_POLYS], .x = rand() % 5 - 2};
+    }
+    PolyBatchResult *results = malloc(BATCH_OPS * sizeof(PolyBatchResult));
+    printf("%u operations on %u polynomials\n", BATCH_OPS, BATCH_POLYS);
+    printf("%-10s %-10s %-12s %s\n", "threads", "latency", "ops/s", "speedup");
+
+    double start = Now();
+    PolyBatchRun(NULL, ops, BATCH_OPS, results);
+    double base = Now() - start;
+    printf("%-10s %-10.3f %-12.0f %.2f\n", "serial", base, BATCH_OPS / base, 1.0);
+    Poly *expected = malloc(BATCH_OPS * sizeof(Poly));
+    for (unsigned i = 0; i < BATCH_OPS; i++) {
+        expected[i] = results[i].poly;
+    }
+
+    for (unsigned t = 1; t <= max_threads; t++) {
+        PolySched *s = PolySchedNew(t);
+        start = Now();
+        PolyBatchRun(s, ops, BATCH_OPS, results);
+        double time = Now() - start;
+        bool ok = true;
+        for (unsigned i = 0; i < BATCH_OPS; i++) {
+            ok &= PolyIsEq(&(results[i].poly), &expected[i]);
+        }
+        printf("%-10u %-10.3f %-12.0f %.2f%s\n", t, time, BATCH_OPS / time,
+               base / time, ok ? "" : " MISMATCH");
+        PolyBatchResultsDestroy(results, BATCH_OPS);
+        PolySchedDestroy(s);
+    }
+
+    for (unsigned i = 0; i < BATCH_OPS; i++) {
+        PolyDestroy(&expected[i]);
+    }
+    for (unsigned i = 0; i < BATCH_POLYS; i++) {
+        PolyDestroy(&polys[i]);
+    }
+    free(expected);
+    free(results);
+    free(ops);
+    free(polys);
+}
+
+/**
+ * Tworzy mały wielomian dwóch zmiennych o stałym kształcie
+ * @f$\sum_{i \le 3, j \le 2} c_{ij} x_0^i x_1^j@f$ i losowych współczynnikach.
+ * @return wielomian
+ */
+static Poly RandomSmallShape() {
+    Mono monos[4];
+    for (poly_exp_t i = 0; i <= 3; i++) {
+        Mono inner[3];
+        for (poly_exp_t j = 0; j <= 2; j++) {
+            Poly c = PolyFromCoeff(rand() % 19 + 1);
+            inner[j] = MonoFromPoly(&c, j);
+        }
+        Poly coeff = PolyAddMonos(3, inner);
+        monos[i] = MonoFromPoly(&coeff, i);
+    }
+    return PolyAddMonos(4, monos);
+}
+
+/**
+ * Porównuje operacje na wielu małych wielomianach tego samego kształtu:
+ * osobno na każdym wielomianie i na wektorze wielomianów z jądrami
+ * skalarnymi oraz AVX2.
+ * @param lanes : liczba wielomianów
+ */
+static void BenchVec(size_t lanes) {
+    srand(48);
+    Poly *a = malloc(lanes * sizeof(Poly));
+    Poly *b = malloc(lanes * sizeof(Poly));
+    Poly *r = malloc(lanes * sizeof(Poly));
+    poly_coeff_t *values = malloc(lanes * sizeof(poly_coeff_t));
+    for (size_t l = 0; l < lanes; l++) {
+        a[l] = RandomSmallShape();
+        b[l] = RandomSmallShape();
+    }
+    const poly_coeff_t x[2] = {3, -2};
+    printf("%zu polynomials, %d rounds\n", lanes, VEC_ROUNDS);
+    printf("%-14s %-10s %-10s %s\n", "variant", "add", "mul", "at");
+
+    double start = Now();
+    for (int i = 0; i < VEC_ROUNDS; i++) {
+        for (size_t l = 0; l < lanes; l++) {
+            r[l] = PolyAdd(&a[l], &b[l]);
+            PolyDestroy(&r[l]);
+        }
+    }
+    double add = Now() - start;
+    start = Now();
+    for (int i = 0; i < VEC_ROUNDS; i++) {
+        for (size_t l = 0; l < lanes; l++) {
+            r[l] = PolyMul(&a[l], &b[l]);
+            PolyDestroy(&r[l]);
+        }
+    }
+    double mul = Now() - start;
+    start = Now();
+    for (int i = 0; i < VEC_ROUNDS; i++) {
+        for (size_t l = 0; l < lanes; l++) {
+            Poly at0 = PolyAt(&a[l], x[0]);
+            Poly at1 = PolyAt(&at0, x[1]);
+            values[l] = at1.coeff;
+            PolyDestroy(&at0);
+            PolyDestroy(&at1);
+        }
+    }
+    double at = Now() - start;
+    printf("%-14s %-10.4f %-10.4f %.4f\n", "per-poly", add, mul, at);
+
+    PolyVec va, vb;
+    PolyVecFromPolys(a, lanes, 2, &va);
+    PolyVecFromPolys(b, lanes, 2, &vb);
+    for (int simd = 0; simd <= 1; simd++) {
+        if (PolyVecEnableSimd(simd) != simd) {
+            printf("%-14s unsupported\n", "vec avx2");
+            continue;
+        }
+        PolyVec vr;
+        start = Now();
+        for (int i = 0; i < VEC_ROUNDS; i++) {
+            PolyVecAdd(&va, &vb, &vr);
+            PolyVecDestroy(&vr);
+        }
+        add = Now() - start;
+        start = Now();
+        for (int i = 0; i < VEC_ROUNDS; i++) {
+            PolyVecMul(&va, &vb, &vr);
+            PolyVecDestroy(&vr);
+        }
+        mul = Now() - start;
+        start = Now();
+        for (int i = 0; i < VEC_ROUNDS; i++) {
+            PolyVecAt(&va, x, values);
+        }
+        at = Now() - start;
+
+        // sprawdzenie kilku pasów
+        bool ok = true;
+        PolyVecMul(&va, &vb, &vr);
+        for (size_t l = 0; l < lanes; l += lanes / 8 + 1) {
+            Poly expected = PolyMul(&a[l], &b[l]);
+            Poly got = PolyVecGet(&vr, l);
+            ok &= PolyIsEq(&expected, &got);
+            PolyDestroy(&expected);
+            PolyDestroy(&got);
+        }
+        PolyVecDestroy(&vr);
+        printf("%-14s %-10.4f %-10.4f %.4f%s\n", simd ? "vec avx2" : "vec scalar",
+               add, mul, at, ok ? "" : " MISMATCH");
+    }
+    PolyVecEnableSimd(true);
+
+    PolyVecDestroy(&va);
+    PolyVecDestroy(&vb);
+    for (size_t l = 0; l < lanes; l++) {
+        PolyDestroy(&a[l]);
+        PolyDestroy(&b[l]);
+    }
+    free(values);
+    free(r);
+    free(b);
+    free(a);
+}
+
+/**
+ * Porównuje sumowanie @p n wielomianów kolejnymi wywołaniami PolyAdd
+ * z PolySumN oraz sumę iloczynów (PolyMul i PolyAdd) z PolyDot.
+ * @param n : liczba wielomianów
+ */
+static void BenchSumDot(unsigned n) {
+    srand(49);
+    Poly *a = malloc(n * sizeof(Poly));
+    Poly *b = malloc(n * sizeof(Poly));
+    for (unsigned i = 0; i < n; i++) {
+        a[i] = RandomUnivariate(SUM_DEG / 2 + rand() % (SUM_DEG / 2), true);
+        b[i] = RandomUnivariate(8 + rand() % 8, true);
+    }
+    printf("%u polynomials of degree up to %d\n", n, SUM_DEG);
+    printf("%-10s %-10s %-10s %s\n", "operation", "pairwise", "fused", "speedup");
+
+    double start = Now();
+    Poly expected = PolyZero();
+    for (unsigned i = 0; i < n; i++) {
+        Poly next = PolyAdd(&expected, &a[i]);
+        PolyDestroy(&expected);
+        expected = next;
+    }
+    double pairwise = Now() - start;
+    start = Now();
+    Poly got = PolySumN(a, n);
+    double fused = Now() - start;
+    printf("%-10s %-10.4f %-10.4f %.2f%s\n", "sum", pairwise, fused, pairwise / fused,
+           PolyIsEq(&expected, &got) ? "" : " MISMATCH");
+    PolyDestroy(&expected);
+    PolyDestroy(&got);
+
+    start = Now();
+    expected = PolyZero();
+    for (unsigned i = 0; i < n; i++) {
+        Poly mul = PolyMul(&a[i], &b[i]);
+        Poly next = PolyAdd(&expected, &mul);
+        PolyDestroy(&expected);
+        PolyDestroy(&mul);
+        expected = next;
+    }
+    pairwise = Now() - start;
+    start = Now();
+    got = PolyDot(a, b, n);
+    fused = Now() - start;
+    printf("%-10s %-10.4f %-10.4f %.2f%s\n", "dot", pairwise, fused, pairwise / fused,
+           PolyIsEq(&expected, &got) ? "" : " MISMATCH");
+    PolyDestroy(&expected);
+    PolyDestroy(&got);
+
+    for (unsigned i = 0; i < n; i++) {
+        PolyDestroy(&a[i]);
+        PolyDestroy(&b[i]);
+    }
+    free(b);
+    free(a);
+}
+
+/**
+ * Porównuje pętlę `acc = acc + p * q` liczoną przez PolyMul i PolyAdd
+ * z PolyFma na gęstym akumulatorze i rzadkich czynnikach.
+ * @param rounds : liczba kroków
+ */
+static void BenchFma(unsigned rounds) {
+    srand(50);
+    Poly *polys = malloc(FMA_POLYS * sizeof(Poly));
+    for (unsigned i = 0; i < FMA_POLYS; i++) {
+        polys[i] = RandomUnivariate(FMA_DEG / 4 + rand() % (FMA_DEG / 4), true);
+    }
+    unsigned *pairs = malloc(2 * rounds * sizeof(unsigned));
+    for (unsigned i = 0; i < 2 * rounds; i++) {
+        pairs[i] = (unsigned) rand() % FMA_POLYS;
+    }
+    Poly start_acc = RandomUnivariate(FMA_DEG, false);
+    printf("%u steps, accumulator of degree %d\n", rounds, FMA_DEG);
+    printf("%-10s %-10s %s\n", "variant", "time", "allocated elements");
+
+    Poly expected = PolyClone(&start_acc);
+    size_t allocs = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).allocs;
+    double start = Now();
+    for (unsigned i = 0; i < rounds; i++) {
+        Poly mul = PolyMul(&polys[pairs[2 * i]], &polys[pairs[2 * i + 1]]);
+        Poly next = PolyAdd(&expected, &mul);
+        PolyDestroy(&expected);
+        PolyDestroy(&mul);
+        expected = next;
+    }
+    double time = Now() - start;
+    printf("%-10s %-10.4f %zu\n", "mul+add", time,
+           PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).allocs - allocs);
+
+    // Akumulator nie może współdzielić elementów, żeby PolyFma zmieniała go
+    // w miejscu, więc zaczynamy od jego świeżej kopii (mnożenie przez 1).
+    Poly one = PolyFromCoeff(1);
+    Poly acc = PolyMul(&start_acc, &one);
+    allocs = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).allocs;
+    start = Now();
+    for (unsigned i = 0; i < rounds; i++) {
+        PolyFma(&acc, &polys[pairs[2 * i]], &polys[pairs[2 * i + 1]]);
+    }
+    time = Now() - start;
+    printf("%-10s %-10.4f %zu%s\n", "fma", time,
+           PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).allocs - allocs,
+           PolyIsEq(&acc, &expected) ? "" : " MISMATCH");
+
+    PolyDestroy(&acc);
+    PolyDestroy(&expected);
+    PolyDestroy(&start_acc);
+    for (unsigned i = 0; i < FMA_POLYS; i++) {
+        PolyDestroy(&polys[i]);
+    }
+    free(pairs);
+    free(polys);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    if (strcmp(argv[1], ROOTS) == 0) {
+        poly_exp_t max_deg = (argc > 2) ? atoi(argv[2]) : DEFAULT_MAX_DEG;
+        BenchRoots(max_deg);
+    }
+    else if (strcmp(argv[1], DIST) == 0) {
+        unsigned e = (argc > 2) ? (unsigned) atoi(argv[2]) : DEFAULT_FATEMAN_EXP;
+        BenchDist(e);
+    }
+    else if (strcmp(argv[1], MUL_THREADS) == 0) {
+        unsigned t = (argc > 2) ? (unsigned) atoi(argv[2]) : DEFAULT_MAX_THREADS;
+        BenchMulThreads(t);
+    }
+    else if (strcmp(argv[1], SCHED) == 0) {
+        unsigned t = (argc > 2) ? (unsigned) atoi(argv[2]) : DEFAULT_MAX_THREADS;
+        BenchSched(t);
+    }
+    else if (strcmp(argv[1], BATCH) == 0) {
+        unsigned t = (argc > 2) ? (unsigned) atoi(argv[2]) : DEFAULT_MAX_THREADS;
+        BenchBatch(t);
+    }
+    else if (strcmp(argv[1], VEC) == 0) {
+        size_t lanes = (argc > 2) ? (size_t) atol(argv[2]) : DEFAULT_VEC_LANES;
+        BenchVec(lanes);
+    }
+    else if (strcmp(argv[1], SUM_DOT) == 0) {
+        unsigned n = (argc > 2) ? (unsigned) atoi(argv[2]) : DEFAULT_SUM_COUNT;
+        BenchSumDot(n);
+    }
+    else if (strcmp(argv[1], FMA) == 0) {
+        unsigned rounds = (argc > 2) ? (unsigned) atoi(argv[2]) : DEFAULT_FMA_ROUNDS;
+        BenchFma(rounds);
+    }
+    else {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Wypisuje na standardowe wyjście informację o argumentach programu
+ * @param program_name nazwa programu
+ */
+void PrintHelp(char *program_name) {
+    const int width = 18;
+    printf("Usage: %s [benchmark] [max degree]\nWhere benchmark can be:\n", program_name);
+    printf("\t%-*s - real root isolation of dense and sparse polynomials\n", width, ROOTS);
+    printf("\t%-*s - recursive vs distributed multiplication (Fateman test, "
+           "argument is the exponent)\n", width, DIST);
+    printf("\t%-*s - parallel multiplication scaling (argument is the maximum "
+           "number of threads)\n", width, MUL_THREADS);
+    printf("\t%-*s - work-stealing scheduler scaling (argument is the maximum "
+           "number of threads)\n", width, SCHED);
+    printf("\t%-*s - batch of small independent operations (argument is the "
+           "maximum number of threads)\n", width, BATCH);
+    printf("\t%-*s - many small same-shape polynomials as a SIMD polynomial vector "
+           "(argument is the number of polynomials)\n", width, VEC);
+    printf("\t%-*s - PolySumN and PolyDot vs pairwise PolyAdd/PolyMul (argument "
+           "is the number of polynomials)\n", width, SUM_DOT);
+    printf("\t%-*s - PolyFma vs PolyMul followed by PolyAdd (argument is the "
+           "number of steps)\n", width, FMA);
+}
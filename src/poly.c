@@ -1,7 +1,150 @@
+#define _POSIX_C_SOURCE 199309L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "poly.h"
+#include "poly_async.h"
+#include "poly_memo.h"
+#include "poly_sched.h"
+
+/** Liczba elementów list przydzielanych jednym wywołaniem malloc */
+#define ELEM_SLAB_SIZE 256
+
+/** Liczba wolnych elementów przekazywanych naraz do wspólnej puli */
+#define ELEM_BATCH_SIZE 64
+
+/** Liczba wolnych elementów, powyżej której wątek oddaje je do puli */
+#define ELEM_CACHE_LIMIT (4 * ELEM_BATCH_SIZE)
+
+/** Zmiana liczby elementów wątku, po której trafia ona do liczników biblioteki */
+#define ELEM_STATS_BATCH 64
+
+/** Liczba jednomianów, poniżej której PolyAddMonos nie dzieli sortowania na zadania */
+#define SORT_TASK_CUTOFF 4096
+
+/** Liczba jednomianów, poniżej której sortowanie pozycyjne zastępowane jest przez wstawianie */
+#define SORT_INSERTION_CUTOFF 16
+
+/** Liczba jednomianów, które PolyAddMonos sortuje w buforze na stosie */
+#define ADD_MONOS_STACK 16
+
+/** Liczba sprawdzeń budżetu, po których odczytywany jest zegar */
+#define BUDGET_CLOCK_INTERVAL 256
+
+/** Szacowany koszt iloczynu, poniżej którego PolyMulParallel nie tworzy wątków */
+#define MUL_PARALLEL_MIN_WORK 4096
+
+/** Liczba iloczynów jednomianów sumowanych naraz przez PolyDot */
+#define DOT_CHUNK_MONOS (1 << 15)
+
+/**
+ * Element listy przydzielany razem ze swoją głową. Wolne bloki łączone są
+ * w listy przez pole `tail` elementu.
+ */
+typedef struct ElemBlock {
+    struct MonoElem elem; ///< element listy
+    Mono mono; ///< głowa elementu
+} ElemBlock;
+
+/**
+ * Liczniki przydziałów jednego rodzaju pamięci w wątku.
+ */
+typedef struct AllocCounter {
+    long long live; ///< liczba niezwolnionych obiektów
+    size_t allocs; ///< liczba przydziałów
+    long long peak; ///< największa wartość `live`
+} AllocCounter;
+
+/**
+ * Liczniki przydziałów jednego rodzaju pamięci w całej bibliotece.
+ */
+typedef struct SharedAllocCounter {
+    _Atomic long long live; ///< liczba niezwolnionych obiektów
+    _Atomic size_t allocs; ///< liczba przydziałów
+    _Atomic long long peak; ///< największa wartość `live`
+} SharedAllocCounter;
+
+/**
+ * Wolne elementy i liczniki przydziałów wątku.
+ */
+typedef struct ElemCache {
+    MonoList free; ///< lista wolnych elementów
+    size_t count; ///< długość listy wolnych elementów
+    bool registered; ///< czy wątek zgłosił oddanie elementów przy wyjściu
+    AllocCounter counters[POLY_ALLOC_COUNT]; ///< liczniki wątku
+    long long pending_live; ///< zmiana liczby elementów nieprzekazana bibliotece
+    size_t pending_allocs; ///< przydziały elementów nieprzekazane bibliotece
+} ElemCache;
+
+/**
+ * Porcja wolnych elementów we wspólnej puli.
+ */
+typedef struct ElemBatch {
+    MonoList free; ///< lista wolnych elementów
+    size_t count; ///< długość listy
+} ElemBatch;
+
+/** Wolne elementy bieżącego wątku */
+static _Thread_local ElemCache elem_cache;
+
+/** Blokada wspólnej puli elementów */
+static pthread_mutex_t elem_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/** Porcje wolnych elementów oddane przez wątki */
+static ElemBatch *elem_batches;
+
+/** Liczba porcji we wspólnej puli */
+static size_t elem_batch_count;
+
+/** Rozmiar tablicy porcji */
+static size_t elem_batch_capacity;
+
+/** Wszystkie przydzielone bloki elementów */
+static ElemBlock **elem_slabs;
+
+/** Liczba przydzielonych bloków elementów */
+static size_t elem_slab_count;
+
+/** Rozmiar tablicy bloków */
+static size_t elem_slab_capacity;
+
+/** Klucz, którego destruktor oddaje elementy kończącego się wątku */
+static pthread_key_t elem_cache_key;
+
+/** Jednokrotne tworzenie klucza elem_cache_key */
+static pthread_once_t elem_cache_key_once = PTHREAD_ONCE_INIT;
+
+/** Kod ostatniego błędu bieżącego wątku */
+static _Thread_local PolyError poly_error;
+
+/**
+ * Budżet operacji wątku.
+ */
+typedef struct BudgetState {
+    PolyBudget limits; ///< limity
+    bool active; ///< czy budżet jest ustawiony
+    long long base_live; ///< liczba elementów wątku przy ustawieniu budżetu
+    double deadline; ///< chwila, po której operacje są przerywane
+    unsigned ticks; ///< liczba sprawdzeń od ostatniego odczytu zegara
+} BudgetState;
+
+/** Budżet operacji bieżącego wątku */
+static _Thread_local BudgetState poly_budget;
+
+/** Liczniki przydziałów całej biblioteki */
+static SharedAllocCounter alloc_counters[POLY_ALLOC_COUNT];
+
+/** Rozmiary obiektów poszczególnych rodzajów pamięci w bajtach */
+static const size_t alloc_object_size[POLY_ALLOC_COUNT] = {
+    [POLY_ALLOC_ELEMS] = sizeof(ElemBlock),
+    [POLY_ALLOC_SLABS] = ELEM_SLAB_SIZE * sizeof(ElemBlock)
+};
 
 /**
  * @param a wykładnik
@@ -47,7 +190,182 @@ static bool MonoIsLesserExp(const Mono *m1, const Mono *m2) {
     return (MonoCompareByExp(m1, m2) == -1);
 }
 
+uint64_t PolyHashMix(uint64_t h, uint64_t x) {
+    h = (h ^ x) * 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 32);
+}
+
+/**
+ * Wylicza skrót i parametry listy zaczynającej się od elementu
+ * z jego głowy i zapamiętanych parametrów ogona.
+ * @param l niepusta lista
+ */
+static void MonoElemUpdate(MonoList l) {
+    const Mono *m = l->head;
+    const MonoList tail = l->tail;
+    poly_exp_t deg = m->exp + PolyDeg(&(m->poly));
+    poly_exp_t ord = m->exp + PolyOrd(&(m->poly));
+    unsigned depth = PolyDepth(&(m->poly)) + 1;
+    uint64_t h = PolyHashMix((tail == NULL) ? 0 : tail->hash, (uint64_t) m->exp);
+    l->hash = PolyHashMix(h, PolyHash(&(m->poly)));
+    l->terms = PolyTermCount(&(m->poly));
+    l->nodes = PolyNodeCount(&(m->poly)) + 1;
+    if (tail == NULL) {
+        l->length = 1;
+        l->depth = depth;
+        l->deg = deg;
+        l->deg_main = m->exp;
+        l->ord = ord;
+    }
+    else {
+        l->terms += tail->terms;
+        l->nodes += tail->nodes;
+        l->length = tail->length + 1;
+        l->depth = (depth > tail->depth) ? depth : tail->depth;
+        l->deg = max(deg, tail->deg);
+        l->deg_main = tail->deg_main;
+        l->ord = (ord < tail->ord) ? ord : tail->ord;
+    }
+}
+
+
+
+/**
+ * Zapamiętuje kod błędu bieżącego wątku.
+ * @param e kod błędu
+ */
+static void PolySetError(PolyError e) {
+    poly_error = e;
+}
+
+PolyError PolyLastError() {
+    return poly_error;
+}
+
+void PolyClearError() {
+    poly_error = POLY_OK;
+}
+
+void PolyRestoreError(PolyError error) {
+    PolySetError(error);
+}
+
+/**
+ * Zwraca czas zegara monotonicznego.
+ * @return czas w sekundach
+ */
+static double BudgetNow() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + (double) t.tv_nsec * 1e-9;
+}
+
+void PolyBudgetSet(const PolyBudget *budget) {
+    BudgetState *b = &poly_budget;
+    b->active = budget != NULL && (budget->max_terms != 0 || budget->max_bytes != 0
+                                   || budget->max_seconds > 0);
+    if (!b->active) {
+        return;
+    }
+    b->limits = *budget;
+    b->base_live = elem_cache.counters[POLY_ALLOC_ELEMS].live;
+    b->deadline = BudgetNow() + budget->max_seconds;
+    b->ticks = 0;
+}
+
+bool PolyBudgetGet(PolyBudget *budget) {
+    if (!poly_budget.active) {
+        *budget = (PolyBudget) {.max_terms = 0, .max_bytes = 0, .max_seconds = 0};
+        return false;
+    }
+    *budget = poly_budget.limits;
+    return true;
+}
+
+/**
+ * Sprawdza, czy operacja bieżącego wątku przekroczyła budżet pamięci
+ * (uwzględniając planowany przydział @p bytes bajtów) lub czasu.
+ * Zegar odczytywany jest co BUDGET_CLOCK_INTERVAL sprawdzeń.
+ * @param b budżet wątku
+ * @param bytes rozmiar planowanego przydziału
+ * @return Czy budżet jest przekroczony?
+ */
+static bool BudgetExceeded(BudgetState *b, size_t bytes) {
+    if (b->limits.max_bytes != 0) {
+        long long elems = elem_cache.counters[POLY_ALLOC_ELEMS].live - b->base_live;
+        long long used = elems * (long long) sizeof(ElemBlock) + (long long) bytes;
+        if (used > (long long) b->limits.max_bytes) {
+            return true;
+        }
+    }
+    if (b->limits.max_seconds > 0 && ++b->ticks >= BUDGET_CLOCK_INTERVAL) {
+        b->ticks = 0;
+        return BudgetNow() > b->deadline;
+    }
+    return false;
+}
+
+/**
+ * Sprawdza, czy bieżąca operacja ma zostać przerwana: po braku pamięci,
+ * po przekroczeniu budżetu (wtedy ustawia błąd POLY_ERR_BUDGET) albo na
+ * prośbę (poly_async.h). Wywoływana w pętlach długich operacji.
+ * @return Czy przerwać obliczenie?
+ */
+static bool PolyShouldStop() {
+    if (poly_error == POLY_ERR_BUDGET || poly_error == POLY_ERR_NO_MEMORY) {
+        return true;
+    }
+    if (poly_budget.active && BudgetExceeded(&poly_budget, 0)) {
+        PolySetError(POLY_ERR_BUDGET);
+        return true;
+    }
+    return PolyCancelRequested();
+}
+
+/**
+ * Przydziela pamięć pomocniczą operacji. Przydział, który przekroczyłby
+ * budżet, nie jest wykonywany (błąd POLY_ERR_BUDGET), a brak pamięci
+ * zgłaszany jest błędem POLY_ERR_NO_MEMORY.
+ * @param bytes rozmiar w bajtach
+ * @return przydzielona pamięć lub NULL
+ */
+static void *PolyAlloc(size_t bytes) {
+    if (poly_budget.active && BudgetExceeded(&poly_budget, bytes)) {
+        PolySetError(POLY_ERR_BUDGET);
+        return NULL;
+    }
+    void *ptr = malloc(bytes);
+    if (ptr == NULL) {
+        PolySetError(POLY_ERR_NO_MEMORY);
+    }
+    return ptr;
+}
+
+/**
+ * Zwraca wynik operacji, a jeśli została przerwana - usuwa niepełny
+ * wynik i zwraca wielomian zerowy.
+ * @param res wynik, przejmowany na własność
+ * @return wynik lub wielomian zerowy
+ */
+static Poly PolyStopResult(Poly *res) {
+    if (PolyShouldStop()) {
+        PolyDestroy(res);
+        return PolyZero();
+    }
+    return *res;
+}
 
+/**
+ * Czeka na zadanie planisty i przenosi do bieżącego wątku błąd, który
+ * zgłosiło zadanie wykonane w innym wątku.
+ * @param task zadanie
+ */
+static void TaskJoin(PolyTask *task) {
+    PolyError error = PolyTaskJoin(task);
+    if (error != POLY_OK) {
+        PolySetError(error);
+    }
+}
 
 /**
  * Tworzy jednomian `p * x^e`.
@@ -57,16 +375,225 @@ static bool MonoIsLesserExp(const Mono *m1, const Mono *m2) {
  * @return jednomian `p * x^e`
  */
 Mono MonoFromPoly(Poly *p, poly_exp_t e) {
-    if ((e == 0) && PolyIsCoeff(p)) {
-        fprintf(stderr, "Trying to create incorrect monomial (C*x^0)");
-        exit(1);
+    return (Mono) {.poly = *p, .exp = e};
+}
+
+/**
+ * Uwzględnia w licznikach wątku przydział lub zwolnienie obiektów.
+ * @param c liczniki wątku
+ * @param delta zmiana liczby niezwolnionych obiektów
+ * @param allocs liczba przydziałów
+ */
+static inline void AllocCounterAdd(AllocCounter *c, long long delta, size_t allocs) {
+    c->live += delta;
+    c->allocs += allocs;
+    if (c->live > c->peak) {
+        c->peak = c->live;
+    }
+}
+
+/**
+ * Uwzględnia w licznikach biblioteki przydział lub zwolnienie obiektów.
+ * @param c liczniki biblioteki
+ * @param delta zmiana liczby niezwolnionych obiektów
+ * @param allocs liczba przydziałów
+ */
+static void SharedAllocCounterAdd(SharedAllocCounter *c, long long delta, size_t allocs) {
+    long long live = atomic_fetch_add_explicit(&(c->live), delta, memory_order_relaxed)
+                     + delta;
+    atomic_fetch_add_explicit(&(c->allocs), allocs, memory_order_relaxed);
+    long long peak = atomic_load_explicit(&(c->peak), memory_order_relaxed);
+    while (live > peak
+           && !atomic_compare_exchange_weak_explicit(&(c->peak), &peak, live,
+                                                     memory_order_relaxed,
+                                                     memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Przekazuje do liczników biblioteki zmiany liczby elementów wątku.
+ * Elementy liczone są w wątku bez synchronizacji, a liczniki biblioteki
+ * zmieniane są dopiero co ELEM_STATS_BATCH elementów.
+ * @param cache wolne elementy i liczniki wątku
+ */
+static void ElemStatsPublish(ElemCache *cache) {
+    SharedAllocCounterAdd(&alloc_counters[POLY_ALLOC_ELEMS], cache->pending_live,
+                          cache->pending_allocs);
+    cache->pending_live = 0;
+    cache->pending_allocs = 0;
+}
+
+/**
+ * Dodaje porcję wolnych elementów do wspólnej puli.
+ * Wywoływana z założoną blokadą elem_pool_lock.
+ * @param free lista wolnych elementów
+ * @param count długość listy
+ * @return Czy udało się dodać porcję (bez pamięci na nią elementy zostają
+ * u wywołującego)?
+ */
+static bool ElemPoolPut(MonoList free, size_t count) {
+    if (elem_batch_count == elem_batch_capacity) {
+        size_t capacity = 2 * elem_batch_capacity + 16;
+        ElemBatch *batches = (ElemBatch *) realloc(elem_batches, capacity * sizeof(ElemBatch));
+        if (batches == NULL) {
+            return false;
+        }
+        elem_batches = batches;
+        elem_batch_capacity = capacity;
+    }
+    elem_batches[elem_batch_count++] = (ElemBatch) {.free = free, .count = count};
+    return true;
+}
+
+/**
+ * Oddaje wszystkie wolne elementy wątku do wspólnej puli.
+ * Destruktor klucza elem_cache_key, wywoływany przy wyjściu z wątku.
+ * @param arg wolne elementy wątku
+ */
+static void ElemCacheRelease(void *arg) {
+    ElemCache *cache = (ElemCache *) arg;
+    ElemStatsPublish(cache);
+    if (cache->count > 0) {
+        // Bez pamięci na porcję elementy pozostają nieużywane w swoich blokach.
+        pthread_mutex_lock(&elem_pool_lock);
+        ElemPoolPut(cache->free, cache->count);
+        pthread_mutex_unlock(&elem_pool_lock);
+    }
+    cache->free = NULL;
+    cache->count = 0;
+    cache->registered = false;
+}
+
+/**
+ * Tworzy klucz elem_cache_key.
+ */
+static void ElemCacheKeyCreate() {
+    pthread_key_create(&elem_cache_key, ElemCacheRelease);
+}
+
+/**
+ * Zgłasza oddanie wolnych elementów i liczników wątku przy jego wyjściu.
+ * @param cache wolne elementy i liczniki wątku
+ */
+static void ElemCacheRegister(ElemCache *cache) {
+    pthread_once(&elem_cache_key_once, ElemCacheKeyCreate);
+    pthread_setspecific(elem_cache_key, cache);
+    cache->registered = true;
+}
+
+/**
+ * Uzupełnia wolne elementy wątku porcją ze wspólnej puli, a gdy ta jest
+ * pusta - nowym blokiem ELEM_SLAB_SIZE elementów. Bez pamięci na blok
+ * ustawia błąd POLY_ERR_NO_MEMORY i pozostawia wątek bez wolnych elementów.
+ * @param cache wolne elementy wątku
+ */
+static void ElemCacheRefill(ElemCache *cache) {
+    if (!cache->registered) {
+        ElemCacheRegister(cache);
+    }
+
+    pthread_mutex_lock(&elem_pool_lock);
+    if (elem_batch_count > 0) {
+        ElemBatch batch = elem_batches[--elem_batch_count];
+        pthread_mutex_unlock(&elem_pool_lock);
+        cache->free = batch.free;
+        cache->count = batch.count;
+        return;
+    }
+    if (elem_slab_count == elem_slab_capacity) {
+        size_t capacity = 2 * elem_slab_capacity + 16;
+        ElemBlock **slabs = (ElemBlock **) realloc(elem_slabs, capacity * sizeof(ElemBlock *));
+        if (slabs == NULL) {
+            pthread_mutex_unlock(&elem_pool_lock);
+            PolySetError(POLY_ERR_NO_MEMORY);
+            return;
+        }
+        elem_slabs = slabs;
+        elem_slab_capacity = capacity;
     }
+    ElemBlock *slab = (ElemBlock *) malloc(ELEM_SLAB_SIZE * sizeof(ElemBlock));
+    if (slab == NULL) {
+        pthread_mutex_unlock(&elem_pool_lock);
+        PolySetError(POLY_ERR_NO_MEMORY);
+        return;
+    }
+    elem_slabs[elem_slab_count++] = slab;
+    pthread_mutex_unlock(&elem_pool_lock);
+    AllocCounterAdd(&(cache->counters[POLY_ALLOC_SLABS]), 1, 1);
+    SharedAllocCounterAdd(&alloc_counters[POLY_ALLOC_SLABS], 1, 1);
+
+    for (size_t i = 0; i < ELEM_SLAB_SIZE; i++) {
+        slab[i].elem.head = &(slab[i].mono);
+        slab[i].elem.tail = (i + 1 < ELEM_SLAB_SIZE) ? &(slab[i + 1].elem) : NULL;
+    }
+    cache->free = &(slab[0].elem);
+    cache->count = ELEM_SLAB_SIZE;
+}
+
+/**
+ * Przydziela element listy wraz z miejscem na głowę.
+ * Elementy pochodzą z wolnych elementów wątku, więc zwykle nie wymaga to
+ * ani wywołania malloc, ani blokady.
+ * @return element z polem `head` wskazującym na miejsce na jednomian
+ * lub NULL, jeśli zabrakło pamięci
+ */
+static MonoList MonoElemAlloc() {
+    ElemCache *cache = &elem_cache;
+    if (cache->free == NULL) {
+        ElemCacheRefill(cache);
+        if (cache->free == NULL) {
+            return NULL;
+        }
+    }
+    MonoList l = cache->free;
+    cache->free = l->tail;
+    cache->count--;
+    AllocCounterAdd(&(cache->counters[POLY_ALLOC_ELEMS]), 1, 1);
+    cache->pending_allocs++;
+    if (++cache->pending_live >= ELEM_STATS_BATCH) {
+        ElemStatsPublish(cache);
+    }
+    return l;
+}
 
-    Mono *m = (Mono *) malloc(sizeof(struct Mono));
-    m->poly = *p;
-    m->exp = e;
-    return *m;
-//    return (Mono) {.poly = *p, .exp = e};
+/**
+ * Zwalnia element listy przydzielony przez MonoElemAlloc. Nadmiar wolnych
+ * elementów wątku trafia porcjami do wspólnej puli, skąd mogą je wziąć
+ * inne wątki.
+ * @param l element listy
+ */
+static void MonoElemFree(MonoList l) {
+    ElemCache *cache = &elem_cache;
+    if (!cache->registered) {
+        ElemCacheRegister(cache);
+    }
+    l->tail = cache->free;
+    cache->free = l;
+    cache->count++;
+    AllocCounterAdd(&(cache->counters[POLY_ALLOC_ELEMS]), -1, 0);
+    if (--cache->pending_live <= -ELEM_STATS_BATCH) {
+        ElemStatsPublish(cache);
+    }
+    if (cache->count > ELEM_CACHE_LIMIT) {
+        MonoList batch = cache->free;
+        MonoList last = batch;
+        for (size_t i = 1; i < ELEM_BATCH_SIZE; i++) {
+            last = last->tail;
+        }
+        MonoList rest = last->tail;
+        last->tail = NULL;
+        pthread_mutex_lock(&elem_pool_lock);
+        bool put = ElemPoolPut(batch, ELEM_BATCH_SIZE);
+        pthread_mutex_unlock(&elem_pool_lock);
+        if (put) {
+            cache->free = rest;
+            cache->count -= ELEM_BATCH_SIZE;
+        }
+        else {
+            // Bez pamięci na porcję elementy zostają w wątku.
+            last->tail = rest;
+        }
+    }
 }
 
 /**
@@ -89,33 +616,59 @@ static bool MonoListIsEmpty(const MonoList l) {
 /**
  * Dodaje jednomian na początek listy.
  * Dba o to, żeby nie dodać na listę jednomianu zerowego.
- * Przejmuje na własność listę oraz jednomian.
+ * Przejmuje na własność listę oraz zawartość jednomianu,
+ * który jest kopiowany do nowo zaalokowanego elementu listy.
+ * Bez pamięci na element jednomian jest usuwany, a lista zwracana bez
+ * zmian (błąd POLY_ERR_NO_MEMORY przerywa wtedy operację). Lista dłuższa
+ * niż pozwala budżet (PolyBudgetSet) ustawia błąd POLY_ERR_BUDGET.
  * @param l lista
  * @param m jednomian o stopniu niższym lub równym niż najniższy na liście
  * @return lista zawierająca na początku jednomian m
  */
 static MonoList MonoListPush(MonoList l, Mono *m) {
-    if (MonoListIsEmpty(l)) {
-        MonoList new = (MonoList) malloc(sizeof(struct MonoElem));
-        new->head = m;
-        new->tail = l;
-        return new;
+    if (MonoIsZero(m)) {
+        return l;
     }
-    if (MonoIsLesserExp(m, l->head)) {
-        if (MonoIsZero(m)) {
+    if (MonoListIsEmpty(l) || MonoIsLesserExp(m, l->head)) {
+        MonoList new = MonoElemAlloc();
+        if (new == NULL) {
+            MonoDestroy(m);
             return l;
         }
-        else {
-            MonoList new = (MonoList) malloc(sizeof(struct MonoElem));
-            new->head = m;
-            new->tail = l;
-            return new;
+        *(new->head) = *m;
+        new->tail = l;
+        new->refs = 1;
+        MonoElemUpdate(new);
+        if (poly_budget.active && poly_budget.limits.max_terms != 0
+            && new->terms > poly_budget.limits.max_terms) {
+            PolySetError(POLY_ERR_BUDGET);
         }
+        return new;
     }
     else {
-        fprintf(stderr, "Trying to create incorrect MonoList (not sorted)");
-        exit(1);
+        // Lista byłaby nieposortowana - odrzucamy jednomian.
+        PolySetError(POLY_ERR_UNSORTED);
+        MonoDestroy(m);
+        return l;
+    }
+}
+
+MonoList MonoListPrepend(Mono *m, MonoList tail) {
+    return MonoListPush(tail, m);
+}
+
+/**
+ * Zwiększa licznik odwołań do listy.
+ * Liczniki zmieniane są atomowo, bo te same elementy mogą być
+ * współdzielone przez wielomiany używane w różnych wątkach.
+ * @param l lista
+ * @return lista @p l
+ */
+static MonoList MonoListRef(MonoList l) {
+    if (!MonoListIsEmpty(l)) {
+        __atomic_add_fetch(&(l->refs), 1, __ATOMIC_RELAXED);
     }
+    return l;
 }
 
 /**
@@ -126,11 +679,7 @@ static MonoList MonoListPush(MonoList l, Mono *m) {
  * @return wielomian
  */
 static Poly PolyFromMonoList(MonoList l, poly_coeff_t c) {
-    Poly *poly = (Poly *) malloc(sizeof(struct Poly));
-    poly->coeff = c;
-    poly->list = l;
-    return *poly;
-//    return (Poly) {.list = l, .coeff= c};
+    return (Poly) {.list = l, .coeff = c};
 }
 
 /**
@@ -187,35 +736,21 @@ bool MonoIsZero(const Mono *m) {
 void MonoDestroy(Mono *m) {
     if (m != NULL) {
         PolyDestroy(&(m->poly));
-        free(m);
     }
 }
 
 /**
- * Niszczy pierwszy element listy. Zwraca listę bez niego.
+ * Usuwa odwołanie do listy. Elementy, do których nie ma już odwołań,
+ * są usuwane z pamięci.
  * @param l lista
- * @return lista bez pierwszego elementu.
  */
-static MonoList MonoListPop(MonoList l) {
-    if (MonoListIsEmpty(l)) {
-        fprintf(stderr, "Trying to pop empty list. Nothing will be done.");
-        return NULL;
-    }
-    else {
+static void MonoListDestroy(MonoList l) {
+    while (!MonoListIsEmpty(l)
+           && __atomic_sub_fetch(&(l->refs), 1, __ATOMIC_ACQ_REL) == 0) {
         MonoList tail = l->tail;
         MonoDestroy(l->head);
-        free(l);
-        return tail;
-    }
-}
-
-/**
- * Usuwa listę z pamięci.
- * @param l lista
- */
-static void MonoListDestroy(MonoList l) {
-    while (!MonoListIsEmpty(l)) {
-        l = MonoListPop(l);
+        MonoElemFree(l);
+        l = tail;
     }
 }
 
@@ -226,14 +761,14 @@ static void MonoListDestroy(MonoList l) {
 void PolyDestroy(Poly *p) {
     if (p != NULL) {
         MonoListDestroy(p->list);
-        free(p);
+        p->list = MonoListEmpty();
     }
 }
 
 
 
 /**
- * Robi pełną, głęboką kopię jednomianu.
+ * Kopiuje jednomian w czasie stałym (zob. PolyClone).
  * @param[in] m : jednomian
  * @return skopiowany jednomian
  */
@@ -243,22 +778,17 @@ Mono MonoClone(const Mono *m) {
 }
 
 /**
- * Robi pełną, głęboką kopię listy jednomianów
+ * Kopiuje listę jednomianów - kopia współdzieli elementy z oryginałem.
  * @param l lista jednomianów
  * @return skopiowana lista jednomianów
  */
 static inline MonoList MonoListClone(const MonoList l) {
-    if (MonoListIsEmpty(l)) {
-        return MonoListEmpty();
-    }
-    else {
-        Mono mono_clone = MonoClone(l->head);
-        return MonoListPush(MonoListClone(l->tail), &mono_clone);
-    }
+    return MonoListRef(l);
 }
 
 /**
- * Robi pełną, głęboką kopię wielomianu.
+ * Kopiuje wielomian w czasie stałym. Kopia współdzieli elementy listy
+ * z oryginałem, zwiększany jest jedynie licznik odwołań.
  * @param[in] p : wielomian
  * @return skopiowany wielomian
  */
@@ -282,13 +812,34 @@ inline Poly PolyClone(const Poly *p) {
 static Mono MonoAdd(const Mono *m1, const Mono *m2) {
     poly_exp_t new_exp = m1->exp;
     if (m2->exp != new_exp) {
-        fprintf(stderr, "Trying to make monomial by adding monomials with different exponents");
-        exit(1);
+        // Wynikiem zastępczym jest jednomian zerowy, pomijany na listach.
+        PolySetError(POLY_ERR_EXP_MISMATCH);
+        return (Mono) {.poly = PolyZero(), .exp = new_exp};
     }
     Poly new_poly = PolyAdd(&(m1->poly), &(m2->poly));
     return MonoFromPoly(&new_poly, new_exp);
 }
 
+/**
+ * Zadanie planisty na parze jednomianów.
+ */
+typedef struct MonoPairTask {
+    PolyTask task; ///< zadanie planisty
+    const Mono *m1; ///< pierwszy jednomian
+    const Mono *m2; ///< drugi jednomian
+    Mono res; ///< wynik dodawania
+    bool eq; ///< wynik porównania
+} MonoPairTask;
+
+/**
+ * Dodaje jednomiany zadania.
+ * @param task : zadanie (MonoPairTask)
+ */
+static void MonoAddTaskRun(PolyTask *task) {
+    MonoPairTask *t = (MonoPairTask *) task;
+    t->res = MonoAdd(t->m1, t->m2);
+}
+
 /**
  * Dodaje dwie listy jednomianów.
  * Zachowuje posortowanie.
@@ -304,6 +855,10 @@ static MonoList MonoListAdd(const MonoList l1, const MonoList l2) {
     else if (MonoListIsEmpty(l2)) {
         return MonoListClone(l1);
     }
+    else if (PolyShouldStop()) {
+        // Operacja jest przerywana - niepełny wynik i tak zostanie usunięty.
+        return MonoListEmpty();
+    }
     else {
         Mono *h1 = l1->head;
         Mono *h2 = l2->head;
@@ -318,6 +873,14 @@ static MonoList MonoListAdd(const MonoList l1, const MonoList l2) {
             new_head = MonoClone(h2);
             new_tail = MonoListAdd(l1, l2->tail);
         }
+        else if (PolyTaskShouldFork(PolyNodeCount(&(h1->poly)) + PolyNodeCount(&(h2->poly)))) {
+            // Współczynniki dodaje inny wątek, a my w tym czasie ogon.
+            MonoPairTask task = {.task.run = MonoAddTaskRun, .m1 = h1, .m2 = h2};
+            PolyTaskFork(&(task.task));
+            new_tail = MonoListAdd(l1->tail, l2->tail);
+            TaskJoin(&(task.task));
+            new_head = task.res;
+        }
         else { // h1 = h2 co do exp
             new_head = MonoAdd(h1, h2);
             new_tail = MonoListAdd(l1->tail, l2->tail);
@@ -346,95 +909,317 @@ Poly PolyAdd(const Poly *p, const Poly *q) {
     }
     else {
         MonoList new_l = MonoListAdd(p->list, q->list);
-        return PolyFromMonoList(new_l, new_coeff);
+        Poly sum = PolyFromMonoList(new_l, new_coeff);
+        return PolyStopResult(&sum);
     }
 }
 
 
 
 /**
- * Dodaje do listy jednomian.
- * Jednomian bmusi mieć mniejszy lub równy wykładnik od pierwszego jednomianu na liście. n <= n_1
- * Dba o to, aby na liście nie pojawił się jednomian zerowy oraz by nie powtórzyły się wykładniki.
- * Bierze na własność jednomian oraz listę.
- * @param l jednomian Ax^n
- * @param m lista jednomianów A_1x^{n_1} + ... + A_kx^{n_k}
- * @return Poprawna lista jednomianów Ax^n + A_1x^{n_1} + ... + A_kx^{n_k}
+ * Długość listy jednomianów
+ * @param l lista
+ * @return długość listy
  */
-static MonoList MonoListAddMono(MonoList l, Mono *m) {
-    if (MonoListIsEmpty(l)) {
-        return MonoListPush(l, m);
-    }
-    else if (MonoIsLesserExp(l->head, m)) {
-        fprintf(stderr, "Trying to add mono with higher exp to front of a monomial list.");
-        exit(1);
+static unsigned MonoListLength(const MonoList l) {
+    return MonoListIsEmpty(l) ? 0 : l->length;
+}
+
+/**
+ * Zwraca klucz sortowania jednomianu: wykładnik z odwróconym bitem znaku,
+ * dzięki czemu kolejność kluczy bez znaku jest kolejnością wykładników.
+ * @param m jednomian
+ * @return klucz
+ */
+static inline uint32_t MonoSortKey(const Mono *m) {
+    return (uint32_t) m->exp ^ 0x80000000u;
+}
+
+/**
+ * Sortuje stabilnie jednomiany według wykładników pozycyjnie (radix sort)
+ * po 8 bitów, pomijając bajty, które są takie same we wszystkich kluczach.
+ * Krótkie tablice sortowane są przez wstawianie.
+ * @param monos jednomiany
+ * @param tmp miejsce pomocnicze na @p count jednomianów
+ * @param count liczba jednomianów
+ */
+static void MonoRadixSort(Mono *monos, Mono *tmp, size_t count) {
+    if (count < SORT_INSERTION_CUTOFF) {
+        for (size_t i = 1; i < count; i++) {
+            Mono m = monos[i];
+            size_t j = i;
+            while (j > 0 && m.exp < monos[j - 1].exp) {
+                monos[j] = monos[j - 1];
+                j--;
+            }
+            monos[j] = m;
+        }
+        return;
     }
-    else if (MonoIsLesserExp(m, l->head)) {
-        return MonoListPush(l, m);
+
+    uint32_t diff = 0;
+    for (size_t i = 1; i < count; i++) {
+        diff |= MonoSortKey(&monos[i]) ^ MonoSortKey(&monos[0]);
     }
-    else {
-        Mono *head = l->head;
-        Mono sum = MonoAdd(m, head);
-        MonoDestroy(m);
-        MonoList tail = MonoListPop(l);
-        if (MonoIsZero(&sum)) {
-            MonoDestroy(&sum);
-            return tail;
+
+    Mono *src = monos, *dst = tmp;
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        if (((diff >> shift) & 0xff) == 0) {
+            continue;
         }
-        else {
-            return MonoListPush(tail, &sum);
+        size_t offsets[256] = {0};
+        for (size_t i = 0; i < count; i++) {
+            offsets[(MonoSortKey(&src[i]) >> shift) & 0xff]++;
+        }
+        size_t sum = 0;
+        for (unsigned b = 0; b < 256; b++) {
+            size_t c = offsets[b];
+            offsets[b] = sum;
+            sum += c;
         }
+        for (size_t i = 0; i < count; i++) {
+            dst[offsets[(MonoSortKey(&src[i]) >> shift) & 0xff]++] = src[i];
+        }
+        Mono *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != monos) {
+        memcpy(monos, src, count * sizeof(struct Mono));
     }
 }
 
 /**
- * Sumuje listę jednomianów i tworzy z nich wielomian.
- * Przejmuje na własność zawartość tablicy @p monos.
- * @param[in] count : liczba jednomianów
- * @param[in] monos : tablica jednomianów
- * @return wielomian będący sumą jednomianów
+ * Zadanie planisty sortujące część tablicy jednomianów.
  */
-Poly PolyAddMonos(unsigned count, const Mono monos[]) {
-    Mono monos_copy[count];
-    for (int i = 0; i < count; i++) {
-        monos_copy[i] = monos[i];
-    }
+typedef struct MonoSortTask {
+    PolyTask task; ///< zadanie planisty
+    Mono *monos; ///< jednomiany
+    Mono *tmp; ///< miejsce pomocnicze
+    size_t count; ///< liczba jednomianów
+} MonoSortTask;
 
-    qsort(monos_copy, count, sizeof(struct Mono), MonoCompareByExp);
+static void MonoSort(Mono *monos, Mono *tmp, size_t count);
 
-    MonoList list = MonoListEmpty();
-    poly_coeff_t coeff = 0;
-    for (int i = count-1; i >= 0; i--) {
-        Mono m = monos_copy[i];
-        if (m.exp == 0) {
-            //Wyciągamy stałą ze współczynnika m na zewnątrz
-            coeff += (m.poly).coeff;
-            (m.poly).coeff = 0;
-        }
+/**
+ * Sortuje jednomiany zadania.
+ * @param task zadanie (MonoSortTask)
+ */
+static void MonoSortTaskRun(PolyTask *task) {
+    MonoSortTask *t = (MonoSortTask *) task;
+    MonoSort(t->monos, t->tmp, t->count);
+}
 
-        list = MonoListAddMono(list, &m);
+/**
+ * Sortuje stabilnie jednomiany według wykładników. W ramach planisty
+ * (poly_sched.h) duże tablice są dzielone na połowy sortowane
+ * równolegle i scalane, a małe sortowane pozycyjnie.
+ * @param monos jednomiany
+ * @param tmp miejsce pomocnicze na @p count jednomianów
+ * @param count liczba jednomianów
+ */
+static void MonoSort(Mono *monos, Mono *tmp, size_t count) {
+    if (count < SORT_TASK_CUTOFF || !PolyTaskShouldFork(count)) {
+        MonoRadixSort(monos, tmp, count);
+        return;
     }
 
-    return PolyFromMonoList(list, coeff);
+    size_t half = count / 2;
+    MonoSortTask task = {.task.run = MonoSortTaskRun, .monos = monos, .tmp = tmp,
+                         .count = half};
+    PolyTaskFork(&(task.task));
+    MonoSort(monos + half, tmp + half, count - half);
+    TaskJoin(&(task.task));
+
+    size_t a = 0, b = half, k = 0;
+    while (a < half && b < count) {
+        tmp[k++] = (monos[b].exp < monos[a].exp) ? monos[b++] : monos[a++];
+    }
+    while (a < half) {
+        tmp[k++] = monos[a++];
+    }
+    while (b < count) {
+        tmp[k++] = monos[b++];
+    }
+    memcpy(monos, tmp, count * sizeof(struct Mono));
 }
 
+/**
+ * Sumuje jednomiany o tym samym wykładniku. Jednomiany list ich
+ * współczynników są kopiowane w czasie stałym i sumowane jednym
+ * wywołaniem PolyAddMonos, zamiast dodawać współczynniki po kolei. Parę
+ * jednomianów wystarczy dodać przez MonoAdd.
+ * Przejmuje na własność zawartość jednomianów.
+ * @param run jednomiany o tym samym wykładniku
+ * @param count liczba jednomianów, co najmniej 1
+ * @return suma jednomianów
+ */
+static Mono MonoSumRun(const Mono *run, size_t count) {
+    if (count == 1) {
+        return run[0];
+    }
+    if (count == 2) {
+        Mono sum = MonoAdd(&run[0], &run[1]);
+        Poly p = run[0].poly, q = run[1].poly;
+        PolyDestroy(&p);
+        PolyDestroy(&q);
+        return sum;
+    }
 
+    poly_coeff_t coeff = 0;
+    size_t length = 0;
+    for (size_t i = 0; i < count; i++) {
+        coeff += run[i].poly.coeff;
+        length += MonoListLength(run[i].poly.list);
+    }
+    Mono *inner = (Mono *) PolyAlloc((length + 1) * sizeof(struct Mono));
+    if (inner == NULL) {
+        for (size_t i = 0; i < count; i++) {
+            Poly p = run[i].poly;
+            PolyDestroy(&p);
+        }
+        return (Mono) {.poly = PolyZero(), .exp = run[0].exp};
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (MonoList l = run[i].poly.list; !MonoListIsEmpty(l); l = l->tail) {
+            inner[n++] = MonoClone(l->head);
+        }
+        Poly p = run[i].poly;
+        PolyDestroy(&p);
+    }
+    Poly sum = PolyAddMonos((unsigned) n, inner);
+    free(inner);
+    sum.coeff += coeff;
+    return MonoFromPoly(&sum, run[0].exp);
+}
 
 /**
- * Długość listy jednomianów
- * @param l lista
- * @return długość listy
+ * Zadanie planisty sumujące jednomiany o tym samym wykładniku.
  */
-static unsigned MonoListLength(const MonoList l) {
-    if (MonoListIsEmpty(l)) {
-        return 0;
+typedef struct MonoRunTask {
+    PolyTask task; ///< zadanie planisty
+    const Mono *run; ///< jednomiany
+    size_t count; ///< liczba jednomianów
+    size_t index; ///< numer ciągu
+    Mono res; ///< suma
+} MonoRunTask;
+
+/**
+ * Sumuje jednomiany zadania.
+ * @param task zadanie (MonoRunTask)
+ */
+static void MonoRunTaskRun(PolyTask *task) {
+    MonoRunTask *t = (MonoRunTask *) task;
+    t->res = MonoSumRun(t->run, t->count);
+}
+
+/**
+ * Sortuje jednomiany według wykładników i sumuje ciągi jednomianów
+ * o równych wykładnikach - w ramach planisty (poly_sched.h) równolegle.
+ * Przejmuje na własność jednomiany tablicy.
+ * @param sorted tablica @p count jednomianów z miejscem pomocniczym na
+ * drugie tyle; sumy trafiają do miejsca pomocniczego
+ * @param count liczba jednomianów
+ * @return liczba sum, które mają rosnące wykładniki
+ */
+static size_t MonoSortSum(Mono *sorted, size_t count) {
+    MonoSort(sorted, sorted + count, count);
+
+    // Ciągi równych wykładników; zadania zapisują sumy w miejscu
+    // pomocniczym za posortowanymi jednomianami.
+    Mono *sums = sorted + count;
+    MonoRunTask *tasks = NULL;
+    size_t runs = 0, forked = 0;
+    for (size_t i = 0; i < count;) {
+        if (PolyShouldStop()) {
+            // Operacja jest przerywana - pomijamy pozostałe jednomiany.
+            for (; i < count; i++) {
+                MonoDestroy(&sorted[i]);
+            }
+            break;
+        }
+        size_t j = i + 1;
+        size_t cost = PolyNodeCount(&(sorted[i].poly));
+        while (j < count && sorted[j].exp == sorted[i].exp) {
+            cost += PolyNodeCount(&(sorted[j].poly));
+            j++;
+        }
+        if (tasks == NULL && j - i > 1 && PolyTaskShouldFork(cost)) {
+            // Bez pamięci na zadania ciągi sumowane są po kolei.
+            tasks = (MonoRunTask *) malloc(count * sizeof(MonoRunTask));
+        }
+        if (tasks != NULL && j - i > 1 && PolyTaskShouldFork(cost)) {
+            MonoRunTask *t = &tasks[forked++];
+            *t = (MonoRunTask) {.task.run = MonoRunTaskRun, .run = &sorted[i],
+                                .count = j - i, .index = runs};
+            PolyTaskFork(&(t->task));
+        }
+        else {
+            sums[runs] = MonoSumRun(&sorted[i], j - i);
+        }
+        runs++;
+        i = j;
     }
-    else {
-        return (MonoListLength(l->tail) + 1);
+    while (forked > 0) {
+        MonoRunTask *t = &tasks[--forked];
+        TaskJoin(&(t->task));
+        sums[t->index] = t->res;
+    }
+    free(tasks);
+    return runs;
+}
+
+/**
+ * Sumuje listę jednomianów i tworzy z nich wielomian.
+ * Jednomiany są kopiowane (większe tablice na stertę), sortowane według
+ * wykładników i sumowane (MonoSortSum). Wyniki mają rosnące wykładniki,
+ * więc lista powstaje przez dokładanie ich na początek od końca.
+ * Przejmuje na własność zawartość tablicy @p monos.
+ * @param[in] count : liczba jednomianów
+ * @param[in] monos : tablica jednomianów
+ * @return wielomian będący sumą jednomianów
+ */
+Poly PolyAddMonos(unsigned count, const Mono monos[]) {
+    if (count == 0) {
+        return PolyZero();
+    }
+
+    Mono local[2 * ADD_MONOS_STACK];
+    Mono *sorted = (count <= ADD_MONOS_STACK) ? local
+                   : (Mono *) PolyAlloc(2 * (size_t) count * sizeof(struct Mono));
+    if (sorted == NULL) {
+        for (unsigned i = 0; i < count; i++) {
+            Mono m = monos[i];
+            MonoDestroy(&m);
+        }
+        return PolyZero();
+    }
+    memcpy(sorted, monos, count * sizeof(struct Mono));
+    size_t runs = MonoSortSum(sorted, count);
+    Mono *sums = sorted + count;
+
+    MonoList list = MonoListEmpty();
+    poly_coeff_t coeff = 0;
+    for (size_t r = runs; r-- > 0;) {
+        Mono m = sums[r];
+        if (m.exp == 0) {
+            //Wyciągamy stałą ze współczynnika m na zewnątrz
+            coeff += (m.poly).coeff;
+            (m.poly).coeff = 0;
+        }
+        list = MonoListPush(list, &m);
     }
+    if (sorted != local) {
+        free(sorted);
+    }
+
+    Poly res = PolyFromMonoList(list, coeff);
+    return PolyStopResult(&res);
 }
 
 
+
 /**
  * Mnoży jednomian przez stałą liczbową różna od 0
  * @param m : jednomian
@@ -451,13 +1236,14 @@ static Mono MonoCoeffMul(const Mono *m, poly_coeff_t c) {
 }
 
 /**
- * Mnoży dwa jednomiany.
+ * Mnoży dwa jednomiany. W trakcie PolyMemoMul iloczyn współczynników
+ * pochodzi z pamięci podręcznej.
  * @param[in] m1 : jednomian
  * @param[in] m2 : jednomian
  * @return `m1 * m2`
  */
 static Mono MonoMul(const Mono *m1, const Mono *m2) {
-    Poly mul_poly = PolyMul(&(m1->poly), &(m2->poly));
+    Poly mul_poly = PolyMemoMulNested(&(m1->poly), &(m2->poly));
     return MonoFromPoly(&mul_poly, m1->exp + m2->exp);
 }
 
@@ -477,6 +1263,28 @@ static MonoList MonoListCoeffMul(const MonoList l, poly_coeff_t c) {
     }
 }
 
+/**
+ * Zadanie planisty mnożące jednomian przez listę jednomianów.
+ */
+typedef struct MulRowTask {
+    PolyTask task; ///< zadanie planisty
+    const Mono *m; ///< jednomian
+    MonoList l; ///< lista jednomianów
+    Mono *out; ///< miejsce na iloczyny, po jednym na element listy
+} MulRowTask;
+
+/**
+ * Mnoży jednomian zadania przez kolejne jednomiany listy.
+ * @param task : zadanie (MulRowTask)
+ */
+static void MulRowTaskRun(PolyTask *task) {
+    MulRowTask *t = (MulRowTask *) task;
+    unsigned k = 0;
+    for (MonoList b = t->l; !MonoListIsEmpty(b); b = b->tail) {
+        t->out[k++] = MonoMul(t->m, b->head);
+    }
+}
+
 /**
  * Mnoży dwie listy jednomianów
  * @param l1 : lista jednomianów
@@ -484,12 +1292,54 @@ static MonoList MonoListCoeffMul(const MonoList l, poly_coeff_t c) {
  * @return 'l1 * l2'
  */
 static Poly MonoListMul(const MonoList l1, const MonoList l2) {
-    unsigned max_count = MonoListLength(l1) * MonoListLength(l2) + 1;
+    size_t max_count = (size_t) MonoListLength(l1) * MonoListLength(l2) + 1;
+    if (max_count > UINT_MAX) {
+        // Tylu iloczynów nie da się zsumować przez PolyAddMonos.
+        PolySetError(POLY_ERR_NO_MEMORY);
+        return PolyZero();
+    }
     unsigned count = 0;
-    Mono muls[max_count];
+    Mono *muls = (Mono *) PolyAlloc(max_count * sizeof(struct Mono));
+    if (muls == NULL) {
+        return PolyZero();
+    }
+    Poly res;
+
+    MulRowTask *tasks = NULL;
+    if (!MonoListIsEmpty(l1) && !MonoListIsEmpty(l2)
+        && PolyTaskShouldFork(l1->nodes * l2->nodes)) {
+        // Bez pamięci na zadania wiersze liczone są po kolei.
+        tasks = (MulRowTask *) malloc(MonoListLength(l1) * sizeof(MulRowTask));
+    }
+    if (tasks != NULL) {
+        // Wiersze iloczynów liczone są jako osobne zadania.
+        unsigned rows = MonoListLength(l1);
+        unsigned width = MonoListLength(l2);
+        unsigned r = 0;
+        for (MonoList a = l1; !MonoListIsEmpty(a); a = a->tail, r++) {
+            tasks[r] = (MulRowTask) {.task.run = MulRowTaskRun, .m = a->head,
+                                     .l = l2, .out = &muls[r * width]};
+            PolyTaskFork(&(tasks[r].task));
+        }
+        while (r > 0) {
+            TaskJoin(&(tasks[--r].task));
+        }
+        free(tasks);
+        res = PolyAddMonos(rows * width, muls);
+        free(muls);
+        return res;
+    }
 
     MonoList a = l1;
     while (!MonoListIsEmpty(a)) {
+        if (PolyShouldStop()) {
+            // Operacja jest przerywana - usuwamy policzone iloczyny.
+            for (unsigned i = 0; i < count; i++) {
+                MonoDestroy(&muls[i]);
+            }
+            free(muls);
+            return PolyZero();
+        }
         MonoList b = l2;
         while (!MonoListIsEmpty(b)) {
             Mono curr_mul = MonoMul(a->head, b->head);
@@ -501,7 +1351,9 @@ static Poly MonoListMul(const MonoList l1, const MonoList l2) {
         a = a->tail;
     }
 
-    return PolyAddMonos(count, muls);
+    res = PolyAddMonos(count, muls);
+    free(muls);
+    return res;
 }
 
 
@@ -521,14 +1373,289 @@ Poly PolyMul(const Poly *p, const Poly *q) {
         Poly qc_p = PolyFromMonoList(MonoListCoeffMul(p->list, q->coeff), 0);
         Poly coeff_muls = PolyAdd(&pc_q, &qc_p);
         Poly higher_exp_muls = MonoListMul(p->list, q->list);
+        Poly mul = PolyAdd(&coeff_muls, &higher_exp_muls);
 
-        return PolyAdd(&coeff_muls, &higher_exp_muls);
+        PolyDestroy(&pc_q);
+        PolyDestroy(&qc_p);
+        PolyDestroy(&coeff_muls);
+        PolyDestroy(&higher_exp_muls);
+        return PolyStopResult(&mul);
     }
 
 }
 
 
 
+/**
+ * Jednomiany czynnika mnożenia równoległego: wyraz wolny jako jednomian
+ * o wykładniku 0, a po nim jednomiany listy. Jednomiany nie są kopiami,
+ * tylko wskazują na współczynniki czynnika.
+ */
+typedef struct MulTerms {
+    Mono *monos; ///< jednomiany posortowane niemalejąco według wykładnika
+    double *prefix; ///< `prefix[i]` - suma kosztów jednomianów `0..i-1`
+    size_t count; ///< liczba jednomianów
+} MulTerms;
+
+/**
+ * Zadanie wątku mnożenia równoległego.
+ */
+typedef struct MulJob {
+    const MulTerms *a; ///< jednomiany pierwszego czynnika
+    const MulTerms *b; ///< jednomiany drugiego czynnika
+    long long lo; ///< najmniejszy wykładnik wyniku liczony przez wątek
+    long long hi; ///< wykładnik za największym liczonym przez wątek
+    Poly res; ///< część iloczynu o wykładnikach z przedziału `[lo, hi)`
+    PolyError error; ///< kod błędu wątku po policzeniu części
+} MulJob;
+
+/**
+ * Wypełnia jednomiany czynnika mnożenia równoległego. Kosztem jednomianu
+ * jest liczba elementów list jego współczynnika powiększona o jeden.
+ * @param p : wielomian
+ * @param t : jednomiany
+ * @return Czy starczyło pamięci? Jeśli nie, @p t jest puste.
+ */
+static bool MulTermsInit(const Poly *p, MulTerms *t) {
+    size_t n = MonoListLength(p->list) + 1;
+    t->monos = (Mono *) PolyAlloc(n * sizeof(struct Mono));
+    t->prefix = (t->monos == NULL) ? NULL : (double *) PolyAlloc((n + 1) * sizeof(double));
+    t->count = 0;
+    if (t->prefix == NULL) {
+        free(t->monos);
+        t->monos = NULL;
+        return false;
+    }
+    t->prefix[0] = 0;
+    if (p->coeff != 0) {
+        t->monos[t->count] = (Mono) {.poly = PolyFromCoeff(p->coeff), .exp = 0};
+        t->prefix[t->count + 1] = t->prefix[t->count] + 1;
+        t->count++;
+    }
+    for (MonoList l = p->list; !MonoListIsEmpty(l); l = l->tail) {
+        t->monos[t->count] = *(l->head);
+        t->prefix[t->count + 1] = t->prefix[t->count]
+                                  + (double) (PolyNodeCount(&(l->head->poly)) + 1);
+        t->count++;
+    }
+    return true;
+}
+
+/**
+ * Zwalnia jednomiany czynnika mnożenia równoległego.
+ * @param t : jednomiany
+ */
+static void MulTermsDestroy(MulTerms *t) {
+    free(t->monos);
+    free(t->prefix);
+}
+
+/**
+ * Zwraca liczbę jednomianów o wykładniku mniejszym niż @p e.
+ * @param t : jednomiany
+ * @param e : wykładnik
+ * @return indeks pierwszego jednomianu o wykładniku co najmniej @p e
+ */
+static size_t MulTermsLowerBound(const MulTerms *t, long long e) {
+    size_t lo = 0, hi = t->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (t->monos[mid].exp < e) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Szacuje koszt wyliczenia jednomianów iloczynu o wykładnikach mniejszych
+ * niż @p e. Koszt iloczynu dwóch jednomianów to iloczyn ich kosztów,
+ * więc dla każdego jednomianu @p a wystarczy suma prefiksowa kosztów @p b.
+ * @param a : jednomiany pierwszego czynnika
+ * @param b : jednomiany drugiego czynnika
+ * @param e : wykładnik
+ * @return szacowany koszt
+ */
+static double MulWorkBelow(const MulTerms *a, const MulTerms *b, long long e) {
+    double work = 0;
+    for (size_t i = 0; i < a->count; i++) {
+        double w = a->prefix[i + 1] - a->prefix[i];
+        work += w * b->prefix[MulTermsLowerBound(b, e - a->monos[i].exp)];
+    }
+    return work;
+}
+
+/**
+ * Liczy część iloczynu o wykładnikach z przedziału zadania.
+ * @param arg : zadanie (MulJob)
+ * @return NULL
+ */
+static void *MulWorker(void *arg) {
+    MulJob *job = (MulJob *) arg;
+    const MulTerms *a = job->a;
+    const MulTerms *b = job->b;
+    size_t count = 0;
+    for (size_t i = 0; i < a->count; i++) {
+        count += MulTermsLowerBound(b, job->hi - a->monos[i].exp)
+                 - MulTermsLowerBound(b, job->lo - a->monos[i].exp);
+    }
+
+    Mono *muls = (Mono *) PolyAlloc((count + 1) * sizeof(struct Mono));
+    if (muls == NULL) {
+        job->res = PolyZero();
+        job->error = PolyLastError();
+        return NULL;
+    }
+    count = 0;
+    for (size_t i = 0; i < a->count; i++) {
+        size_t end = MulTermsLowerBound(b, job->hi - a->monos[i].exp);
+        for (size_t j = MulTermsLowerBound(b, job->lo - a->monos[i].exp); j < end; j++) {
+            muls[count++] = MonoMul(&(a->monos[i]), &(b->monos[j]));
+        }
+    }
+    job->res = PolyAddMonos((unsigned) count, muls);
+    free(muls);
+    job->error = PolyLastError();
+    return NULL;
+}
+
+/**
+ * Skleja części iloczynu o rosnących, rozłącznych przedziałach wykładników.
+ * Lista ostatniej części staje się ogonem wyniku, a jednomiany
+ * pozostałych są kopiowane w czasie stałym i dokładane na początek.
+ * @param parts : części iloczynu, przejmowane na własność
+ * @param count : liczba części
+ * @return suma części (wielomian zerowy, jeśli zabrakło pamięci)
+ */
+static Poly MulJoinParts(Poly parts[], unsigned count) {
+    size_t length = 0;
+    for (unsigned t = 0; t + 1 < count; t++) {
+        length += MonoListLength(parts[t].list);
+    }
+    MonoList *elems = (MonoList *) PolyAlloc((length + 1) * sizeof(MonoList));
+    if (elems == NULL) {
+        for (unsigned t = 0; t < count; t++) {
+            PolyDestroy(&parts[t]);
+        }
+        return PolyZero();
+    }
+    size_t n = 0;
+    poly_coeff_t coeff = 0;
+    for (unsigned t = 0; t < count; t++) {
+        coeff += parts[t].coeff;
+        if (t + 1 < count) {
+            for (MonoList l = parts[t].list; !MonoListIsEmpty(l); l = l->tail) {
+                elems[n++] = l;
+            }
+        }
+    }
+
+    MonoList list = (count > 0) ? parts[count - 1].list : MonoListEmpty();
+    while (n > 0) {
+        Mono m = MonoClone(elems[--n]->head);
+        list = MonoListPrepend(&m, list);
+    }
+    free(elems);
+    for (unsigned t = 0; t + 1 < count; t++) {
+        PolyDestroy(&parts[t]);
+    }
+    return PolyFromMonoList(list, coeff);
+}
+
+Poly PolyMulParallel(const Poly *p, const Poly *q, unsigned threads) {
+    if (threads <= 1 || PolyIsCoeff(p) || PolyIsCoeff(q)) {
+        return PolyMul(p, q);
+    }
+
+    MulTerms a, b;
+    if (!MulTermsInit(p, &a)) {
+        return PolyZero();
+    }
+    if (!MulTermsInit(q, &b)) {
+        MulTermsDestroy(&a);
+        return PolyZero();
+    }
+    long long end = (long long) a.monos[a.count - 1].exp + b.monos[b.count - 1].exp + 1;
+    double total = a.prefix[a.count] * b.prefix[b.count];
+    if (total < MUL_PARALLEL_MIN_WORK) {
+        MulTermsDestroy(&a);
+        MulTermsDestroy(&b);
+        return PolyMul(p, q);
+    }
+    if (threads > end) {
+        threads = (unsigned) end;
+    }
+
+    // Granice przedziałów wybieramy wyszukiwaniem binarnym tak, żeby
+    // szacowany koszt każdego przedziału był bliski `total / threads`.
+    MulJob *jobs = (MulJob *) PolyAlloc(threads * sizeof(MulJob));
+    pthread_t *tids = (pthread_t *) PolyAlloc(threads * sizeof(pthread_t));
+    bool *started = (bool *) PolyAlloc(threads * sizeof(bool));
+    Poly *parts = (Poly *) PolyAlloc(threads * sizeof(Poly));
+    if (jobs == NULL || tids == NULL || started == NULL || parts == NULL) {
+        free(parts);
+        free(started);
+        free(tids);
+        free(jobs);
+        MulTermsDestroy(&a);
+        MulTermsDestroy(&b);
+        return PolyZero();
+    }
+    long long lo = 0;
+    for (unsigned t = 0; t < threads; t++) {
+        long long hi = end;
+        if (t + 1 < threads) {
+            double target = total * (t + 1) / threads;
+            long long left = lo, right = end;
+            while (left < right) {
+                long long mid = left + (right - left) / 2;
+                if (MulWorkBelow(&a, &b, mid) < target) {
+                    left = mid + 1;
+                }
+                else {
+                    right = mid;
+                }
+            }
+            hi = left;
+        }
+        jobs[t] = (MulJob) {.a = &a, .b = &b, .lo = lo, .hi = hi};
+        lo = hi;
+    }
+
+    for (unsigned t = 1; t < threads; t++) {
+        started[t] = (pthread_create(&tids[t], NULL, MulWorker, &jobs[t]) == 0);
+        if (!started[t]) {
+            MulWorker(&jobs[t]);
+        }
+    }
+    MulWorker(&jobs[0]);
+    for (unsigned t = 1; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(tids[t], NULL);
+        }
+    }
+
+    for (unsigned t = 0; t < threads; t++) {
+        parts[t] = jobs[t].res;
+        if (jobs[t].error != POLY_OK) {
+            PolySetError(jobs[t].error);
+        }
+    }
+    Poly res = MulJoinParts(parts, threads);
+    free(parts);
+    free(started);
+    free(tids);
+    free(jobs);
+    MulTermsDestroy(&a);
+    MulTermsDestroy(&b);
+    return PolyStopResult(&res);
+}
+
+
+
 /**
  * Zwraca przeciwny wielomian.
  * @param[in] p : wielomian
@@ -558,6 +1685,479 @@ Poly PolySub(const Poly *p, const Poly *q) {
 
 
 
+/**
+ * Element kopca list scalanych przez PolySumN.
+ */
+typedef struct MonoHeapItem {
+    poly_exp_t exp; ///< wykładnik głowy listy (klucz kopca)
+    MonoList l; ///< niepusta lista
+} MonoHeapItem;
+
+/**
+ * Przywraca własność kopca (najmniejszy wykładnik głowy na szczycie)
+ * od pozycji @p i w dół.
+ * @param heap kopiec
+ * @param size rozmiar kopca
+ * @param i pozycja
+ */
+static void MonoHeapDown(MonoHeapItem heap[], unsigned size, unsigned i) {
+    MonoHeapItem item = heap[i];
+    while (2 * i + 1 < size) {
+        unsigned c = 2 * i + 1;
+        if (c + 1 < size && heap[c + 1].exp < heap[c].exp) {
+            c++;
+        }
+        if (item.exp <= heap[c].exp) {
+            break;
+        }
+        heap[i] = heap[c];
+        i = c;
+    }
+    heap[i] = item;
+}
+
+/**
+ * Sumuje listy jednomianów przez scalanie k list naraz.
+ * Kolejny wykładnik wyniku jest zawsze na szczycie kopca list,
+ * współczynniki jednomianów o tym samym wykładniku sumowane są jednym
+ * wywołaniem PolySumN, a gdy zostaje jedna lista, jej reszta jest
+ * współdzielona z wynikiem. Każdy element list wejściowych odwiedzany
+ * jest więc raz, zamiast kopiowania sumy częściowej przy każdym dodaniu.
+ * @param heap niepuste listy (tablica jest zmieniana)
+ * @param count liczba list
+ * @return lista będąca sumą list
+ */
+static MonoList MonoListSumN(MonoHeapItem heap[], unsigned count) {
+    if (count == 0) {
+        return MonoListEmpty();
+    }
+    size_t length = 0;
+    for (unsigned i = 0; i < count; i++) {
+        length += MonoListLength(heap[i].l);
+    }
+    Mono *out = (Mono *) PolyAlloc(length * sizeof(struct Mono));
+    Poly *coeffs = (Poly *) PolyAlloc(count * sizeof(Poly));
+    if (out == NULL || coeffs == NULL) {
+        free(out);
+        free(coeffs);
+        return MonoListEmpty();
+    }
+    for (unsigned i = count / 2; i-- > 0;) {
+        MonoHeapDown(heap, count, i);
+    }
+
+    size_t n = 0;
+    unsigned size = count;
+    while (size > 1) {
+        if (PolyShouldStop()) {
+            // Operacja jest przerywana - usuwamy policzone jednomiany.
+            for (size_t i = 0; i < n; i++) {
+                MonoDestroy(&out[i]);
+            }
+            free(out);
+            free(coeffs);
+            return MonoListEmpty();
+        }
+        // Zdejmujemy z kopca głowy o najmniejszym wykładniku.
+        const Mono *first = heap[0].l->head;
+        unsigned g = 0;
+        bool coeffs_only = true;
+        while (size > 0 && heap[0].exp == first->exp) {
+            coeffs[g] = heap[0].l->head->poly;
+            coeffs_only &= PolyIsCoeff(&coeffs[g++]);
+            heap[0].l = heap[0].l->tail;
+            if (MonoListIsEmpty(heap[0].l)) {
+                heap[0] = heap[--size];
+            }
+            else {
+                heap[0].exp = heap[0].l->head->exp;
+            }
+            if (size > 0) {
+                MonoHeapDown(heap, size, 0);
+            }
+        }
+        if (g == 1) {
+            out[n++] = MonoClone(first);
+        }
+        else if (coeffs_only) {
+            Poly sum = PolyZero();
+            for (unsigned i = 0; i < g; i++) {
+                sum.coeff += coeffs[i].coeff;
+            }
+            out[n++] = MonoFromPoly(&sum, first->exp);
+        }
+        else {
+            Poly sum = PolySumN(coeffs, g);
+            out[n++] = MonoFromPoly(&sum, first->exp);
+        }
+    }
+
+    MonoList list = (size == 1) ? MonoListClone(heap[0].l) : MonoListEmpty();
+    while (n > 0) {
+        list = MonoListPush(list, &out[--n]);
+    }
+    free(out);
+    free(coeffs);
+    return list;
+}
+
+Poly PolySumN(const Poly ps[], unsigned n) {
+    if (n == 0) {
+        return PolyZero();
+    }
+    else if (n == 1) {
+        return PolyClone(&ps[0]);
+    }
+    else if (n == 2) {
+        return PolyAdd(&ps[0], &ps[1]);
+    }
+
+    MonoHeapItem *heap = (MonoHeapItem *) PolyAlloc(n * sizeof(MonoHeapItem));
+    if (heap == NULL) {
+        return PolyZero();
+    }
+    poly_coeff_t coeff = 0;
+    unsigned count = 0;
+    for (unsigned i = 0; i < n; i++) {
+        coeff += ps[i].coeff;
+        if (!PolyIsCoeff(&ps[i])) {
+            heap[count++] = (MonoHeapItem) {.exp = ps[i].list->head->exp, .l = ps[i].list};
+        }
+    }
+    Poly sum = PolyFromMonoList(MonoListSumN(heap, count), coeff);
+    free(heap);
+    return PolyStopResult(&sum);
+}
+
+/**
+ * Dopisuje do tablicy iloczyny jednomianów dwóch wielomianów, traktując
+ * ich wyrazy wolne jak jednomiany o wykładniku 0. Iloczyn wyrazów wolnych
+ * nie jest jednomianem, więc jest zwracany osobno.
+ * @param p wielomian
+ * @param q wielomian
+ * @param out miejsce na iloczyny
+ * @param count liczba iloczynów w @p out, zwiększana o dopisane
+ * @return iloczyn wyrazów wolnych
+ */
+static poly_coeff_t MonoListDotTerms(const Poly *p, const Poly *q, Mono out[],
+                                     size_t *count) {
+    Poly pc = PolyFromCoeff(p->coeff), qc = PolyFromCoeff(q->coeff);
+    if (p->coeff != 0) {
+        for (MonoList b = q->list; !MonoListIsEmpty(b); b = b->tail) {
+            Poly mul = PolyMul(&pc, &(b->head->poly));
+            out[(*count)++] = MonoFromPoly(&mul, b->head->exp);
+        }
+    }
+    for (MonoList a = p->list; !MonoListIsEmpty(a); a = a->tail) {
+        if (q->coeff != 0) {
+            Poly mul = PolyMul(&(a->head->poly), &qc);
+            out[(*count)++] = MonoFromPoly(&mul, a->head->exp);
+        }
+        for (MonoList b = q->list; !MonoListIsEmpty(b); b = b->tail) {
+            out[(*count)++] = MonoMul(a->head, b->head);
+        }
+    }
+    return p->coeff * q->coeff;
+}
+
+/**
+ * Liczba iloczynów jednomianów, które MonoListDotTerms dopisuje dla pary.
+ * @param p wielomian
+ * @param q wielomian
+ * @return liczba iloczynów
+ */
+static size_t MonoListDotCount(const Poly *p, const Poly *q) {
+    size_t lp = MonoListLength(p->list) + (p->coeff != 0);
+    size_t lq = MonoListLength(q->list) + (q->coeff != 0);
+    return lp * lq - (p->coeff != 0 && q->coeff != 0);
+}
+
+Poly PolyDot(const Poly a[], const Poly b[], unsigned n) {
+    // Pary grupowane są w porcje po około DOT_CHUNK_MONOS iloczynów, żeby
+    // sortowana tablica mieściła się w pamięci podręcznej.
+    size_t chunks = 0, max_count = 0, count = 0;
+    for (unsigned i = 0; i < n; i++) {
+        size_t terms = MonoListDotCount(&a[i], &b[i]);
+        if (count > 0 && count + terms > DOT_CHUNK_MONOS) {
+            chunks++;
+            count = 0;
+        }
+        count += terms;
+        max_count = (count > max_count) ? count : max_count;
+    }
+    chunks += (count > 0);
+    if (max_count > UINT_MAX) {
+        // Tylu iloczynów nie da się zsumować przez PolyAddMonos.
+        PolySetError(POLY_ERR_NO_MEMORY);
+        return PolyZero();
+    }
+    Mono *muls = (Mono *) PolyAlloc((max_count + 1) * sizeof(struct Mono));
+    Poly *parts = (Poly *) PolyAlloc((chunks + 1) * sizeof(Poly));
+    if (muls == NULL || parts == NULL) {
+        free(muls);
+        free(parts);
+        return PolyZero();
+    }
+
+    // Iloczyny par trafiają wprost do sumowania porcji, bez tworzenia
+    // wielomianów a[i] * b[i]; sumy porcji scala PolySumN.
+    size_t k = 0;
+    poly_coeff_t coeff = 0;
+    count = 0;
+    for (unsigned i = 0; i <= n; i++) {
+        size_t terms = (i < n) ? MonoListDotCount(&a[i], &b[i]) : 0;
+        if (count > 0 && (i == n || count + terms > DOT_CHUNK_MONOS)) {
+            parts[k++] = PolyAddMonos((unsigned) count, muls);
+            count = 0;
+        }
+        if (i == n) {
+            break;
+        }
+        if (PolyShouldStop()) {
+            // Operacja jest przerywana - usuwamy policzone iloczyny.
+            for (size_t j = 0; j < count; j++) {
+                MonoDestroy(&muls[j]);
+            }
+            break;
+        }
+        coeff += MonoListDotTerms(&a[i], &b[i], muls, &count);
+    }
+    Poly dot = PolySumN(parts, (unsigned) k);
+    for (size_t j = 0; j < k; j++) {
+        PolyDestroy(&parts[j]);
+    }
+    free(parts);
+    free(muls);
+    dot.coeff += coeff;
+    return PolyStopResult(&dot);
+}
+
+
+
+/**
+ * Sprawdza, czy do elementu listy jest więcej niż jedno odwołanie.
+ * Element, do którego prowadzą tylko odwołania wyłącznie posiadane przez
+ * wywołującego, może zostać przez niego zmieniony.
+ * @param l niepusta lista
+ * @return Czy element jest współdzielony?
+ */
+static bool MonoListIsShared(const MonoList l) {
+    return __atomic_load_n(&(l->refs), __ATOMIC_ACQUIRE) > 1;
+}
+
+/**
+ * Przelicza zapamiętane parametry pierwszych @p count elementów listy po
+ * zmianach w miejscu. Parametry elementu zależą od ogona, więc elementy
+ * przeliczane są od końca: dowiązania są najpierw odwracane, a potem
+ * przywracane, więc nie potrzeba dodatkowej pamięci.
+ * @param l lista, której pierwsze @p count elementów nie jest współdzielone
+ * @param count liczba elementów do przeliczenia
+ */
+static void MonoListRefresh(MonoList l, size_t count) {
+    MonoList prev = MonoListEmpty();
+    for (size_t i = 0; i < count; i++) {
+        MonoList next = l->tail;
+        l->tail = prev;
+        prev = l;
+        l = next;
+    }
+    while (!MonoListIsEmpty(prev)) {
+        MonoList next = prev->tail;
+        prev->tail = l;
+        MonoElemUpdate(prev);
+        l = prev;
+        prev = next;
+    }
+}
+
+/**
+ * Tworzy listę z jednomianów o rosnących wykładnikach.
+ * Przejmuje na własność jednomiany.
+ * @param monos jednomiany
+ * @param count liczba jednomianów
+ * @return lista
+ */
+static MonoList MonoListFromSorted(Mono monos[], size_t count) {
+    MonoList list = MonoListEmpty();
+    while (count > 0) {
+        list = MonoListPush(list, &monos[--count]);
+    }
+    return list;
+}
+
+/**
+ * Zastępuje resztę listy wskazywaną przez @p link sumą tej reszty i @p rest,
+ * kopiując ją zwykłym dodawaniem (reszta jest współdzielona albo pusta).
+ * Przejmuje na własność @p rest.
+ * @param link dowiązanie do reszty listy
+ * @param rest lista
+ */
+static void MonoListAddShared(MonoList *link, MonoList rest) {
+    MonoList sum = MonoListAdd(*link, rest);
+    MonoListDestroy(*link);
+    MonoListDestroy(rest);
+    *link = sum;
+}
+
+/**
+ * Dodaje wielomian do wielomianu w miejscu: niewspółdzielone elementy
+ * listy @p acc są zmieniane, a niewspółdzielone elementy listy @p add
+ * przepinane do wyniku, więc nowe elementy powstają tylko dla
+ * współdzielonych jednomianów o nowych wykładnikach.
+ * Przejmuje na własność @p add.
+ * @param acc wielomian, do którego wynik jest zapisywany
+ * @param add dodawany wielomian
+ */
+static void PolyAddInto(Poly *acc, Poly *add) {
+    acc->coeff += add->coeff;
+    MonoList b = add->list;
+    *add = PolyZero();
+    MonoList *link = &(acc->list);
+    size_t passed = 0;
+    while (!MonoListIsEmpty(b)) {
+        MonoList a = *link;
+        if (MonoListIsEmpty(a) || MonoListIsShared(a)) {
+            MonoListAddShared(link, b);
+            break;
+        }
+        if (a->head->exp < b->head->exp) {
+            link = &(a->tail);
+            passed++;
+            continue;
+        }
+
+        // Zabieramy głowę b: cały element, jeśli nie jest współdzielony.
+        MonoList next;
+        if (!MonoListIsShared(b)) {
+            next = b->tail;
+            if (b->head->exp < a->head->exp) {
+                b->tail = a;
+                *link = b;
+                link = &(b->tail);
+                passed++;
+                b = next;
+                continue;
+            }
+            Mono m = *(b->head);
+            MonoElemFree(b);
+            PolyAddInto(&(a->head->poly), &(m.poly));
+        }
+        else {
+            next = MonoListRef(b->tail);
+            Mono m = MonoClone(b->head);
+            MonoListDestroy(b);
+            if (m.exp < a->head->exp) {
+                MonoList new = MonoListPush(a, &m);
+                if (new != a) {
+                    *link = new;
+                    link = &(new->tail);
+                    passed++;
+                }
+                b = next;
+                continue;
+            }
+            PolyAddInto(&(a->head->poly), &(m.poly));
+        }
+        b = next;
+
+        if (PolyIsZero(&(a->head->poly))) {
+            *link = a->tail;
+            MonoElemFree(a);
+        }
+        else {
+            link = &(a->tail);
+            passed++;
+        }
+    }
+    MonoListRefresh(acc->list, passed);
+}
+
+/**
+ * Dodaje do wielomianu w miejscu jednomiany o rosnących wykładnikach,
+ * tak jak PolyAddInto. Przejmuje na własność jednomiany.
+ * @param acc wielomian, do którego wynik jest zapisywany
+ * @param monos jednomiany
+ * @param count liczba jednomianów
+ */
+static void PolyAddSortedInto(Poly *acc, Mono monos[], size_t count) {
+    MonoList *link = &(acc->list);
+    size_t passed = 0;
+    size_t i = 0;
+    while (i < count) {
+        MonoList a = *link;
+        if (MonoListIsEmpty(a) || MonoListIsShared(a)) {
+            MonoListAddShared(link, MonoListFromSorted(&monos[i], count - i));
+            break;
+        }
+        Mono *m = &monos[i];
+        if (MonoIsZero(m)) {
+            i++;
+            continue;
+        }
+        if (a->head->exp < m->exp) {
+            link = &(a->tail);
+            passed++;
+            continue;
+        }
+        i++;
+        if (m->exp < a->head->exp) {
+            MonoList new = MonoListPush(a, m);
+            if (new != a) {
+                *link = new;
+                link = &(new->tail);
+                passed++;
+            }
+            continue;
+        }
+
+        PolyAddInto(&(a->head->poly), &(m->poly));
+        if (PolyIsZero(&(a->head->poly))) {
+            *link = a->tail;
+            MonoElemFree(a);
+        }
+        else {
+            link = &(a->tail);
+            passed++;
+        }
+    }
+    MonoListRefresh(acc->list, passed);
+}
+
+void PolyFma(Poly *acc, const Poly *p, const Poly *q) {
+    if (PolyIsZero(p) || PolyIsZero(q)) {
+        return;
+    }
+    size_t count = MonoListDotCount(p, q);
+    if (count > UINT_MAX) {
+        // Tylu iloczynów nie da się zsumować przez PolyAddMonos.
+        PolySetError(POLY_ERR_NO_MEMORY);
+    }
+    Mono local[2 * ADD_MONOS_STACK];
+    Mono *muls = (count > UINT_MAX) ? NULL : (count <= ADD_MONOS_STACK) ? local
+                 : (Mono *) PolyAlloc(2 * count * sizeof(struct Mono));
+    if (muls != NULL) {
+        // Iloczyny są sortowane i sumowane w tablicy, a potem wplatane
+        // w listę acc bez tworzenia wielomianu p * q.
+        count = 0;
+        poly_coeff_t coeff = MonoListDotTerms(p, q, muls, &count);
+        size_t runs = MonoSortSum(muls, count);
+        Mono *sums = muls + count;
+        if (runs > 0 && sums[0].exp == 0) {
+            //Wyciągamy stałą ze współczynnika na zewnątrz
+            coeff += sums[0].poly.coeff;
+            sums[0].poly.coeff = 0;
+        }
+        acc->coeff += coeff;
+        PolyAddSortedInto(acc, sums, runs);
+        if (muls != local) {
+            free(muls);
+        }
+    }
+    *acc = PolyStopResult(acc);
+}
+
+
+
 /**
  * Zwraca stopień jednomianu ze względu na zadaną zmienną.
  * @param m : jednomian
@@ -603,6 +2203,9 @@ poly_exp_t PolyDegBy(const Poly *p, unsigned var_idx) {
     if (PolyIsZero(p)) {
         return -1;
     }
+    else if (var_idx == 0) {
+        return MonoListIsEmpty(p->list) ? 0 : p->list->deg_main;
+    }
     else {
         return MonoListDegBy(p->list, var_idx);
     }
@@ -610,27 +2213,6 @@ poly_exp_t PolyDegBy(const Poly *p, unsigned var_idx) {
 
 
 
-/**
- * @param m : jednomian Ax^n
- * @return Stopień jednomianu (po wszystkich zmiennych) n + PolyDeg(A)
- */
-static poly_exp_t MonoDeg(const Mono *m) {
-    return ((m->exp) + PolyDeg(&(m->poly)));
-}
-
-/**
- * @param l : lista jednomianów
- * @return Stopień listy jednomianów
- */
-static poly_exp_t MonoListDeg(const MonoList l) {
-    if (MonoListIsEmpty(l)) {
-        return 0;
-    }
-    else {
-        return max(MonoDeg(l->head), MonoListDeg(l->tail));
-    }
-}
-
 /**
  * Zwraca stopień wielomianu (-1 dla wielomianu tożsamościowo równego zeru).
  * @param[in] p : wielomian
@@ -641,7 +2223,69 @@ poly_exp_t PolyDeg(const Poly *p) {
         return -1;
     }
     else {
-        return MonoListDeg(p->list);
+        return MonoListIsEmpty(p->list) ? 0 : p->list->deg;
+    }
+}
+
+poly_exp_t PolyOrd(const Poly *p) {
+    if (p->coeff != 0) {
+        return 0;
+    }
+    return MonoListIsEmpty(p->list) ? -1 : p->list->ord;
+}
+
+size_t PolyTermCount(const Poly *p) {
+    size_t terms = (p->coeff != 0);
+    return MonoListIsEmpty(p->list) ? terms : terms + p->list->terms;
+}
+
+unsigned PolyDepth(const Poly *p) {
+    return MonoListIsEmpty(p->list) ? 0 : p->list->depth;
+}
+
+size_t PolyNodeCount(const Poly *p) {
+    return MonoListIsEmpty(p->list) ? 0 : p->list->nodes;
+}
+
+size_t PolyMemoryUsage(const Poly *p) {
+    return PolyNodeCount(p) * sizeof(ElemBlock);
+}
+
+PolyAllocStats PolyAllocGetStats(PolyAllocator a) {
+    assert(a < POLY_ALLOC_COUNT);
+    ElemStatsPublish(&elem_cache);
+    const SharedAllocCounter *c = &alloc_counters[a];
+    long long size = (long long) alloc_object_size[a];
+    long long live = atomic_load_explicit(&(c->live), memory_order_relaxed);
+    return (PolyAllocStats) {
+        .live_bytes = live * size,
+        .live_nodes = live,
+        .allocs = atomic_load_explicit(&(c->allocs), memory_order_relaxed),
+        .peak_bytes = atomic_load_explicit(&(c->peak), memory_order_relaxed) * size
+    };
+}
+
+PolyAllocStats PolyAllocGetThreadStats(PolyAllocator a) {
+    assert(a < POLY_ALLOC_COUNT);
+    const AllocCounter *c = &(elem_cache.counters[a]);
+    long long size = (long long) alloc_object_size[a];
+    return (PolyAllocStats) {
+        .live_bytes = c->live * size,
+        .live_nodes = c->live,
+        .allocs = c->allocs,
+        .peak_bytes = c->peak * size
+    };
+}
+
+void PolyAllocResetStats() {
+    ElemStatsPublish(&elem_cache);
+    for (int a = 0; a < POLY_ALLOC_COUNT; a++) {
+        SharedAllocCounter *c = &alloc_counters[a];
+        atomic_store_explicit(&(c->allocs), 0, memory_order_relaxed);
+        atomic_store_explicit(&(c->peak), atomic_load_explicit(&(c->live), memory_order_relaxed),
+                              memory_order_relaxed);
+        elem_cache.counters[a].allocs = 0;
+        elem_cache.counters[a].peak = elem_cache.counters[a].live;
     }
 }
 
@@ -657,6 +2301,15 @@ static bool MonoIsEq(const Mono *m1, const Mono *m2) {
     return ((m1->exp == m2->exp) && PolyIsEq((&m1->poly), &(m2->poly)));
 }
 
+/**
+ * Porównuje jednomiany zadania.
+ * @param task : zadanie (MonoPairTask)
+ */
+static void MonoIsEqTaskRun(PolyTask *task) {
+    MonoPairTask *t = (MonoPairTask *) task;
+    t->eq = MonoIsEq(t->m1, t->m2);
+}
+
 /**
  * Sprawdza równość dwóch list jednomianów
  * @param l1 : lista jednomianów
@@ -664,12 +2317,23 @@ static bool MonoIsEq(const Mono *m1, const Mono *m2) {
  * @return 'l1 = l2'
  */
 static bool MonoListIsEq(const MonoList l1, const MonoList l2) {
-    if (MonoListIsEmpty(l1) && MonoListIsEmpty(l2)) {
+    if (l1 == l2) {
         return true;
     }
     else if (MonoListIsEmpty(l1) || MonoListIsEmpty(l2)) {
         return false;
     }
+    else if (l1->hash != l2->hash) {
+        // Różne skróty - listy na pewno są różne.
+        return false;
+    }
+    else if (PolyTaskShouldFork(PolyNodeCount(&(l1->head->poly)))) {
+        MonoPairTask task = {.task.run = MonoIsEqTaskRun, .m1 = l1->head, .m2 = l2->head};
+        PolyTaskFork(&(task.task));
+        bool tail_eq = MonoListIsEq(l1->tail, l2->tail);
+        TaskJoin(&(task.task));
+        return task.eq && tail_eq;
+    }
     else {
         return (MonoIsEq(l1->head, l2->head) && MonoListIsEq(l1->tail, l2->tail));
     }
@@ -685,6 +2349,11 @@ bool PolyIsEq(const Poly *p, const Poly *q) {
     return ((p->coeff == q->coeff) && MonoListIsEq(p->list, q->list));
 }
 
+uint64_t PolyHash(const Poly *p) {
+    uint64_t h = MonoListIsEmpty(p->list) ? 0 : p->list->hash;
+    return PolyHashMix(h, (uint64_t) p->coeff);
+}
+
 
 
 /**
@@ -715,6 +2384,25 @@ static Poly MonoAt(const Mono *m, poly_coeff_t x) {
     return at;
 }
 
+/**
+ * Zadanie planisty wyliczające wartość jednomianu.
+ */
+typedef struct MonoAtTask {
+    PolyTask task; ///< zadanie planisty
+    const Mono *m; ///< jednomian
+    poly_coeff_t x; ///< argument
+    Poly res; ///< wartość jednomianu
+} MonoAtTask;
+
+/**
+ * Wylicza wartość jednomianu zadania.
+ * @param task : zadanie (MonoAtTask)
+ */
+static void MonoAtTaskRun(PolyTask *task) {
+    MonoAtTask *t = (MonoAtTask *) task;
+    t->res = MonoAt(t->m, t->x);
+}
+
 /**
  * Wylicza wartość listy jednomianóœ w punkcie @p x.
  * @param l : lista jednomianów
@@ -726,8 +2414,18 @@ static Poly MonoListAt(const MonoList l, poly_coeff_t x) {
         return PolyZero();
     }
     else {
-        Poly t = MonoListAt(l->tail, x);
-        Poly h = MonoAt(l->head, x);
+        Poly t, h;
+        if (PolyTaskShouldFork(PolyNodeCount(&(l->head->poly)))) {
+            MonoAtTask task = {.task.run = MonoAtTaskRun, .m = l->head, .x = x};
+            PolyTaskFork(&(task.task));
+            t = MonoListAt(l->tail, x);
+            TaskJoin(&(task.task));
+            h = task.res;
+        }
+        else {
+            t = MonoListAt(l->tail, x);
+            h = MonoAt(l->head, x);
+        }
         Poly at = PolyAdd(&h, &t);
         PolyDestroy(&t);
         PolyDestroy(&h);
@@ -763,6 +2461,116 @@ Poly PolyAt(const Poly *p, poly_coeff_t x) {
 
 
 
+/**
+ * Zwraca pochodną jednomianu po jego zmiennej głównej.
+ * Dla jednomianu `A * x^e` jest to `(e * A) * x^(e-1)`.
+ * @param m : jednomian o dodatnim wykładniku
+ * @return pochodna jednomianu @p m po zmiennej x
+ */
+static Mono MonoDerivativeMain(const Mono *m) {
+    assert(m->exp > 0);
+    Mono d = MonoCoeffMul(m, m->exp);
+    d.exp--;
+    return d;
+}
+
+/**
+ * Zwraca pochodną wielomianu po zadanej zmiennej.
+ * Zmienne indeksowane są tak jak w PolyDegBy.
+ * @param[in] p : wielomian
+ * @param[in] var_idx : indeks zmiennej
+ * @return pochodna cząstkowa wielomianu @p p po zmiennej o indeksie @p var_idx
+ */
+Poly PolyDerivative(const Poly *p, unsigned var_idx) {
+    unsigned count = MonoListLength(p->list);
+    if (count == 0) {
+        return PolyZero();
+    }
+
+    Mono *monos = (Mono *) PolyAlloc(count * sizeof(struct Mono));
+    if (monos == NULL) {
+        return PolyZero();
+    }
+    unsigned n = 0;
+    for (MonoList l = p->list; !MonoListIsEmpty(l); l = l->tail) {
+        if (var_idx == 0) {
+            if (l->head->exp > 0) {
+                monos[n++] = MonoDerivativeMain(l->head);
+            }
+        }
+        else {
+            Poly d = PolyDerivative(&(l->head->poly), var_idx - 1);
+            monos[n++] = MonoFromPoly(&d, l->head->exp);
+        }
+    }
+
+    Poly derivative = PolyAddMonos(n, monos);
+    free(monos);
+    return derivative;
+}
+
+/**
+ * Liczy wszystkie pochodne cząstkowe wielomianu po zmiennych o indeksach
+ * od 0 do @p k - 1 w jednym przejściu po strukturze wielomianu.
+ * Pochodne współczynników liczone są rekurencyjnie raz dla każdego jednomianu
+ * i przenoszone (bez kopiowania) do jednomianów wyników.
+ * @param[in] p : wielomian
+ * @param[out] out : tablica @p k wielomianów, w której `out[i]` jest
+ * pochodną cząstkową @p p po zmiennej o indeksie `i`
+ * @param[in] k : liczba zmiennych
+ */
+void PolyGradient(const Poly *p, Poly out[], unsigned k) {
+    if (k == 0) {
+        return;
+    }
+
+    unsigned count = MonoListLength(p->list);
+    if (count == 0) {
+        for (unsigned i = 0; i < k; i++) {
+            out[i] = PolyZero();
+        }
+        return;
+    }
+
+    Mono *monos = (Mono *) PolyAlloc((size_t) k * count * sizeof(struct Mono));
+    unsigned *n = (unsigned *) PolyAlloc(k * sizeof(unsigned));
+    Poly *coeff_grad = (Poly *) PolyAlloc(k * sizeof(struct Poly));
+    if (monos == NULL || n == NULL || coeff_grad == NULL) {
+        free(coeff_grad);
+        free(n);
+        free(monos);
+        for (unsigned i = 0; i < k; i++) {
+            out[i] = PolyZero();
+        }
+        return;
+    }
+    for (unsigned i = 0; i < k; i++) {
+        n[i] = 0;
+    }
+
+    for (MonoList l = p->list; !MonoListIsEmpty(l); l = l->tail) {
+        const Mono *m = l->head;
+        if (m->exp > 0) {
+            monos[n[0]++] = MonoDerivativeMain(m);
+        }
+
+        PolyGradient(&(m->poly), coeff_grad, k - 1);
+        for (unsigned i = 1; i < k; i++) {
+            monos[i * count + n[i]++] = MonoFromPoly(&coeff_grad[i - 1], m->exp);
+        }
+    }
+
+    for (unsigned i = 0; i < k; i++) {
+        out[i] = PolyAddMonos(n[i], monos + i * count);
+    }
+
+    free(coeff_grad);
+    free(n);
+    free(monos);
+}
+
+
+
 #define PRINT_OUT stdout
 
 /**
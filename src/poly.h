@@ -1,6 +1,18 @@
 /** @file
    Interfejs klasy wielomianów
 
+   Biblioteka jest wielowejściowa. Jedynym wspólnym stanem są pule wolnych
+   elementów list i liczniki przydziałów, chronione blokadą lub zmieniane
+   atomowo; każdy wątek przydziela elementy z własnej puli. Ten sam
+   wielomian może być jednocześnie czytany (dodawany, mnożony,
+   porównywany, kopiowany przez PolyClone) przez wiele wątków, a jego
+   kopie mogą być usuwane w dowolnych wątkach. Nie wolno natomiast
+   usuwać wielomianu, który czyta inny wątek. Błędy wykryte przez
+   bibliotekę nie kończą programu - operacja zwraca poprawny wynik
+   zastępczy, a kod błędu można odczytać funkcją PolyLastError.
+   Obiekty pomocnicze (np. PolyMemo, PolyMap) nie są synchronizowane -
+   każdy powinien być używany przez jeden wątek naraz.
+
    @author Jakub Pawlewicz <pan@mimuw.edu.pl>, Konrad Komisarczyk
    @copyright Uniwersytet Warszawski
    @date 2017-04-24, TODO
@@ -11,6 +23,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /** Typ współczynników wielomianu */
 typedef long poly_coeff_t;
@@ -18,6 +31,23 @@ typedef long poly_coeff_t;
 /** Typ wykładników wielomianu */
 typedef int poly_exp_t;
 
+/**
+ * Współczynnik bez znaku - arytmetyka modulo zakres typu poly_coeff_t,
+ * bez niezdefiniowanego zachowania przy przepełnieniu.
+ */
+typedef unsigned long poly_ucoeff_t;
+
+/**
+ * Kod błędu operacji na wielomianach.
+ */
+typedef enum PolyError {
+    POLY_OK = 0, ///< brak błędu
+    POLY_ERR_UNSORTED, ///< jednomian dokładany na początek listy nie ma najmniejszego wykładnika
+    POLY_ERR_EXP_MISMATCH, ///< dodawanie jednomianów o różnych wykładnikach
+    POLY_ERR_BUDGET, ///< przekroczenie budżetu ustawionego przez PolyBudgetSet
+    POLY_ERR_NO_MEMORY ///< brak pamięci
+} PolyError;
+
 
 
 /**
@@ -34,11 +64,27 @@ typedef struct MonoElem * MonoList;
 
 /**
  * Element listy jednomianów.
- * Składa się z głowy (jednomianu) oraz ogona (listy jednomianów)
+ * Składa się z głowy (jednomianu) oraz ogona (listy jednomianów).
+ * Elementy mogą być współdzielone przez wiele wielomianów i list, dlatego
+ * po utworzeniu nie są modyfikowane (z wyjątkiem elementów, do których
+ * jest tylko jedno odwołanie, zmienianych przez PolyFma), a usuwane są
+ * dopiero, gdy licznik odwołań spadnie do zera.
+ * Element pamięta skrót i parametry listy, której jest początkiem
+ * (wyliczone przy jego tworzeniu z głowy i ogona), więc skrót, stopnie
+ * i rozmiary wielomianu są dostępne w czasie stałym.
  */
 struct MonoElem {
     Mono *head; ///< głowa - jednomian
     MonoList tail; ///< ogon
+    uint64_t hash; ///< skrót listy zaczynającej się od tego elementu
+    size_t terms; ///< liczba jednomianów listy po rozwinięciu współczynników
+    size_t nodes; ///< liczba elementów listy i list we współczynnikach
+    unsigned length; ///< długość listy
+    unsigned depth; ///< głębokość zagnieżdżenia listy
+    poly_exp_t deg; ///< stopień listy (po wszystkich zmiennych)
+    poly_exp_t deg_main; ///< największy wykładnik na liście
+    poly_exp_t ord; ///< najmniejszy stopień (po wszystkich zmiennych) wyrazu listy
+    unsigned refs; ///< liczba odwołań (z wielomianów i list) do elementu
 };
 
 /**
@@ -132,19 +178,84 @@ void PolyDestroy(Poly *p);
 void MonoDestroy(Mono *m);
 
 /**
- * Robi pełną, głęboką kopię wielomianu.
+ * Kopiuje wielomian w czasie stałym. Kopia współdzieli elementy listy
+ * z oryginałem, zwiększany jest jedynie licznik odwołań.
  * @param[in] p : wielomian
  * @return skopiowany wielomian
  */
 Poly PolyClone(const Poly *p);
 
 /**
- * Robi pełną, głęboką kopię jednomianu.
+ * Kopiuje jednomian w czasie stałym (zob. PolyClone).
  * @param[in] m : jednomian
  * @return skopiowany jednomian
  */
 Mono MonoClone(const Mono *m);
 
+/**
+ * Tworzy listę jednomianów z jednomianu i ogona.
+ * Przejmuje na własność zawartość jednomianu oraz odwołanie do ogona.
+ * Wykładnik jednomianu musi być mniejszy niż wykładniki na liście @p tail;
+ * w przeciwnym razie jednomian jest usuwany, zwracana jest lista @p tail
+ * i ustawiany jest błąd POLY_ERR_UNSORTED. Zerowy jednomian jest pomijany.
+ * @param[in] m : jednomian
+ * @param[in] tail : lista jednomianów
+ * @return lista `m + tail`
+ */
+MonoList MonoListPrepend(Mono *m, MonoList tail);
+
+/**
+ * Zwraca kod ostatniego błędu w bieżącym wątku (podobnie jak `errno`).
+ * Operacja, która wykryje błąd, zwraca wynik zastępczy opisany przy
+ * kodzie błędu, a kod pozostaje ustawiony do wywołania PolyClearError.
+ * @return kod ostatniego błędu lub POLY_OK
+ */
+PolyError PolyLastError();
+
+/**
+ * Zeruje kod ostatniego błędu w bieżącym wątku.
+ */
+void PolyClearError();
+
+/**
+ * Przywraca kod błędu bieżącego wątku zapamiętany wcześniej przez
+ * PolyLastError, np. po wykonaniu w tym wątku niezależnego obliczenia.
+ * Funkcja dla modułów biblioteki.
+ * @param[in] error : kod błędu
+ */
+void PolyRestoreError(PolyError error);
+
+/**
+ * Limity zasobów operacji bieżącego wątku. Wartość 0 oznacza brak limitu.
+ */
+typedef struct PolyBudget {
+    size_t max_terms; ///< największa liczba jednomianów (po rozwinięciu) tworzonej listy
+    size_t max_bytes; ///< największy przyrost pamięci od ustawienia budżetu
+    double max_seconds; ///< największy czas od ustawienia budżetu
+} PolyBudget;
+
+/**
+ * Ustawia budżet operacji bieżącego wątku, licząc pamięć i czas od chwili
+ * wywołania. Operacja, która przekroczy budżet, kończy się wcześniej,
+ * usuwa częściowe wyniki, zwraca wielomian zerowy i ustawia błąd
+ * POLY_ERR_BUDGET. Tak samo kończy się operacja, której zabrakło pamięci
+ * (POLY_ERR_NO_MEMORY). Dopóki któryś z tych błędów jest ustawiony,
+ * kolejne operacje wątku kończą się od razu, więc przed ponowną próbą
+ * trzeba wywołać PolyClearError (i zwykle ustawić budżet od nowa).
+ * Budżet obejmuje tylko obliczenia w bieżącym wątku - nie dotyczy części
+ * rozgałęzionych na inne wątki planisty (poly_sched.h). Operacje
+ * asynchroniczne (poly_async.h) dostają własną kopię limitów.
+ * @param[in] budget : limity lub NULL, by je wyłączyć
+ */
+void PolyBudgetSet(const PolyBudget *budget);
+
+/**
+ * Odczytuje limity budżetu bieżącego wątku.
+ * @param[out] budget : limity (zerowe, gdy budżet nie jest ustawiony)
+ * @return Czy budżet jest ustawiony?
+ */
+bool PolyBudgetGet(PolyBudget *budget);
+
 /**
  * Dodaje dwa wielomiany.
  * @param[in] p : wielomian
@@ -170,6 +281,20 @@ Poly PolyAddMonos(unsigned count, const Mono monos[]);
  */
 Poly PolyMul(const Poly *p, const Poly *q);
 
+/**
+ * Mnoży dwa wielomiany tak jak PolyMul, dzieląc zakres wykładników
+ * zmiennej głównej wyniku na @p threads przedziałów o podobnym szacowanym
+ * koszcie. Każdy wątek liczy jednomiany wyniku ze swojego przedziału,
+ * a rozłączne części są na końcu łączone bez blokad w ustalonej
+ * kolejności, więc wynik nie zależy od liczby wątków ani od ich
+ * przeplotu. Małe iloczyny liczone są w bieżącym wątku.
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @param[in] threads : liczba wątków (0 traktowane jest jak 1)
+ * @return `p * q`
+ */
+Poly PolyMulParallel(const Poly *p, const Poly *q, unsigned threads);
+
 /**
  * Zwraca przeciwny wielomian.
  * @param[in] p : wielomian
@@ -185,6 +310,43 @@ Poly PolyNeg(const Poly *p);
  */
 Poly PolySub(const Poly *p, const Poly *q);
 
+/**
+ * Sumuje @p n wielomianów. Listy jednomianów są scalane naraz (kopiec
+ * głów list), więc każdy jednomian argumentów jest odwiedzany raz,
+ * a nie kopiowany przy każdym z `n - 1` dodawań.
+ * @param[in] ps : wielomiany
+ * @param[in] n : liczba wielomianów
+ * @return @f$\sum_i ps_i@f$
+ */
+Poly PolySumN(const Poly ps[], unsigned n);
+
+/**
+ * Wylicza iloczyn skalarny wektorów wielomianów. Iloczyny jednomianów
+ * kolejnych par trafiają wprost do wspólnego sumowania (PolyAddMonos
+ * porcjami, a sumy porcji scala PolySumN), bez tworzenia pośrednich
+ * wielomianów `a[i] * b[i]`.
+ * @param[in] a : wielomiany
+ * @param[in] b : wielomiany
+ * @param[in] n : długość wektorów
+ * @return @f$\sum_i a_i b_i@f$
+ */
+Poly PolyDot(const Poly a[], const Poly b[], unsigned n);
+
+/**
+ * Dodaje do wielomianu iloczyn wielomianów w miejscu: `acc = acc + p * q`.
+ * Iloczyny jednomianów są sortowane i sumowane w tablicy, a następnie
+ * wplatane w listę @p acc: współczynniki istniejących wykładników są
+ * zmieniane w elementach, do których jest tylko jedno odwołanie, a nowe
+ * elementy powstają tylko dla nowych wykładników (elementy współdzielone
+ * z innymi wielomianami są kopiowane jak w PolyAdd). Wielomian @p acc
+ * może być jednym z czynników. Po błędzie (np. przekroczeniu budżetu)
+ * @p acc jest usuwany i staje się wielomianem zerowym.
+ * @param[in,out] acc : wielomian, do którego dodawany jest iloczyn
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ */
+void PolyFma(Poly *acc, const Poly *p, const Poly *q);
+
 /**
  * Zwraca stopień wielomianu ze względu na zadaną zmienną (-1 dla wielomianu
  * tożsamościowo równego zeru).
@@ -205,6 +367,97 @@ poly_exp_t PolyDegBy(const Poly *p, unsigned var_idx);
  */
 poly_exp_t PolyDeg(const Poly *p);
 
+/**
+ * Zwraca najmniejszy stopień (po wszystkich zmiennych) wyrazu wielomianu
+ * (-1 dla wielomianu tożsamościowo równego zeru). Działa w czasie stałym.
+ * @param[in] p : wielomian
+ * @return najmniejszy stopień wyrazu wielomianu @p p
+ */
+poly_exp_t PolyOrd(const Poly *p);
+
+/**
+ * Zwraca liczbę jednomianów wielomianu po rozwinięciu wszystkich
+ * współczynników, łącznie z niezerowym wyrazem wolnym.
+ * Działa w czasie stałym.
+ * @param[in] p : wielomian
+ * @return liczba jednomianów
+ */
+size_t PolyTermCount(const Poly *p);
+
+/**
+ * Zwraca głębokość zagnieżdżenia wielomianu: 0 dla współczynnika,
+ * a w przeciwnym razie o jeden więcej niż największa głębokość
+ * współczynników jednomianów. Działa w czasie stałym.
+ * @param[in] p : wielomian
+ * @return głębokość
+ */
+unsigned PolyDepth(const Poly *p);
+
+/**
+ * Zwraca liczbę elementów list tworzących wielomian (wraz z listami we
+ * współczynnikach). Działa w czasie stałym.
+ * @param[in] p : wielomian
+ * @return liczba elementów list
+ */
+size_t PolyNodeCount(const Poly *p);
+
+/**
+ * Zwraca liczbę bajtów zajmowanych przez elementy list wielomianu.
+ * Elementy współdzielone z innymi wielomianami (PolyClone) lub występujące
+ * wielokrotnie w tym samym wielomianie liczone są przy każdym odwołaniu,
+ * więc jest to ograniczenie górne pamięci zwalnianej przez PolyDestroy.
+ * Działa w czasie stałym.
+ * @param[in] p : wielomian
+ * @return liczba bajtów
+ */
+size_t PolyMemoryUsage(const Poly *p);
+
+/**
+ * Rodzaj pamięci przydzielanej przez bibliotekę.
+ */
+typedef enum PolyAllocator {
+    POLY_ALLOC_ELEMS, ///< elementy list wraz z jednomianami
+    POLY_ALLOC_SLABS, ///< bloki pamięci, z których wydzielane są elementy
+    POLY_ALLOC_COUNT ///< liczba rodzajów pamięci
+} PolyAllocator;
+
+/**
+ * Liczniki przydziałów pamięci.
+ * Liczniki wątku dotyczą tylko przydziałów i zwolnień wykonanych przez
+ * ten wątek, więc gdy zwalnia on pamięć przydzieloną przez inny wątek,
+ * jego liczba żywych bajtów może być ujemna.
+ */
+typedef struct PolyAllocStats {
+    long long live_bytes; ///< przydzielone i niezwolnione bajty
+    long long live_nodes; ///< przydzielone i niezwolnione obiekty
+    size_t allocs; ///< liczba przydziałów od ostatniego wyzerowania
+    long long peak_bytes; ///< największa wartość `live_bytes` od ostatniego wyzerowania
+} PolyAllocStats;
+
+/**
+ * Zwraca liczniki przydziałów całej biblioteki. Wątki przekazują
+ * swoje liczniki porcjami, więc wartości mogą się różnić od dokładnych
+ * o kilkadziesiąt elementów na każdy inny działający wątek; zmiany
+ * wątku wywołującego są uwzględnione w całości.
+ * @param[in] a : rodzaj pamięci
+ * @return liczniki
+ */
+PolyAllocStats PolyAllocGetStats(PolyAllocator a);
+
+/**
+ * Zwraca liczniki przydziałów bieżącego wątku.
+ * @param[in] a : rodzaj pamięci
+ * @return liczniki
+ */
+PolyAllocStats PolyAllocGetThreadStats(PolyAllocator a);
+
+/**
+ * Zeruje liczniki przydziałów i ustawia największe zużycie pamięci na
+ * bieżące, zarówno dla całej biblioteki, jak i dla bieżącego wątku.
+ * Liczniki innych wątków nie są zmieniane.
+ */
+void PolyAllocResetStats();
+
 /**
  * Sprawdza równość dwóch wielomianów.
  * @param[in] p : wielomian
@@ -213,6 +466,26 @@ poly_exp_t PolyDeg(const Poly *p);
  */
 bool PolyIsEq(const Poly *p, const Poly *q);
 
+/**
+ * Zwraca skrót wielomianu w czasie stałym.
+ * Skrót zależy wyłącznie od wykładników i współczynników, więc równe
+ * wielomiany mają równe skróty niezależnie od sposobu ich utworzenia,
+ * a wartości są takie same przy każdym uruchomieniu programu.
+ * @param[in] p : wielomian
+ * @return skrót
+ */
+uint64_t PolyHash(const Poly *p);
+
+/**
+ * Dołącza wartość do skrótu. Z tej funkcji korzystają PolyHash i klucze
+ * tablic w modułach biblioteki (poly_hashcons.h, poly_memo.h), dzięki
+ * czemu ich skróty są ze sobą spójne. Funkcja dla modułów biblioteki.
+ * @param[in] h : skrót
+ * @param[in] x : wartość
+ * @return nowy skrót
+ */
+uint64_t PolyHashMix(uint64_t h, uint64_t x);
+
 /**
  * Wylicza wartość wielomianu w punkcie @p x.
  * Wstawia pod pierwszą zmienną wielomianu wartość @p x.
@@ -226,6 +499,25 @@ bool PolyIsEq(const Poly *p, const Poly *q);
  */
 Poly PolyAt(const Poly *p, poly_coeff_t x);
 
+/**
+ * Zwraca pochodną wielomianu po zadanej zmiennej.
+ * Zmienne indeksowane są tak jak w PolyDegBy.
+ * @param[in] p : wielomian
+ * @param[in] var_idx : indeks zmiennej
+ * @return pochodna cząstkowa wielomianu @p p po zmiennej o indeksie @p var_idx
+ */
+Poly PolyDerivative(const Poly *p, unsigned var_idx);
+
+/**
+ * Liczy wszystkie pochodne cząstkowe wielomianu po zmiennych o indeksach
+ * od 0 do @p k - 1 w jednym przejściu po strukturze wielomianu.
+ * @param[in] p : wielomian
+ * @param[out] out : tablica @p k wielomianów, w której `out[i]` jest
+ * pochodną cząstkową @p p po zmiennej o indeksie `i`
+ * @param[in] k : liczba zmiennych
+ */
+void PolyGradient(const Poly *p, Poly out[], unsigned k);
+
 
 
 
@@ -0,0 +1,203 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "poly.h"
+#include "poly_async.h"
+
+/**
+ * Operacja wykonywana asynchronicznie.
+ */
+typedef enum AsyncOp {
+    ASYNC_MUL, ///< mnożenie
+    ASYNC_ADD, ///< dodawanie
+    ASYNC_POW ///< potęgowanie
+} AsyncOp;
+
+/**
+ * Uchwyt operacji asynchronicznej.
+ */
+struct PolyFuture {
+    AsyncOp op; ///< operacja
+    Poly p; ///< pierwszy argument (własne odwołanie)
+    Poly q; ///< drugi argument (własne odwołanie, dla ASYNC_POW zerowy)
+    unsigned e; ///< wykładnik (dla ASYNC_POW)
+    Poly res; ///< wynik, dopóki nie zostanie odebrany
+    PolyError error; ///< kod błędu operacji (dla POLY_FUTURE_FAILED)
+    PolyBudget budget; ///< limity budżetu wątku uruchamiającego
+    bool budgeted; ///< czy wątek uruchamiający miał ustawiony budżet
+    pthread_t tid; ///< wątek wykonujący operację
+    bool joined; ///< czy wątek został już dołączony (albo nie powstał)
+    atomic_bool cancel; ///< prośba o przerwanie
+    atomic_int state; ///< stan operacji (PolyFutureState)
+};
+
+/** Flaga przerwania operacji wykonywanej przez bieżący wątek */
+static _Thread_local atomic_bool *async_cancel;
+
+bool PolyCancelRequested(void) {
+    return async_cancel != NULL
+           && atomic_load_explicit(async_cancel, memory_order_relaxed);
+}
+
+/**
+ * Podnosi wielomian do potęgi, sprawdzając między mnożeniami,
+ * czy operacja ma zostać przerwana.
+ * @param p : wielomian
+ * @param e : wykładnik
+ * @return @f$p^e@f$
+ */
+static Poly AsyncPow(const Poly *p, unsigned e) {
+    Poly res = PolyFromCoeff(1);
+    Poly base = PolyClone(p);
+    while (e > 0 && !PolyCancelRequested()) {
+        if (e & 1) {
+            Poly next = PolyMul(&res, &base);
+            PolyDestroy(&res);
+            res = next;
+        }
+        e >>= 1;
+        if (e > 0) {
+            Poly next = PolyMul(&base, &base);
+            PolyDestroy(&base);
+            base = next;
+        }
+    }
+    PolyDestroy(&base);
+    return res;
+}
+
+/**
+ * Wykonuje operację uchwytu. Wynik przerwanej operacji albo operacji,
+ * która zgłosiła błąd, jest niepełny lub zastępczy, więc zostaje usunięty.
+ * Operacja zaczyna bez błędu, a potem wątek wraca do swojego kodu błędu.
+ * @param f : uchwyt operacji
+ */
+static void AsyncRun(PolyFuture *f) {
+    PolyError saved = PolyLastError();
+    PolyClearError();
+    async_cancel = &(f->cancel);
+    Poly res;
+    switch (f->op) {
+        case ASYNC_MUL:
+            res = PolyMul(&(f->p), &(f->q));
+            break;
+        case ASYNC_ADD:
+            res = PolyAdd(&(f->p), &(f->q));
+            break;
+        default:
+            res = AsyncPow(&(f->p), f->e);
+            break;
+    }
+    PolyError error = PolyLastError();
+    async_cancel = NULL;
+    PolyRestoreError(saved);
+
+    if (atomic_load(&(f->cancel))) {
+        PolyDestroy(&res);
+        atomic_store_explicit(&(f->state), POLY_FUTURE_CANCELLED, memory_order_release);
+    }
+    else if (error != POLY_OK) {
+        PolyDestroy(&res);
+        f->error = error;
+        atomic_store_explicit(&(f->state), POLY_FUTURE_FAILED, memory_order_release);
+    }
+    else {
+        f->res = res;
+        atomic_store_explicit(&(f->state), POLY_FUTURE_DONE, memory_order_release);
+    }
+}
+
+/**
+ * Wątek operacji: ustawia budżet wątku uruchamiającego i wykonuje operację.
+ * @param arg : uchwyt operacji (PolyFuture)
+ * @return NULL
+ */
+static void *AsyncWorker(void *arg) {
+    PolyFuture *f = (PolyFuture *) arg;
+    if (f->budgeted) {
+        PolyBudgetSet(&(f->budget));
+    }
+    AsyncRun(f);
+    return NULL;
+}
+
+/**
+ * Tworzy uchwyt i uruchamia wątek operacji. Jeśli wątku nie da się
+ * utworzyć, operacja wykonywana jest od razu w wątku wywołującym,
+ * w ramach jego budżetu.
+ * @param op : operacja
+ * @param p : pierwszy argument
+ * @param q : drugi argument lub NULL
+ * @param e : wykładnik
+ * @return uchwyt operacji
+ */
+static PolyFuture *AsyncStart(AsyncOp op, const Poly *p, const Poly *q, unsigned e) {
+    PolyFuture *f = (PolyFuture *) malloc(sizeof(struct PolyFuture));
+    f->op = op;
+    f->p = PolyClone(p);
+    f->q = (q == NULL) ? PolyZero() : PolyClone(q);
+    f->e = e;
+    f->res = PolyZero();
+    f->error = POLY_OK;
+    f->budgeted = PolyBudgetGet(&(f->budget));
+    f->joined = false;
+    atomic_init(&(f->cancel), false);
+    atomic_init(&(f->state), POLY_FUTURE_RUNNING);
+    if (pthread_create(&(f->tid), NULL, AsyncWorker, f) != 0) {
+        AsyncRun(f);
+        f->joined = true;
+    }
+    return f;
+}
+
+PolyFuture *PolyMulAsync(const Poly *p, const Poly *q) {
+    return AsyncStart(ASYNC_MUL, p, q, 0);
+}
+
+PolyFuture *PolyAddAsync(const Poly *p, const Poly *q) {
+    return AsyncStart(ASYNC_ADD, p, q, 0);
+}
+
+PolyFuture *PolyPowAsync(const Poly *p, unsigned e) {
+    return AsyncStart(ASYNC_POW, p, NULL, e);
+}
+
+PolyFutureState PolyFuturePoll(const PolyFuture *f) {
+    atomic_int *state = (atomic_int *) &(f->state);
+    return (PolyFutureState) atomic_load_explicit(state, memory_order_acquire);
+}
+
+PolyFutureState PolyFutureWait(PolyFuture *f, Poly *res) {
+    if (!f->joined) {
+        pthread_join(f->tid, NULL);
+        f->joined = true;
+    }
+    PolyFutureState state = PolyFuturePoll(f);
+    *res = f->res;
+    f->res = PolyZero();
+    return state;
+}
+
+PolyError PolyFutureError(const PolyFuture *f) {
+    if (PolyFuturePoll(f) != POLY_FUTURE_FAILED) {
+        return POLY_OK;
+    }
+    return f->error;
+}
+
+void PolyFutureCancel(PolyFuture *f) {
+    atomic_store(&(f->cancel), true);
+}
+
+void PolyFutureDestroy(PolyFuture *f) {
+    if (f == NULL) {
+        return;
+    }
+    PolyFutureCancel(f);
+    Poly res;
+    PolyFutureWait(f, &res);
+    PolyDestroy(&res);
+    PolyDestroy(&(f->p));
+    PolyDestroy(&(f->q));
+    free(f);
+}
@@ -0,0 +1,118 @@
+/** @file
+   Interfejs asynchronicznych operacji na wielomianach
+
+   Długie operacje (mnożenie dużych wielomianów, potęgowanie) można
+   uruchomić w osobnym wątku i dostać od razu uchwyt (future), przez który
+   sprawdza się stan operacji, czeka na wynik albo prosi o jej przerwanie.
+   Przerwanie jest kooperacyjne: pętle MonoListAdd, MonoListMul
+   i PolyAddMonos sprawdzają flagę operacji i po jej ustawieniu kończą się
+   szybko, a częściowe wyniki są usuwane z pamięci.
+
+   Operacje przejmują własne odwołania do argumentów (kopiowanie w czasie
+   stałym), więc wywołujący może usunąć argumenty zaraz po uruchomieniu.
+
+   Operacja podlega limitom budżetu (PolyBudgetSet) ustawionym w wątku,
+   który ją uruchomił, liczonym od jej uruchomienia w osobnym wątku.
+   Operacja, która przekroczy budżet albo której zabraknie pamięci, kończy
+   się stanem POLY_FUTURE_FAILED, a kod błędu odczytuje się przez
+   PolyFutureError. Błąd nie ustawia się w wątku wywołującym.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_ASYNC_H__
+#define __POLY_ASYNC_H__
+
+#include <stdbool.h>
+#include "poly.h"
+
+/**
+ * Uchwyt operacji asynchronicznej.
+ */
+typedef struct PolyFuture PolyFuture;
+
+/**
+ * Stan operacji asynchronicznej.
+ */
+typedef enum PolyFutureState {
+    POLY_FUTURE_RUNNING, ///< operacja trwa
+    POLY_FUTURE_DONE, ///< wynik jest gotowy
+    POLY_FUTURE_CANCELLED, ///< operacja została przerwana
+    POLY_FUTURE_FAILED ///< operacja zgłosiła błąd (PolyFutureError)
+} PolyFutureState;
+
+/**
+ * Uruchamia asynchronicznie mnożenie wielomianów.
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @return uchwyt operacji obliczającej `p * q`
+ */
+PolyFuture *PolyMulAsync(const Poly *p, const Poly *q);
+
+/**
+ * Uruchamia asynchronicznie dodawanie wielomianów.
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @return uchwyt operacji obliczającej `p + q`
+ */
+PolyFuture *PolyAddAsync(const Poly *p, const Poly *q);
+
+/**
+ * Uruchamia asynchronicznie potęgowanie wielomianu przez podnoszenie
+ * do kwadratu.
+ * @param[in] p : wielomian
+ * @param[in] e : wykładnik
+ * @return uchwyt operacji obliczającej @f$p^e@f$
+ */
+PolyFuture *PolyPowAsync(const Poly *p, unsigned e);
+
+/**
+ * Sprawdza stan operacji bez czekania.
+ * @param[in] f : uchwyt operacji
+ * @return stan operacji
+ */
+PolyFutureState PolyFuturePoll(const PolyFuture *f);
+
+/**
+ * Czeka na zakończenie operacji. Jeśli operacja się powiodła, przekazuje
+ * wynik na własność wywołującego; kolejne wywołania dają wielomian zerowy.
+ * @param[in] f : uchwyt operacji
+ * @param[out] res : wynik operacji (wielomian zerowy, jeśli ją przerwano
+ * albo zgłosiła błąd)
+ * @return stan operacji po zakończeniu
+ */
+PolyFutureState PolyFutureWait(PolyFuture *f, Poly *res);
+
+/**
+ * Zwraca kod błędu, którym zakończyła się operacja w stanie
+ * POLY_FUTURE_FAILED.
+ * @param[in] f : uchwyt operacji
+ * @return kod błędu lub POLY_OK, jeśli operacja nie zgłosiła błędu
+ * (albo jeszcze trwa)
+ */
+PolyError PolyFutureError(const PolyFuture *f);
+
+/**
+ * Prosi o przerwanie operacji. Nie czeka na jej zakończenie; operacja,
+ * która zdążyła się zakończyć, zachowuje wynik.
+ * @param[in] f : uchwyt operacji
+ */
+void PolyFutureCancel(PolyFuture *f);
+
+/**
+ * Przerywa operację, jeśli jeszcze trwa, czeka na jej zakończenie i usuwa
+ * uchwyt wraz z nieodebranym wynikiem.
+ * @param[in] f : uchwyt operacji lub NULL
+ */
+void PolyFutureDestroy(PolyFuture *f);
+
+/**
+ * Sprawdza, czy operacja asynchroniczna wykonywana przez bieżący wątek
+ * ma zostać przerwana. Funkcja dla modułów biblioteki, wywoływana
+ * w pętlach długich operacji.
+ * @return Czy przerwać obliczenie?
+ */
+bool PolyCancelRequested(void);
+
+#endif /* __POLY_ASYNC_H__ */
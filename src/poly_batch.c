@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include "poly.h"
+#include "poly_batch.h"
+
+/**
+ * Część wsadu wykonywana jako zadanie planisty.
+ */
+typedef struct BatchTask {
+    PolyTask task; ///< zadanie planisty
+    const PolyBatchOp *ops; ///< operacje
+    PolyBatchResult *results; ///< wyniki
+    const size_t *cost; ///< sumy prefiksowe szacowanych kosztów operacji
+    size_t count; ///< liczba operacji
+} BatchTask;
+
+/**
+ * Szacuje koszt operacji jako łączną liczbę elementów list argumentów.
+ * @param op : operacja
+ * @return szacowany koszt, co najmniej 1
+ */
+static size_t BatchOpCost(const PolyBatchOp *op) {
+    size_t cost = 1 + PolyNodeCount(op->p);
+    if (op->kind == POLY_BATCH_ADD || op->kind == POLY_BATCH_SUB
+        || op->kind == POLY_BATCH_IS_EQ) {
+        cost += PolyNodeCount(op->q);
+    }
+    else if (op->kind == POLY_BATCH_MUL) {
+        cost += PolyNodeCount(op->p) * PolyNodeCount(op->q);
+    }
+    return cost;
+}
+
+/**
+ * Wykonuje jedną operację i zapisuje jej wynik. Operacja zaczyna bez
+ * błędu, a potem wątek wraca do swojego kodu błędu, który może należeć
+ * do obejmującej operacji (gdy część wsadu wykonuje się w trakcie
+ * czekania na zadanie).
+ * @param op : operacja
+ * @param res : wynik
+ */
+static void BatchOpRun(const PolyBatchOp *op, PolyBatchResult *res) {
+    PolyError saved = PolyLastError();
+    PolyClearError();
+    *res = (PolyBatchResult) {.poly = PolyZero(), .deg = -1, .eq = false};
+    switch (op->kind) {
+        case POLY_BATCH_ADD:
+            res->poly = PolyAdd(op->p, op->q);
+            break;
+        case POLY_BATCH_SUB:
+            res->poly = PolySub(op->p, op->q);
+            break;
+        case POLY_BATCH_MUL:
+            res->poly = PolyMul(op->p, op->q);
+            break;
+        case POLY_BATCH_NEG:
+            res->poly = PolyNeg(op->p);
+            break;
+        case POLY_BATCH_AT:
+            res->poly = PolyAt(op->p, op->x);
+            break;
+        case POLY_BATCH_DEG:
+            res->deg = PolyDeg(op->p);
+            break;
+        case POLY_BATCH_DEG_BY:
+            res->deg = PolyDegBy(op->p, op->var_idx);
+            break;
+        case POLY_BATCH_IS_EQ:
+            res->eq = PolyIsEq(op->p, op->q);
+            break;
+    }
+    res->error = PolyLastError();
+    PolyRestoreError(saved);
+}
+
+static void BatchRange(const PolyBatchOp *ops, PolyBatchResult *results,
+                       const size_t *cost, size_t count);
+
+/**
+ * Wykonuje część wsadu zadania.
+ * @param task : zadanie (BatchTask)
+ */
+static void BatchTaskRun(PolyTask *task) {
+    BatchTask *t = (BatchTask *) task;
+    BatchRange(t->ops, t->results, t->cost, t->count);
+}
+
+/**
+ * Wykonuje część wsadu. Dopóki część jest wystarczająco kosztowna,
+ * dzieli ją na dwie o podobnym koszcie i pierwszą odkłada jako zadanie.
+ * @param ops : operacje
+ * @param results : wyniki
+ * @param cost : sumy prefiksowe kosztów, `cost[i]` to koszt operacji przed `i`
+ * @param count : liczba operacji
+ */
+static void BatchRange(const PolyBatchOp *ops, PolyBatchResult *results,
+                       const size_t *cost, size_t count) {
+    if (count > 1 && PolyTaskShouldFork(cost[count] - cost[0])) {
+        // Podział w połowie kosztu, ale tak, by obie części były niepuste.
+        size_t target = cost[0] + (cost[count] - cost[0]) / 2;
+        size_t lo = 1, hi = count - 1;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (cost[mid] < target) {
+                lo = mid + 1;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        BatchTask task = {.task.run = BatchTaskRun, .ops = ops, .results = results,
+                          .cost = cost, .count = lo};
+        PolyTaskFork(&(task.task));
+        BatchRange(ops + lo, results + lo, cost + lo, count - lo);
+        PolyTaskJoin(&(task.task));
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        BatchOpRun(&ops[i], &results[i]);
+    }
+}
+
+void PolyBatchRun(PolySched *s, const PolyBatchOp ops[], size_t count,
+                  PolyBatchResult results[]) {
+    if (s == NULL || count <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            BatchOpRun(&ops[i], &results[i]);
+        }
+        return;
+    }
+
+    size_t *cost = (size_t *) malloc((count + 1) * sizeof(size_t));
+    cost[0] = 0;
+    for (size_t i = 0; i < count; i++) {
+        cost[i + 1] = cost[i] + BatchOpCost(&ops[i]);
+    }
+    BatchTask root = {.task.run = BatchTaskRun, .ops = ops, .results = results,
+                      .cost = cost, .count = count};
+    PolySchedRun(s, &(root.task));
+    free(cost);
+}
+
+void PolyBatchResultsDestroy(PolyBatchResult results[], size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        PolyDestroy(&(results[i].poly));
+    }
+}
@@ -0,0 +1,83 @@
+/** @file
+   Interfejs wsadowego wykonywania niezależnych operacji na wielomianach
+
+   Wiele małych, niezależnych operacji (dodawanie, mnożenie, wartości,
+   stopnie) na osobnych wielomianach można zlecić jednym wywołaniem:
+   wywołujący wypełnia tablicę opisów operacji wskazujących argumenty,
+   a biblioteka rozdziela je między wątki planisty (poly_sched.h)
+   i zapisuje wyniki w tablicy wyników o tych samych indeksach.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_BATCH_H__
+#define __POLY_BATCH_H__
+
+#include <stddef.h>
+#include "poly.h"
+#include "poly_sched.h"
+
+/**
+ * Rodzaj operacji wsadowej.
+ */
+typedef enum PolyBatchKind {
+    POLY_BATCH_ADD, ///< `p + q`
+    POLY_BATCH_SUB, ///< `p - q`
+    POLY_BATCH_MUL, ///< `p * q`
+    POLY_BATCH_NEG, ///< `-p`
+    POLY_BATCH_AT, ///< @f$p(x, x_0, x_1, \ldots)@f$
+    POLY_BATCH_DEG, ///< stopień `p`
+    POLY_BATCH_DEG_BY, ///< stopień `p` względem zmiennej `var_idx`
+    POLY_BATCH_IS_EQ ///< `p = q`
+} PolyBatchKind;
+
+/**
+ * Opis operacji wsadowej. Argumenty nie są przejmowane na własność
+ * i muszą istnieć do końca wykonania wsadu. Te same wielomiany mogą
+ * być argumentami wielu operacji.
+ */
+typedef struct PolyBatchOp {
+    PolyBatchKind kind; ///< rodzaj operacji
+    const Poly *p; ///< pierwszy argument
+    const Poly *q; ///< drugi argument (dla operacji dwuargumentowych)
+    poly_coeff_t x; ///< wartość argumentu (dla POLY_BATCH_AT)
+    unsigned var_idx; ///< indeks zmiennej (dla POLY_BATCH_DEG_BY)
+} PolyBatchOp;
+
+/**
+ * Wynik operacji wsadowej. Operacje dające wielomian zapisują go
+ * w polu `poly` (przechodzi on na własność wywołującego), pozostałe
+ * zapisują tam wielomian zerowy.
+ */
+typedef struct PolyBatchResult {
+    Poly poly; ///< wynik-wielomian
+    poly_exp_t deg; ///< stopień (dla POLY_BATCH_DEG i POLY_BATCH_DEG_BY)
+    bool eq; ///< wynik porównania (dla POLY_BATCH_IS_EQ)
+    PolyError error; ///< kod błędu zgłoszonego w trakcie operacji
+} PolyBatchResult;
+
+/**
+ * Wykonuje operacje wsadu na wątkach planisty. Wsad dzielony jest
+ * rekurencyjnie na części o podobnym szacowanym koszcie, które bezczynne
+ * wątki podkradają; duże operacje mogą dodatkowo rozgałęziać się
+ * wewnętrznie. Przy @p s równym NULL operacje wykonywane są po kolei
+ * w wątku wywołującym. Każda operacja zaczyna bez błędu, a jej błąd
+ * zapisywany jest tylko w polu `error` wyniku - kod błędu wątku
+ * wywołującego się nie zmienia.
+ * @param[in] s : planista lub NULL
+ * @param[in] ops : opisy operacji
+ * @param[in] count : liczba operacji
+ * @param[out] results : tablica na @p count wyników
+ */
+void PolyBatchRun(PolySched *s, const PolyBatchOp ops[], size_t count,
+                  PolyBatchResult results[]);
+
+/**
+ * Usuwa z pamięci wielomiany z wyników wsadu.
+ * @param[in] results : wyniki
+ * @param[in] count : liczba wyników
+ */
+void PolyBatchResultsDestroy(PolyBatchResult results[], size_t count);
+
+#endif /* __POLY_BATCH_H__ */
@@ -0,0 +1,749 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "poly.h"
+#include "poly_dist.h"
+
+/** Początkowa liczba miejsc tablicy sum iloczynów (potęga dwójki) */
+#define DIST_TABLE_INITIAL_CAPACITY 1024
+
+/**
+ * Miejsce tablicy z haszowaniem, w której sumowane są iloczyny wyrazów
+ * o tym samym jednomianie.
+ */
+typedef struct DistSlot {
+    uint64_t exps[2]; ///< jednomian
+    poly_ucoeff_t coeff; ///< suma współczynników
+    bool used; ///< czy miejsce jest zajęte
+} DistSlot;
+
+
+
+/**
+ * Zwraca liczbę pól wektora wykładników: pole stopnia dla porządków
+ * stopniowanych i po jednym polu na zmienną.
+ * @param vars : liczba zmiennych
+ * @param order : porządek
+ * @return liczba pól
+ */
+static unsigned DistFields(unsigned vars, PolyOrder order) {
+    return vars + (order != POLY_LEX);
+}
+
+/**
+ * Zwraca liczbę bitów potrzebną do zapisania liczby.
+ * @param v : liczba
+ * @return liczba bitów, co najmniej 1
+ */
+static unsigned BitsFor(uint64_t v) {
+    unsigned bits = 1;
+    while (bits < 64 && (v >> bits) != 0) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * Ustawia wartość pola wektora wykładników.
+ * @param d : wielomian wyznaczający układ pól
+ * @param w : słowa wektora
+ * @param f : indeks pola, 0 to pole najbardziej znaczące
+ * @param v : wartość
+ */
+static void DistSetField(const PolyDist *d, uint64_t *w, unsigned f, uint64_t v) {
+    unsigned per_word = 64 / d->bits;
+    w[f / per_word] |= v << (64 - d->bits * (f % per_word + 1));
+}
+
+/**
+ * Odczytuje wartość pola wektora wykładników.
+ * @param d : wielomian wyznaczający układ pól
+ * @param w : słowa wektora
+ * @param f : indeks pola
+ * @return wartość
+ */
+static uint64_t DistGetField(const PolyDist *d, const uint64_t *w, unsigned f) {
+    unsigned per_word = 64 / d->bits;
+    uint64_t v = w[f / per_word] >> (64 - d->bits * (f % per_word + 1));
+    return (d->bits == 64) ? v : v & ((1ULL << d->bits) - 1);
+}
+
+/**
+ * Zwraca indeks pola zmiennej: po polu stopnia, a dla porządku grevlex
+ * w odwrotnej kolejności zmiennych.
+ * @param d : wielomian wyznaczający układ pól
+ * @param v : indeks zmiennej
+ * @return indeks pola
+ */
+static unsigned DistVarField(const PolyDist *d, unsigned v) {
+    switch (d->order) {
+        case POLY_LEX:
+            return v;
+        case POLY_GRLEX:
+            return v + 1;
+        default:
+            return d->vars - v;
+    }
+}
+
+/**
+ * Ustala układ pól: najmniejszą liczbę słów, w której mieszczą się pola
+ * szerokości @p min_bits, a potem najszersze pola w tej liczbie słów.
+ * @param d : wielomian, któremu ustawiany jest układ
+ * @param vars : liczba zmiennych
+ * @param order : porządek
+ * @param min_bits : najmniejsza szerokość pola
+ * @return Czy pola mieszczą się w dwóch słowach?
+ */
+static bool DistLayout(PolyDist *d, unsigned vars, PolyOrder order,
+                       unsigned min_bits) {
+    unsigned fields = DistFields(vars, order);
+    d->vars = vars;
+    d->order = order;
+    d->mask[0] = d->mask[1] = 0;
+    if (fields == 0) {
+        d->words = 1;
+        d->bits = 64;
+        return true;
+    }
+
+    unsigned per_word = 64 / min_bits;
+    unsigned words = (fields + per_word - 1) / per_word;
+    if (words > 2) {
+        return false;
+    }
+    per_word = (fields + words - 1) / words;
+    d->bits = 64 / per_word;
+    per_word = 64 / d->bits;
+    d->words = (fields + per_word - 1) / per_word;
+
+    if (order == POLY_GREVLEX) {
+        // Większy wykładnik ostatniej różniącej się zmiennej oznacza
+        // mniejszy jednomian, więc pola zmiennych porównujemy zanegowane.
+        uint64_t ones = (d->bits == 64) ? ~0ULL : (1ULL << d->bits) - 1;
+        for (unsigned v = 0; v < vars; v++) {
+            DistSetField(d, d->mask, DistVarField(d, v), ones);
+        }
+    }
+    return true;
+}
+
+/**
+ * Pakuje wektor wykładników.
+ * @param d : wielomian wyznaczający układ pól
+ * @param e : wykładniki zmiennych
+ * @param w : miejsce na `d->words` słów
+ */
+static void DistPack(const PolyDist *d, const poly_exp_t e[], uint64_t *w) {
+    uint64_t deg = 0;
+    w[0] = 0;
+    if (d->words == 2) {
+        w[1] = 0;
+    }
+    for (unsigned v = 0; v < d->vars; v++) {
+        DistSetField(d, w, DistVarField(d, v), (uint64_t) e[v]);
+        deg += (uint64_t) e[v];
+    }
+    if (d->order != POLY_LEX) {
+        DistSetField(d, w, 0, deg);
+    }
+}
+
+/**
+ * Porównuje jednomiany w porządku wielomianu.
+ * @param d : wielomian wyznaczający układ pól i porządek
+ * @param a : jednomian
+ * @param b : jednomian
+ * @return -1, 0 lub 1, gdy @p a jest mniejszy, równy lub większy od @p b
+ */
+static int DistCompare(const PolyDist *d, const uint64_t *a, const uint64_t *b) {
+    for (unsigned w = 0; w < d->words; w++) {
+        uint64_t x = a[w] ^ d->mask[w];
+        uint64_t y = b[w] ^ d->mask[w];
+        if (x != y) {
+            return (x > y) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Przydziela pamięć na wyrazy wielomianu o ustalonym układzie pól.
+ * @param d : wielomian
+ * @param count : liczba wyrazów
+ */
+static void DistAlloc(PolyDist *d, size_t count) {
+    d->count = count;
+    d->coeff_bytes = 1;
+    d->coeffs = calloc(count + 1, d->coeff_bytes);
+    d->exps = (uint64_t *) malloc((count + 1) * d->words * sizeof(uint64_t));
+}
+
+/**
+ * Zwraca najmniejszą szerokość, w której mieści się współczynnik.
+ * @param c : współczynnik
+ * @return szerokość w bajtach
+ */
+static unsigned CoeffBytesFor(poly_coeff_t c) {
+    if (c == (int8_t) c) {
+        return 1;
+    }
+    if (c == (int16_t) c) {
+        return 2;
+    }
+    if (c == (int32_t) c) {
+        return 4;
+    }
+    return 8;
+}
+
+/**
+ * Odczytuje współczynnik z tablicy o danej szerokości.
+ * @param coeffs : tablica współczynników
+ * @param bytes : szerokość współczynnika w bajtach
+ * @param i : indeks
+ * @return współczynnik
+ */
+static inline poly_coeff_t CoeffLoad(const void *coeffs, unsigned bytes, size_t i) {
+    switch (bytes) {
+        case 1:
+            return ((const int8_t *) coeffs)[i];
+        case 2:
+            return ((const int16_t *) coeffs)[i];
+        case 4:
+            return ((const int32_t *) coeffs)[i];
+        default:
+            return ((const int64_t *) coeffs)[i];
+    }
+}
+
+/**
+ * Zapisuje współczynnik do tablicy o danej szerokości, w której się mieści.
+ * @param coeffs : tablica współczynników
+ * @param bytes : szerokość współczynnika w bajtach
+ * @param i : indeks
+ * @param c : współczynnik
+ */
+static inline void CoeffStore(void *coeffs, unsigned bytes, size_t i, poly_coeff_t c) {
+    switch (bytes) {
+        case 1:
+            ((int8_t *) coeffs)[i] = (int8_t) c;
+            break;
+        case 2:
+            ((int16_t *) coeffs)[i] = (int16_t) c;
+            break;
+        case 4:
+            ((int32_t *) coeffs)[i] = (int32_t) c;
+            break;
+        default:
+            ((int64_t *) coeffs)[i] = c;
+    }
+}
+
+/**
+ * Poszerza tablicę współczynników wielomianu.
+ * @param d : wielomian
+ * @param bytes : nowa szerokość, nie mniejsza od obecnej
+ */
+static void DistWidenCoeffs(PolyDist *d, unsigned bytes) {
+    void *wide = malloc((d->count + 1) * bytes);
+    for (size_t i = 0; i < d->count; i++) {
+        CoeffStore(wide, bytes, i, CoeffLoad(d->coeffs, d->coeff_bytes, i));
+    }
+    free(d->coeffs);
+    d->coeffs = wide;
+    d->coeff_bytes = bytes;
+}
+
+/**
+ * Zapisuje współczynnik wyrazu, w razie potrzeby poszerzając tablicę.
+ * @param d : wielomian
+ * @param i : indeks wyrazu
+ * @param c : współczynnik
+ */
+static inline void DistSetCoeff(PolyDist *d, size_t i, poly_coeff_t c) {
+    unsigned bytes = CoeffBytesFor(c);
+    if (bytes > d->coeff_bytes) {
+        DistWidenCoeffs(d, bytes);
+    }
+    CoeffStore(d->coeffs, d->coeff_bytes, i, c);
+}
+
+poly_coeff_t PolyDistCoeff(const PolyDist *d, size_t i) {
+    return CoeffLoad(d->coeffs, d->coeff_bytes, i);
+}
+
+size_t PolyDistBytes(const PolyDist *d) {
+    return d->count * (d->coeff_bytes + d->words * sizeof(uint64_t));
+}
+
+/**
+ * Wylicza stopień wielomianu z jego wyrazów.
+ * @param d : wielomian
+ */
+static void DistUpdateDeg(PolyDist *d) {
+    if (d->count == 0) {
+        d->deg = -1;
+    }
+    else if (d->order != POLY_LEX) {
+        d->deg = (poly_exp_t) DistGetField(d, d->exps, 0);
+    }
+    else {
+        uint64_t deg = 0;
+        for (size_t i = 0; i < d->count; i++) {
+            uint64_t sum = 0;
+            for (unsigned v = 0; v < d->vars; v++) {
+                sum += DistGetField(d, &(d->exps[i * d->words]), v);
+            }
+            deg = (sum > deg) ? sum : deg;
+        }
+        d->deg = (poly_exp_t) deg;
+    }
+}
+
+void PolyDistTermExps(const PolyDist *d, size_t i, poly_exp_t exps[]) {
+    for (unsigned v = 0; v < d->vars; v++) {
+        exps[v] = (poly_exp_t) DistGetField(d, &(d->exps[i * d->words]),
+                                            DistVarField(d, v));
+    }
+}
+
+void PolyDistDestroy(PolyDist *d) {
+    free(d->coeffs);
+    free(d->exps);
+    d->coeffs = NULL;
+    d->exps = NULL;
+    d->count = 0;
+}
+
+/**
+ * Wypisuje wyrazy wielomianu do tablic w malejącym porządku
+ * leksykograficznym. Liczba wyrazów każdego współczynnika jest znana
+ * (PolyTermCount), więc wyrazy rosnącej listy jednomianów trafiają od razu
+ * na swoje miejsca od końca.
+ * @param d : wielomian rozproszony z przydzieloną pamięcią
+ * @param p : wielomian
+ * @param v : indeks zmiennej głównej @p p
+ * @param e : wykładniki zmiennych o mniejszych indeksach, reszta zerowa
+ * @param start : indeks pierwszego wyrazu @p p
+ */
+static void DistEmit(PolyDist *d, const Poly *p, unsigned v, poly_exp_t e[],
+                     size_t start) {
+    size_t end = start + PolyTermCount(p);
+    if (p->coeff != 0) {
+        end--;
+        DistSetCoeff(d, end, p->coeff);
+        DistPack(d, e, &(d->exps[end * d->words]));
+    }
+    if (p->list == NULL) {
+        return;
+    }
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        end -= PolyTermCount(&(l->head->poly));
+        e[v] = l->head->exp;
+        DistEmit(d, &(l->head->poly), v + 1, e, end);
+    }
+    e[v] = 0;
+}
+
+/**
+ * Sortuje stabilnie permutację wyrazów przez scalanie.
+ * @param idx : permutacja indeksów wyrazów
+ * @param n : liczba wyrazów
+ * @param greater : funkcja sprawdzająca, czy pierwszy wyraz ma być
+ * przed drugim
+ * @param ctx : argument funkcji @p greater
+ */
+static void DistMergeSort(size_t *idx, size_t n,
+                          bool (*greater)(const void *, size_t, size_t),
+                          const void *ctx) {
+    size_t *tmp = (size_t *) malloc((n + 1) * sizeof(size_t));
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t mid = (lo + width < n) ? lo + width : n;
+            size_t hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+            size_t a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) {
+                tmp[k++] = greater(ctx, idx[b], idx[a]) ? idx[b++] : idx[a++];
+            }
+            while (a < mid) {
+                tmp[k++] = idx[a++];
+            }
+            while (b < hi) {
+                tmp[k++] = idx[b++];
+            }
+        }
+        memcpy(idx, tmp, n * sizeof(size_t));
+    }
+    free(tmp);
+}
+
+/**
+ * Sprawdza, czy wyraz jest większy od innego w porządku wielomianu.
+ * @param ctx : wielomian
+ * @param i : indeks wyrazu
+ * @param j : indeks wyrazu
+ * @return Czy wyraz @p i jest większy od wyrazu @p j?
+ */
+static bool DistTermIsGreater(const void *ctx, size_t i, size_t j) {
+    const PolyDist *d = (const PolyDist *) ctx;
+    return DistCompare(d, &(d->exps[i * d->words]), &(d->exps[j * d->words])) > 0;
+}
+
+/**
+ * Sortuje wyrazy wielomianu malejąco w jego porządku.
+ * @param d : wielomian
+ */
+static void DistSort(PolyDist *d) {
+    size_t n = d->count;
+    size_t *idx = (size_t *) malloc((n + 1) * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        idx[i] = i;
+    }
+    DistMergeSort(idx, n, DistTermIsGreater, d);
+
+    PolyDist sorted = *d;
+    DistAlloc(&sorted, n);
+    for (size_t i = 0; i < n; i++) {
+        DistSetCoeff(&sorted, i, PolyDistCoeff(d, idx[i]));
+        memcpy(&(sorted.exps[i * d->words]), &(d->exps[idx[i] * d->words]),
+               d->words * sizeof(uint64_t));
+    }
+    PolyDistDestroy(d);
+    *d = sorted;
+    free(idx);
+}
+
+bool PolyDistFromPoly(const Poly *p, unsigned vars, PolyOrder order,
+                      PolyDist *res) {
+    if (PolyDepth(p) > vars) {
+        return false;
+    }
+    poly_exp_t deg = PolyDeg(p);
+    if (!DistLayout(res, vars, order, BitsFor((deg > 0) ? (uint64_t) deg : 0))) {
+        return false;
+    }
+    res->deg = deg;
+    DistAlloc(res, PolyTermCount(p));
+
+    poly_exp_t *e = (poly_exp_t *) calloc(vars + 1, sizeof(poly_exp_t));
+    DistEmit(res, p, 0, e, 0);
+    free(e);
+    if (order != POLY_LEX) {
+        DistSort(res);
+    }
+    return true;
+}
+
+/**
+ * Buduje wielomian z wyrazów posortowanych malejąco leksykograficznie,
+ * które mają równe wykładniki zmiennych o indeksach mniejszych niż @p v.
+ * @param d : wielomian rozproszony
+ * @param idx : permutacja wyrazów
+ * @param e : rozpakowane wykładniki, po `d->vars` na wyraz
+ * @param lo : pierwszy wyraz
+ * @param hi : wyraz za ostatnim
+ * @param v : indeks zmiennej głównej budowanego wielomianu
+ * @return wielomian
+ */
+static Poly DistBuild(const PolyDist *d, const size_t *idx, const poly_exp_t *e,
+                      size_t lo, size_t hi, unsigned v) {
+    if (v == d->vars) {
+        return PolyFromCoeff(PolyDistCoeff(d, idx[lo]));
+    }
+
+    // Grupy o malejącym wykładniku dokładamy na początek listy,
+    // więc lista powstaje od razu posortowana rosnąco.
+    MonoList list = NULL;
+    poly_coeff_t coeff = 0;
+    size_t i = lo;
+    while (i < hi) {
+        poly_exp_t exp = e[idx[i] * d->vars + v];
+        size_t j = i + 1;
+        while (j < hi && e[idx[j] * d->vars + v] == exp) {
+            j++;
+        }
+        Poly sub = DistBuild(d, idx, e, i, j, v + 1);
+        if (exp == 0) {
+            coeff = sub.coeff;
+            sub.coeff = 0;
+        }
+        Mono m = MonoFromPoly(&sub, exp);
+        list = MonoListPrepend(&m, list);
+        i = j;
+    }
+    return (Poly) {.list = list, .coeff = coeff};
+}
+
+/**
+ * Rozpakowane wykładniki wyrazów.
+ */
+typedef struct DistExps {
+    const poly_exp_t *e; ///< wykładniki, po `vars` na wyraz
+    unsigned vars; ///< liczba zmiennych
+} DistExps;
+
+/**
+ * Sprawdza, czy wyraz jest większy od innego w porządku leksykograficznym.
+ * @param ctx : rozpakowane wykładniki (DistExps)
+ * @param i : indeks wyrazu
+ * @param j : indeks wyrazu
+ * @return Czy wyraz @p i jest większy od wyrazu @p j?
+ */
+static bool DistExpsIsGreater(const void *ctx, size_t i, size_t j) {
+    const DistExps *x = (const DistExps *) ctx;
+    for (unsigned v = 0; v < x->vars; v++) {
+        poly_exp_t a = x->e[i * x->vars + v];
+        poly_exp_t b = x->e[j * x->vars + v];
+        if (a != b) {
+            return a > b;
+        }
+    }
+    return false;
+}
+
+Poly PolyDistToPoly(const PolyDist *d) {
+    size_t n = d->count;
+    if (n == 0) {
+        return PolyZero();
+    }
+
+    poly_exp_t *e = (poly_exp_t *) malloc((n * d->vars + 1) * sizeof(poly_exp_t));
+    size_t *idx = (size_t *) malloc(n * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        PolyDistTermExps(d, i, &(e[i * d->vars]));
+        idx[i] = i;
+    }
+    if (d->order != POLY_LEX) {
+        DistExps ctx = {.e = e, .vars = d->vars};
+        DistMergeSort(idx, n, DistExpsIsGreater, &ctx);
+    }
+
+    Poly res = DistBuild(d, idx, e, 0, n, 0);
+    free(idx);
+    free(e);
+    return res;
+}
+
+/**
+ * Kopiuje wielomian, przepakowując wykładniki do układu pól wielomianu
+ * @p layout. Porządek wyrazów się nie zmienia.
+ * @param src : wielomian
+ * @param layout : wielomian wyznaczający układ pól
+ * @param dst : kopia
+ */
+static void DistRepack(const PolyDist *src, const PolyDist *layout, PolyDist *dst) {
+    *dst = *layout;
+    dst->deg = src->deg;
+    DistAlloc(dst, src->count);
+    DistWidenCoeffs(dst, src->coeff_bytes);
+    memcpy(dst->coeffs, src->coeffs, src->count * src->coeff_bytes);
+    poly_exp_t *e = (poly_exp_t *) malloc((src->vars + 1) * sizeof(poly_exp_t));
+    for (size_t i = 0; i < src->count; i++) {
+        PolyDistTermExps(src, i, e);
+        DistPack(dst, e, &(dst->exps[i * dst->words]));
+    }
+    free(e);
+}
+
+/**
+ * Sprowadza dwa zgodne wielomiany do wspólnego układu pól o szerokości
+ * co najmniej @p min_bits. Wielomiany, które już mają ten układ,
+ * nie są kopiowane.
+ * @param p : wielomian
+ * @param q : wielomian
+ * @param min_bits : najmniejsza szerokość pola
+ * @param layout : wspólny układ pól
+ * @param pp : @p p we wspólnym układzie
+ * @param qq : @p q we wspólnym układzie
+ * @param copies : kopie, które trzeba usunąć (najwyżej dwie)
+ * @param copy_count : liczba kopii
+ * @return Czy wielomiany są zgodne i pola mieszczą się w dwóch słowach?
+ */
+static bool DistUnify(const PolyDist *p, const PolyDist *q, unsigned min_bits,
+                      PolyDist *layout, const PolyDist **pp, const PolyDist **qq,
+                      PolyDist copies[2], unsigned *copy_count) {
+    *copy_count = 0;
+    if (p->vars != q->vars || p->order != q->order) {
+        return false;
+    }
+    const PolyDist *wide = (p->bits >= q->bits) ? p : q;
+    if (wide->bits >= min_bits) {
+        *layout = *wide;
+    }
+    else if (!DistLayout(layout, p->vars, p->order, min_bits)) {
+        return false;
+    }
+
+    *pp = p;
+    *qq = q;
+    if (p->bits != layout->bits) {
+        DistRepack(p, layout, &copies[*copy_count]);
+        *pp = &copies[(*copy_count)++];
+    }
+    if (q->bits != layout->bits) {
+        DistRepack(q, layout, &copies[*copy_count]);
+        *qq = &copies[(*copy_count)++];
+    }
+    return true;
+}
+
+bool PolyDistAdd(const PolyDist *p, const PolyDist *q, PolyDist *res) {
+    poly_exp_t deg = (p->deg > q->deg) ? p->deg : q->deg;
+    PolyDist layout, copies[2];
+    const PolyDist *a, *b;
+    unsigned copy_count;
+    if (!DistUnify(p, q, BitsFor((deg > 0) ? (uint64_t) deg : 0), &layout,
+                   &a, &b, copies, &copy_count)) {
+        return false;
+    }
+
+    *res = layout;
+    DistAlloc(res, a->count + b->count);
+    unsigned words = res->words;
+    size_t i = 0, j = 0, n = 0;
+    while (i < a->count || j < b->count) {
+        int cmp;
+        if (i == a->count) {
+            cmp = -1;
+        }
+        else if (j == b->count) {
+            cmp = 1;
+        }
+        else {
+            cmp = DistCompare(res, &(a->exps[i * words]), &(b->exps[j * words]));
+        }
+
+        const uint64_t *exps = (cmp >= 0) ? &(a->exps[i * words]) : &(b->exps[j * words]);
+        poly_ucoeff_t c = 0;
+        if (cmp >= 0) {
+            c += (poly_ucoeff_t) PolyDistCoeff(a, i++);
+        }
+        if (cmp <= 0) {
+            c += (poly_ucoeff_t) PolyDistCoeff(b, j++);
+        }
+        if (c != 0) {
+            DistSetCoeff(res, n, (poly_coeff_t) c);
+            memcpy(&(res->exps[n * words]), exps, words * sizeof(uint64_t));
+            n++;
+        }
+    }
+    res->count = n;
+    DistUpdateDeg(res);
+
+    for (unsigned k = 0; k < copy_count; k++) {
+        PolyDistDestroy(&copies[k]);
+    }
+    return true;
+}
+
+/**
+ * Liczy miejsce jednomianu w tablicy.
+ * @param exps : jednomian (dwa słowa, drugie zerowe dla jednego słowa)
+ * @param mask : liczba miejsc tablicy minus jeden
+ * @return indeks miejsca
+ */
+static inline size_t DistSlotIndex(const uint64_t exps[2], size_t mask) {
+    uint64_t h = exps[0] ^ (exps[1] * 0x9e3779b97f4a7c15ULL);
+    h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdULL;
+    h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+    return (size_t) (h ^ (h >> 33)) & mask;
+}
+
+/**
+ * Dwukrotnie powiększa tablicę sum iloczynów.
+ * @param table : tablica
+ * @param capacity : liczba miejsc
+ */
+static void DistTableGrow(DistSlot **table, size_t *capacity) {
+    size_t new_capacity = 2 * *capacity;
+    DistSlot *slots = (DistSlot *) calloc(new_capacity, sizeof(DistSlot));
+    for (size_t k = 0; k < *capacity; k++) {
+        if ((*table)[k].used) {
+            size_t i = DistSlotIndex((*table)[k].exps, new_capacity - 1);
+            while (slots[i].used) {
+                i = (i + 1) & (new_capacity - 1);
+            }
+            slots[i] = (*table)[k];
+        }
+    }
+    free(*table);
+    *table = slots;
+    *capacity = new_capacity;
+}
+
+bool PolyDistMul(const PolyDist *p, const PolyDist *q, PolyDist *res) {
+    if (p->count == 0 || q->count == 0) {
+        if (p->vars != q->vars || p->order != q->order) {
+            return false;
+        }
+        *res = (p->count == 0) ? *p : *q;
+        DistAlloc(res, 0);
+        res->deg = -1;
+        return true;
+    }
+    if ((long long) p->deg + q->deg > INT_MAX) {
+        return false;
+    }
+    PolyDist layout, copies[2];
+    const PolyDist *a, *b;
+    unsigned copy_count;
+    if (!DistUnify(p, q, BitsFor((uint64_t) (p->deg + q->deg)), &layout,
+                   &a, &b, copies, &copy_count)) {
+        return false;
+    }
+
+    // Iloczyny sumujemy w tablicy z haszowaniem, a na końcu sortujemy tylko
+    // wyrazy wyniku - jeden krok na iloczyn zamiast logarytmicznej liczby
+    // porównań przy scalaniu kopcem.
+    unsigned words = layout.words;
+    size_t capacity = DIST_TABLE_INITIAL_CAPACITY;
+    size_t used = 0;
+    DistSlot *table = (DistSlot *) calloc(capacity, sizeof(DistSlot));
+    poly_ucoeff_t *cb = (poly_ucoeff_t *) malloc(b->count * sizeof(poly_ucoeff_t));
+    for (size_t j = 0; j < b->count; j++) {
+        cb[j] = (poly_ucoeff_t) PolyDistCoeff(b, j);
+    }
+    for (size_t i = 0; i < a->count; i++) {
+        const uint64_t *ea = &(a->exps[i * words]);
+        poly_ucoeff_t ca = (poly_ucoeff_t) PolyDistCoeff(a, i);
+        for (size_t j = 0; j < b->count; j++) {
+            const uint64_t *eb = &(b->exps[j * words]);
+            uint64_t exps[2] = {ea[0] + eb[0], (words == 2) ? ea[1] + eb[1] : 0};
+            size_t k = DistSlotIndex(exps, capacity - 1);
+            while (table[k].used
+                   && (table[k].exps[0] != exps[0] || table[k].exps[1] != exps[1])) {
+                k = (k + 1) & (capacity - 1);
+            }
+            if (!table[k].used) {
+                table[k] = (DistSlot) {.exps = {exps[0], exps[1]}, .coeff = 0, .used = true};
+                used++;
+            }
+            table[k].coeff += ca * cb[j];
+            if (2 * used > capacity) {
+                DistTableGrow(&table, &capacity);
+            }
+        }
+    }
+
+    *res = layout;
+    DistAlloc(res, used);
+    size_t n = 0;
+    for (size_t k = 0; k < capacity; k++) {
+        if (table[k].used && table[k].coeff != 0) {
+            DistSetCoeff(res, n, (poly_coeff_t) table[k].coeff);
+            memcpy(&(res->exps[n * words]), table[k].exps, words * sizeof(uint64_t));
+            n++;
+        }
+    }
+    free(table);
+    free(cb);
+    res->count = n;
+    DistSort(res);
+    DistUpdateDeg(res);
+
+    for (unsigned k = 0; k < copy_count; k++) {
+        PolyDistDestroy(&copies[k]);
+    }
+    return true;
+}
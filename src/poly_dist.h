@@ -0,0 +1,126 @@
+/** @file
+   Interfejs rozproszonej reprezentacji wielomianów
+
+   Wielomian rozproszony to tablica wyrazów posortowana malejąco według
+   wybranego porządku jednomianów. Wyraz składa się ze współczynnika
+   i wektora wykładników zmiennych @f$x_0, \ldots, x_{n-1}@f$ spakowanego
+   w jedno lub dwa słowa 64-bitowe. Pola mają jednakową szerokość i są
+   ułożone tak, że porównanie jednomianów jest porównaniem słów bez znaku
+   (dla porządku grevlex po zanegowaniu pól zmiennych maską), a mnożenie
+   jednomianów - dodawaniem słów.
+
+   Współczynniki przechowywane są w tablicy liczb o szerokości 1, 2, 4 lub
+   8 bajtów, wspólnej dla całego wielomianu i najmniejszej, w której
+   mieszczą się wszystkie zapisane dotąd współczynniki. Zapisanie
+   współczynnika, który się nie mieści, poszerza całą tablicę.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_DIST_H__
+#define __POLY_DIST_H__
+
+#include <stdint.h>
+#include "poly.h"
+
+/**
+ * Porządek jednomianów.
+ */
+typedef enum PolyOrder {
+    POLY_LEX, ///< leksykograficzny, @f$x_0 > x_1 > \ldots@f$
+    POLY_GRLEX, ///< najpierw stopień, potem leksykograficzny
+    POLY_GREVLEX ///< najpierw stopień, potem odwrotny leksykograficzny
+} PolyOrder;
+
+/**
+ * Wielomian w reprezentacji rozproszonej.
+ * Wyrazy mają niezerowe współczynniki i różne jednomiany.
+ */
+typedef struct PolyDist {
+    void *coeffs; ///< współczynniki wyrazów, po `coeff_bytes` bajtów
+    uint64_t *exps; ///< wykładniki wyrazów, po `words` słów na wyraz
+    size_t count; ///< liczba wyrazów
+    poly_exp_t deg; ///< stopień (-1 dla wielomianu zerowego)
+    unsigned vars; ///< liczba zmiennych
+    unsigned bits; ///< szerokość pola wykładnika w bitach
+    unsigned words; ///< liczba słów wektora wykładników (1 lub 2)
+    unsigned coeff_bytes; ///< szerokość współczynnika w bajtach (1, 2, 4 lub 8)
+    PolyOrder order; ///< porządek jednomianów
+    uint64_t mask[2]; ///< maska nakładana na słowa przed porównaniem
+} PolyDist;
+
+/**
+ * Zamienia wielomian na reprezentację rozproszoną. Szerokość pól dobierana
+ * jest tak, żeby pomieścić stopień wielomianu, i zwiększana w ramach
+ * wybranej liczby słów, żeby zostawić zapas na mnożenie.
+ * @param[in] p : wielomian
+ * @param[in] vars : liczba zmiennych, co najmniej `PolyDepth(p)`
+ * @param[in] order : porządek jednomianów
+ * @param[out] res : wielomian rozproszony
+ * @return Czy się udało? Fałsz, gdy wykładniki nie mieszczą się w dwóch
+ * słowach lub gdy @p vars jest mniejsze niż `PolyDepth(p)`.
+ */
+bool PolyDistFromPoly(const Poly *p, unsigned vars, PolyOrder order,
+                      PolyDist *res);
+
+/**
+ * Zamienia wielomian rozproszony na wielomian.
+ * @param[in] d : wielomian rozproszony
+ * @return wielomian
+ */
+Poly PolyDistToPoly(const PolyDist *d);
+
+/**
+ * Usuwa wielomian rozproszony z pamięci.
+ * @param[in] d : wielomian rozproszony
+ */
+void PolyDistDestroy(PolyDist *d);
+
+/**
+ * Zwraca współczynnik wyrazu.
+ * @param[in] d : wielomian rozproszony
+ * @param[in] i : indeks wyrazu
+ * @return współczynnik
+ */
+poly_coeff_t PolyDistCoeff(const PolyDist *d, size_t i);
+
+/**
+ * Zwraca liczbę bajtów zajmowanych przez wyrazy wielomianu.
+ * @param[in] d : wielomian rozproszony
+ * @return liczba bajtów współczynników i wykładników
+ */
+size_t PolyDistBytes(const PolyDist *d);
+
+/**
+ * Rozpakowuje wykładniki wyrazu.
+ * @param[in] d : wielomian rozproszony
+ * @param[in] i : indeks wyrazu
+ * @param[out] exps : tablica na `d->vars` wykładników
+ */
+void PolyDistTermExps(const PolyDist *d, size_t i, poly_exp_t exps[]);
+
+/**
+ * Dodaje dwa wielomiany rozproszone o tej samej liczbie zmiennych
+ * i tym samym porządku.
+ * @param[in] p : wielomian rozproszony
+ * @param[in] q : wielomian rozproszony
+ * @param[out] res : `p + q`
+ * @return Czy się udało? Fałsz, gdy wielomiany są niezgodne.
+ */
+bool PolyDistAdd(const PolyDist *p, const PolyDist *q, PolyDist *res);
+
+/**
+ * Mnoży dwa wielomiany rozproszone o tej samej liczbie zmiennych
+ * i tym samym porządku. Iloczyny wyrazów sumowane są w tablicy
+ * z haszowaniem po spakowanym jednomianie, a sortowane są tylko wyrazy
+ * wyniku. Jeśli iloczyn wymaga szerszych pól, czynniki są przepakowywane.
+ * @param[in] p : wielomian rozproszony
+ * @param[in] q : wielomian rozproszony
+ * @param[out] res : `p * q`
+ * @return Czy się udało? Fałsz, gdy wielomiany są niezgodne lub
+ * wykładniki iloczynu nie mieszczą się w dwóch słowach.
+ */
+bool PolyDistMul(const PolyDist *p, const PolyDist *q, PolyDist *res);
+
+#endif /* __POLY_DIST_H__ */
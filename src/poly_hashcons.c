@@ -0,0 +1,157 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "poly.h"
+#include "poly_hashcons.h"
+
+/** Początkowa liczba miejsc w tablicy (potęga dwójki) */
+#define TABLE_INITIAL_CAPACITY 64
+
+/**
+ * Tablica unikalnych wielomianów - tablica z haszowaniem otwartym
+ * i liniowym szukaniem wolnego miejsca. Elementy pamiętane są też
+ * w kolejności tworzenia, w której każdy element występuje po elementach,
+ * do których się odwołuje.
+ */
+struct PolyTable {
+    MonoList *nodes; ///< elementy w kolejności tworzenia
+    uint64_t *hashes; ///< skróty elementów
+    size_t *slots; ///< miejsca tablicy: indeks elementu + 1 lub 0
+    size_t capacity; ///< liczba miejsc
+    size_t size; ///< liczba elementów
+};
+
+/**
+ * Liczy skrót elementu listy. Współczynnik i ogon są już internowane,
+ * więc wystarczy wziąć pod uwagę ich adresy.
+ * @param exp : wykładnik
+ * @param poly : internowany współczynnik
+ * @param tail : internowany ogon
+ * @return skrót
+ */
+static uint64_t InternHash(poly_exp_t exp, const Poly *poly, MonoList tail) {
+    uint64_t h = PolyHashMix(0, (uint64_t) exp);
+    h = PolyHashMix(h, (uint64_t) poly->coeff);
+    h = PolyHashMix(h, (uint64_t) (uintptr_t) poly->list);
+    return PolyHashMix(h, (uint64_t) (uintptr_t) tail);
+}
+
+PolyTable *PolyTableNew() {
+    PolyTable *t = (PolyTable *) malloc(sizeof(struct PolyTable));
+    t->capacity = TABLE_INITIAL_CAPACITY;
+    t->size = 0;
+    t->slots = (size_t *) calloc(t->capacity, sizeof(size_t));
+    t->nodes = (MonoList *) malloc(t->capacity / 2 * sizeof(MonoList));
+    t->hashes = (uint64_t *) malloc(t->capacity / 2 * sizeof(uint64_t));
+    return t;
+}
+
+void PolyTableDestroy(PolyTable *t) {
+    if (t == NULL) {
+        return;
+    }
+    // Od najnowszych: element zwalniany przez tablicę nie ma już odwołań
+    // z elementów tablicy, do których tablica jeszcze się odwołuje.
+    for (size_t i = t->size; i-- > 0; ) {
+        Poly p = {.list = t->nodes[i], .coeff = 0};
+        PolyDestroy(&p);
+    }
+    free(t->hashes);
+    free(t->nodes);
+    free(t->slots);
+    free(t);
+}
+
+size_t PolyTableSize(const PolyTable *t) {
+    return t->size;
+}
+
+/**
+ * Dwukrotnie powiększa tablicę.
+ * @param t : tablica
+ */
+static void PolyTableGrow(PolyTable *t) {
+    size_t capacity = 2 * t->capacity;
+    size_t *slots = (size_t *) calloc(capacity, sizeof(size_t));
+    for (size_t k = 0; k < t->size; k++) {
+        size_t j = t->hashes[k] & (capacity - 1);
+        while (slots[j] != 0) {
+            j = (j + 1) & (capacity - 1);
+        }
+        slots[j] = k + 1;
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->capacity = capacity;
+    t->nodes = (MonoList *) realloc(t->nodes, capacity / 2 * sizeof(MonoList));
+    t->hashes = (uint64_t *) realloc(t->hashes, capacity / 2 * sizeof(uint64_t));
+}
+
+/**
+ * Zwraca element listy tablicy o zadanych polach, tworząc go w razie
+ * potrzeby. Tablica trzyma jedno odwołanie do każdego swojego elementu.
+ * @param t : tablica
+ * @param exp : wykładnik
+ * @param poly : internowany współczynnik
+ * @param tail : internowany ogon
+ * @return element tablicy
+ */
+static MonoList InternElem(PolyTable *t, poly_exp_t exp, const Poly *poly,
+                           MonoList tail) {
+    uint64_t hash = InternHash(exp, poly, tail);
+    size_t i = hash & (t->capacity - 1);
+    while (t->slots[i] != 0) {
+        size_t k = t->slots[i] - 1;
+        MonoList node = t->nodes[k];
+        if (t->hashes[k] == hash && node->head->exp == exp
+            && node->head->poly.coeff == poly->coeff
+            && node->head->poly.list == poly->list && node->tail == tail) {
+            return node;
+        }
+        i = (i + 1) & (t->capacity - 1);
+    }
+
+    // Element odwołuje się do współczynnika i ogona.
+    Poly poly_ref = PolyClone(poly);
+    Poly tail_ref = {.list = tail, .coeff = 0};
+    tail_ref = PolyClone(&tail_ref);
+    Mono m = MonoFromPoly(&poly_ref, exp);
+    MonoList node = MonoListPrepend(&m, tail_ref.list);
+
+    t->nodes[t->size] = node;
+    t->hashes[t->size] = hash;
+    t->slots[i] = ++t->size;
+    if (2 * t->size >= t->capacity) {
+        PolyTableGrow(t);
+    }
+    return node;
+}
+
+Poly PolyIntern(PolyTable *t, const Poly *p) {
+    size_t len = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        len++;
+    }
+    if (len == 0) {
+        return PolyFromCoeff(p->coeff);
+    }
+
+    // Listę internujemy od końca, bo element zależy od internowanego ogona.
+    const Mono **heads = (const Mono **) malloc(len * sizeof(Mono *));
+    size_t i = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        heads[i++] = l->head;
+    }
+
+    MonoList list = NULL;
+    while (i-- > 0) {
+        Poly poly = PolyIntern(t, &(heads[i]->poly));
+        list = InternElem(t, heads[i]->exp, &poly, list);
+    }
+    free(heads);
+
+    return (Poly) {.list = list, .coeff = p->coeff};
+}
+
+bool PolyInternedIsEq(const Poly *p, const Poly *q) {
+    return p->coeff == q->coeff && p->list == q->list;
+}
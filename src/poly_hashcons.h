@@ -0,0 +1,68 @@
+/** @file
+   Interfejs tablicy unikalnych wielomianów (hash-consing)
+
+   Wielomian umieszczony w tablicy (internowany) jest niezmienny i składa
+   się wyłącznie z elementów list należących do tablicy. Każda różna
+   struktura (lista jednomianów wraz z ogonem i współczynnikami) występuje
+   w tablicy dokładnie raz, więc równe wielomiany internowane w tej samej
+   tablicy mają tę samą listę, a pamięć rośnie z liczbą różnych
+   podwielomianów, a nie z rozmiarem wyrażeń.
+
+   Internowane wielomiany można przekazywać do wszystkich operacji z poly.h
+   przyjmujących `const Poly *`. Nie wolno ich usuwać funkcją PolyDestroy -
+   odwołania do nich należą do tablicy i zwalnia je PolyTableDestroy.
+   Kopia zrobiona funkcją PolyClone jest zwykłym wielomianem współdzielącym
+   elementy z tablicą i może istnieć dłużej niż tablica.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_HASHCONS_H__
+#define __POLY_HASHCONS_H__
+
+#include "poly.h"
+
+/**
+ * Tablica unikalnych wielomianów.
+ */
+typedef struct PolyTable PolyTable;
+
+/**
+ * Tworzy pustą tablicę unikalnych wielomianów.
+ * @return tablica
+ */
+PolyTable *PolyTableNew();
+
+/**
+ * Usuwa tablicę wraz ze wszystkimi internowanymi wielomianami.
+ * @param[in] t : tablica
+ */
+void PolyTableDestroy(PolyTable *t);
+
+/**
+ * Zwraca liczbę elementów list przechowywanych w tablicy.
+ * @param[in] t : tablica
+ * @return liczba różnych elementów list
+ */
+size_t PolyTableSize(const PolyTable *t);
+
+/**
+ * Zwraca wielomian równy @p p, którego wszystkie elementy list należą do
+ * tablicy @p t. Wielomian @p p może być dowolny (także internowany).
+ * @param[in] t : tablica
+ * @param[in] p : wielomian
+ * @return internowany wielomian równy @p p
+ */
+Poly PolyIntern(PolyTable *t, const Poly *p);
+
+/**
+ * Sprawdza równość dwóch wielomianów internowanych w tej samej tablicy
+ * w czasie stałym.
+ * @param[in] p : internowany wielomian
+ * @param[in] q : internowany wielomian
+ * @return `p = q`
+ */
+bool PolyInternedIsEq(const Poly *p, const Poly *q);
+
+#endif /* __POLY_HASHCONS_H__ */
@@ -0,0 +1,195 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "poly.h"
+#include "poly_map.h"
+
+/** Początkowa liczba miejsc w tablicy (potęga dwójki) */
+#define MAP_INITIAL_CAPACITY 16
+
+/**
+ * Miejsce w tablicy słownika.
+ */
+typedef struct MapSlot {
+    Poly key; ///< klucz
+    Poly value; ///< wartość
+    uint64_t hash; ///< skrót klucza
+    bool used; ///< czy miejsce jest zajęte
+} MapSlot;
+
+/**
+ * Słownik - tablica z haszowaniem otwartym i liniowym szukaniem wolnego
+ * miejsca, zapełniona co najwyżej w połowie.
+ */
+struct PolyMap {
+    MapSlot *slots; ///< miejsca
+    size_t capacity; ///< liczba miejsc
+    size_t size; ///< liczba kluczy
+};
+
+/**
+ * Zbiór - słownik, w którym wszystkie wartości są zerowe.
+ */
+struct PolySet {
+    PolyMap map; ///< słownik elementów
+};
+
+/**
+ * Inicjuje pusty słownik.
+ * @param m : słownik
+ */
+static void PolyMapInit(PolyMap *m) {
+    m->capacity = MAP_INITIAL_CAPACITY;
+    m->size = 0;
+    m->slots = (MapSlot *) calloc(m->capacity, sizeof(MapSlot));
+}
+
+/**
+ * Zwalnia zawartość słownika.
+ * @param m : słownik
+ */
+static void PolyMapClear(PolyMap *m) {
+    for (size_t i = 0; i < m->capacity; i++) {
+        if (m->slots[i].used) {
+            PolyDestroy(&(m->slots[i].key));
+            PolyDestroy(&(m->slots[i].value));
+        }
+    }
+    free(m->slots);
+}
+
+PolyMap *PolyMapNew() {
+    PolyMap *m = (PolyMap *) malloc(sizeof(struct PolyMap));
+    PolyMapInit(m);
+    return m;
+}
+
+void PolyMapDestroy(PolyMap *m) {
+    if (m == NULL) {
+        return;
+    }
+    PolyMapClear(m);
+    free(m);
+}
+
+size_t PolyMapSize(const PolyMap *m) {
+    return m->size;
+}
+
+/**
+ * Szuka miejsca klucza. Skróty porównywane są przed wielomianami, więc
+ * różne klucze odrzucane są zwykle w czasie stałym.
+ * @param m : słownik
+ * @param key : klucz
+ * @param hash : skrót klucza
+ * @return indeks miejsca z kluczem lub pierwszego wolnego miejsca
+ */
+static size_t PolyMapFind(const PolyMap *m, const Poly *key, uint64_t hash) {
+    size_t i = hash & (m->capacity - 1);
+    while (m->slots[i].used
+           && (m->slots[i].hash != hash || !PolyIsEq(&(m->slots[i].key), key))) {
+        i = (i + 1) & (m->capacity - 1);
+    }
+    return i;
+}
+
+/**
+ * Dwukrotnie powiększa tablicę słownika.
+ * @param m : słownik
+ */
+static void PolyMapGrow(PolyMap *m) {
+    MapSlot *old = m->slots;
+    size_t old_capacity = m->capacity;
+    m->capacity *= 2;
+    m->slots = (MapSlot *) calloc(m->capacity, sizeof(MapSlot));
+    for (size_t k = 0; k < old_capacity; k++) {
+        if (old[k].used) {
+            size_t i = old[k].hash & (m->capacity - 1);
+            while (m->slots[i].used) {
+                i = (i + 1) & (m->capacity - 1);
+            }
+            m->slots[i] = old[k];
+        }
+    }
+    free(old);
+}
+
+bool PolyMapPut(PolyMap *m, const Poly *key, const Poly *value) {
+    uint64_t hash = PolyHash(key);
+    size_t i = PolyMapFind(m, key, hash);
+    MapSlot *slot = &(m->slots[i]);
+    if (slot->used) {
+        PolyDestroy(&(slot->value));
+        slot->value = PolyClone(value);
+        return false;
+    }
+
+    slot->key = PolyClone(key);
+    slot->value = PolyClone(value);
+    slot->hash = hash;
+    slot->used = true;
+    if (2 * ++m->size >= m->capacity) {
+        PolyMapGrow(m);
+    }
+    return true;
+}
+
+const Poly *PolyMapGet(const PolyMap *m, const Poly *key) {
+    size_t i = PolyMapFind(m, key, PolyHash(key));
+    return m->slots[i].used ? &(m->slots[i].value) : NULL;
+}
+
+bool PolyMapRemove(PolyMap *m, const Poly *key) {
+    size_t i = PolyMapFind(m, key, PolyHash(key));
+    if (!m->slots[i].used) {
+        return false;
+    }
+    PolyDestroy(&(m->slots[i].key));
+    PolyDestroy(&(m->slots[i].value));
+    m->slots[i].used = false;
+    m->size--;
+
+    // Przesuwamy wstecz klucze z tego samego ciągu zajętych miejsc,
+    // które bez tego przestałyby być osiągalne.
+    size_t mask = m->capacity - 1;
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; m->slots[j].used; j = (j + 1) & mask) {
+        size_t home = m->slots[j].hash & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            m->slots[hole] = m->slots[j];
+            m->slots[j].used = false;
+            hole = j;
+        }
+    }
+    return true;
+}
+
+PolySet *PolySetNew() {
+    PolySet *s = (PolySet *) malloc(sizeof(struct PolySet));
+    PolyMapInit(&(s->map));
+    return s;
+}
+
+void PolySetDestroy(PolySet *s) {
+    if (s == NULL) {
+        return;
+    }
+    PolyMapClear(&(s->map));
+    free(s);
+}
+
+size_t PolySetSize(const PolySet *s) {
+    return s->map.size;
+}
+
+bool PolySetAdd(PolySet *s, const Poly *p) {
+    Poly zero = PolyZero();
+    return PolyMapPut(&(s->map), p, &zero);
+}
+
+bool PolySetContains(const PolySet *s, const Poly *p) {
+    return PolyMapGet(&(s->map), p) != NULL;
+}
+
+bool PolySetRemove(PolySet *s, const Poly *p) {
+    return PolyMapRemove(&(s->map), p);
+}
@@ -0,0 +1,116 @@
+/** @file
+   Interfejs słownika i zbioru wielomianów
+
+   Kluczami są wielomiany porównywane według wartości (PolyIsEq), a miejsce
+   w tablicy wyznacza ich skrót PolyHash, liczony w czasie stałym.
+   Kontenery przechowują kopie kluczy i wartości zrobione funkcją PolyClone,
+   więc wstawienie nie odbiera wielomianu wywołującemu.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_MAP_H__
+#define __POLY_MAP_H__
+
+#include "poly.h"
+
+/**
+ * Słownik odwzorowujący wielomiany na wielomiany.
+ */
+typedef struct PolyMap PolyMap;
+
+/**
+ * Zbiór wielomianów.
+ */
+typedef struct PolySet PolySet;
+
+/**
+ * Tworzy pusty słownik.
+ * @return słownik
+ */
+PolyMap *PolyMapNew();
+
+/**
+ * Usuwa słownik wraz z kluczami i wartościami.
+ * @param[in] m : słownik
+ */
+void PolyMapDestroy(PolyMap *m);
+
+/**
+ * Zwraca liczbę kluczy w słowniku.
+ * @param[in] m : słownik
+ * @return liczba kluczy
+ */
+size_t PolyMapSize(const PolyMap *m);
+
+/**
+ * Przypisuje kluczowi @p key wartość @p value, zastępując poprzednią.
+ * @param[in] m : słownik
+ * @param[in] key : klucz
+ * @param[in] value : wartość
+ * @return Czy klucza nie było wcześniej w słowniku?
+ */
+bool PolyMapPut(PolyMap *m, const Poly *key, const Poly *value);
+
+/**
+ * Zwraca wartość przypisaną kluczowi. Wskaźnik jest ważny do najbliższej
+ * zmiany słownika.
+ * @param[in] m : słownik
+ * @param[in] key : klucz
+ * @return wartość lub NULL, jeśli klucza nie ma w słowniku
+ */
+const Poly *PolyMapGet(const PolyMap *m, const Poly *key);
+
+/**
+ * Usuwa klucz wraz z jego wartością.
+ * @param[in] m : słownik
+ * @param[in] key : klucz
+ * @return Czy klucz był w słowniku?
+ */
+bool PolyMapRemove(PolyMap *m, const Poly *key);
+
+/**
+ * Tworzy pusty zbiór.
+ * @return zbiór
+ */
+PolySet *PolySetNew();
+
+/**
+ * Usuwa zbiór wraz z elementami.
+ * @param[in] s : zbiór
+ */
+void PolySetDestroy(PolySet *s);
+
+/**
+ * Zwraca liczbę elementów zbioru.
+ * @param[in] s : zbiór
+ * @return liczba elementów
+ */
+size_t PolySetSize(const PolySet *s);
+
+/**
+ * Dodaje wielomian do zbioru.
+ * @param[in] s : zbiór
+ * @param[in] p : wielomian
+ * @return Czy wielomianu nie było wcześniej w zbiorze?
+ */
+bool PolySetAdd(PolySet *s, const Poly *p);
+
+/**
+ * Sprawdza, czy wielomian należy do zbioru.
+ * @param[in] s : zbiór
+ * @param[in] p : wielomian
+ * @return `p` należy do zbioru
+ */
+bool PolySetContains(const PolySet *s, const Poly *p);
+
+/**
+ * Usuwa wielomian ze zbioru.
+ * @param[in] s : zbiór
+ * @param[in] p : wielomian
+ * @return Czy wielomian był w zbiorze?
+ */
+bool PolySetRemove(PolySet *s, const Poly *p);
+
+#endif /* __POLY_MAP_H__ */
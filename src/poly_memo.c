@@ -0,0 +1,320 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "poly.h"
+#include "poly_memo.h"
+
+/** Początkowa liczba kubełków (potęga dwójki) */
+#define MEMO_INITIAL_BUCKETS 64
+
+/** Szacowany rozmiar jednego elementu listy w bajtach */
+#define MEMO_ELEM_BYTES (sizeof(struct MonoElem) + sizeof(struct Mono))
+
+/**
+ * Operacja, której wynik jest zapamiętany.
+ */
+typedef enum MemoOp {
+    MEMO_ADD, ///< dodawanie
+    MEMO_MUL, ///< mnożenie
+    MEMO_AT ///< wyliczanie wartości
+} MemoOp;
+
+/**
+ * Wpis pamięci podręcznej.
+ */
+typedef struct MemoEntry {
+    Poly p; ///< pierwszy argument
+    Poly q; ///< drugi argument (dla MEMO_AT wielomian zerowy)
+    poly_coeff_t x; ///< punkt (tylko dla MEMO_AT)
+    Poly result; ///< wynik
+    uint64_t hash; ///< skrót argumentów
+    size_t bytes; ///< szacowany rozmiar wpisu
+    size_t next; ///< następny wpis w kubełku lub wolny wpis: indeks + 1 lub 0
+    MemoOp op; ///< operacja
+    bool used; ///< czy wpis jest zajęty
+    bool referenced; ///< bit użycia algorytmu zegarowego
+} MemoEntry;
+
+/**
+ * Pamięć podręczna - tablica wpisów z listą wolnych wpisów i tablica
+ * z haszowaniem łańcuchowym przechowująca ich indeksy.
+ */
+struct PolyMemo {
+    MemoEntry *entries; ///< wpisy
+    size_t capacity; ///< rozmiar tablicy wpisów
+    size_t end; ///< liczba kiedykolwiek użytych wpisów
+    size_t free; ///< pierwszy wolny wpis: indeks + 1 lub 0
+    size_t *buckets; ///< kubełki: indeks pierwszego wpisu + 1 lub 0
+    size_t bucket_count; ///< liczba kubełków
+    size_t hand; ///< wskazówka zegara
+    size_t max_bytes; ///< ograniczenie rozmiaru wpisów
+    PolyMemoStats stats; ///< statystyki
+};
+
+/**
+ * Pamięć podręczna mnożenia wykonywanego w bieżącym wątku przez
+ * PolyMemoMul lub NULL. Korzystają z niej iloczyny współczynników
+ * w rekurencji PolyMul (PolyMemoMulNested).
+ */
+static _Thread_local PolyMemo *memo_context;
+
+PolyMemo *PolyMemoNew(size_t max_bytes) {
+    PolyMemo *m = (PolyMemo *) malloc(sizeof(struct PolyMemo));
+    m->capacity = MEMO_INITIAL_BUCKETS;
+    m->entries = (MemoEntry *) malloc(m->capacity * sizeof(MemoEntry));
+    m->end = 0;
+    m->free = 0;
+    m->bucket_count = MEMO_INITIAL_BUCKETS;
+    m->buckets = (size_t *) calloc(m->bucket_count, sizeof(size_t));
+    m->hand = 0;
+    m->max_bytes = max_bytes;
+    memset(&(m->stats), 0, sizeof(PolyMemoStats));
+    return m;
+}
+
+/**
+ * Zwalnia wielomiany wpisu.
+ * @param e : wpis
+ */
+static void MemoEntryDestroy(MemoEntry *e) {
+    PolyDestroy(&(e->p));
+    PolyDestroy(&(e->q));
+    PolyDestroy(&(e->result));
+    e->used = false;
+}
+
+void PolyMemoFlush(PolyMemo *m) {
+    for (size_t k = 0; k < m->end; k++) {
+        if (m->entries[k].used) {
+            MemoEntryDestroy(&(m->entries[k]));
+        }
+    }
+    memset(m->buckets, 0, m->bucket_count * sizeof(size_t));
+    m->end = 0;
+    m->free = 0;
+    m->hand = 0;
+    m->stats.entries = 0;
+    m->stats.bytes = 0;
+}
+
+void PolyMemoDestroy(PolyMemo *m) {
+    if (m == NULL) {
+        return;
+    }
+    PolyMemoFlush(m);
+    free(m->buckets);
+    free(m->entries);
+    free(m);
+}
+
+PolyMemoStats PolyMemoGetStats(const PolyMemo *m) {
+    return m->stats;
+}
+
+/**
+ * Usuwa wpis z kubełka i dołącza go do wolnych wpisów.
+ * @param m : pamięć podręczna
+ * @param k : indeks wpisu
+ */
+static void MemoRemove(PolyMemo *m, size_t k) {
+    MemoEntry *e = &(m->entries[k]);
+    size_t *link = &(m->buckets[e->hash & (m->bucket_count - 1)]);
+    while (*link != k + 1) {
+        link = &(m->entries[*link - 1].next);
+    }
+    *link = e->next;
+
+    m->stats.entries--;
+    m->stats.bytes -= e->bytes;
+    MemoEntryDestroy(e);
+    e->next = m->free;
+    m->free = k + 1;
+}
+
+/**
+ * Usuwa wpisy algorytmem zegarowym, dopóki nowy wpis się nie zmieści:
+ * wpis z ustawionym bitem użycia dostaje drugą szansę.
+ * @param m : pamięć podręczna
+ * @param bytes : rozmiar nowego wpisu
+ */
+static void MemoEvict(PolyMemo *m, size_t bytes) {
+    while (m->stats.entries > 0 && m->stats.bytes + bytes > m->max_bytes) {
+        if (m->hand >= m->end) {
+            m->hand = 0;
+        }
+        MemoEntry *e = &(m->entries[m->hand]);
+        if (e->used && e->referenced) {
+            e->referenced = false;
+        }
+        else if (e->used) {
+            MemoRemove(m, m->hand);
+            m->stats.evictions++;
+        }
+        m->hand++;
+    }
+}
+
+/**
+ * Dwukrotnie zwiększa liczbę kubełków.
+ * @param m : pamięć podręczna
+ */
+static void MemoGrowBuckets(PolyMemo *m) {
+    m->bucket_count *= 2;
+    free(m->buckets);
+    m->buckets = (size_t *) calloc(m->bucket_count, sizeof(size_t));
+    for (size_t k = 0; k < m->end; k++) {
+        MemoEntry *e = &(m->entries[k]);
+        if (e->used) {
+            size_t b = e->hash & (m->bucket_count - 1);
+            e->next = m->buckets[b];
+            m->buckets[b] = k + 1;
+        }
+    }
+}
+
+/**
+ * Szuka wpisu o zadanych argumentach.
+ * @param m : pamięć podręczna
+ * @param hash : skrót argumentów
+ * @param op : operacja
+ * @param p : pierwszy argument
+ * @param q : drugi argument lub NULL
+ * @param x : punkt
+ * @return wpis lub NULL
+ */
+static MemoEntry *MemoFind(PolyMemo *m, uint64_t hash, MemoOp op,
+                           const Poly *p, const Poly *q, poly_coeff_t x) {
+    size_t k = m->buckets[hash & (m->bucket_count - 1)];
+    while (k != 0) {
+        MemoEntry *e = &(m->entries[k - 1]);
+        if (e->hash == hash && e->op == op && e->x == x
+            && PolyIsEq(&(e->p), p)
+            && (q == NULL || PolyIsEq(&(e->q), q))) {
+            return e;
+        }
+        k = e->next;
+    }
+    return NULL;
+}
+
+/**
+ * Dodaje wpis. Pamięć podręczna przejmuje na własność wielomiany wpisu.
+ * @param m : pamięć podręczna
+ * @param e : wpis bez pól `next`, `used` i `referenced`
+ */
+static void MemoInsert(PolyMemo *m, const MemoEntry *e) {
+    size_t k;
+    if (m->free != 0) {
+        k = m->free - 1;
+        m->free = m->entries[k].next;
+    }
+    else {
+        if (m->end == m->capacity) {
+            m->capacity *= 2;
+            m->entries = (MemoEntry *) realloc(m->entries,
+                                               m->capacity * sizeof(MemoEntry));
+        }
+        k = m->end++;
+    }
+
+    MemoEntry *slot = &(m->entries[k]);
+    *slot = *e;
+    slot->used = true;
+    slot->referenced = true;
+    size_t b = e->hash & (m->bucket_count - 1);
+    slot->next = m->buckets[b];
+    m->buckets[b] = k + 1;
+
+    m->stats.entries++;
+    m->stats.bytes += e->bytes;
+    if (m->stats.entries > m->bucket_count) {
+        MemoGrowBuckets(m);
+    }
+}
+
+/**
+ * Zwraca wynik operacji z pamięci podręcznej lub wylicza go i zapamiętuje.
+ * @param m : pamięć podręczna
+ * @param op : operacja
+ * @param p : pierwszy argument
+ * @param q : drugi argument lub NULL dla MEMO_AT
+ * @param x : punkt dla MEMO_AT
+ * @return wynik operacji
+ */
+static Poly MemoCompute(PolyMemo *m, MemoOp op, const Poly *p, const Poly *q,
+                        poly_coeff_t x) {
+    uint64_t hash = PolyHashMix((uint64_t) op, (uint64_t) x);
+    hash = PolyHashMix(hash, PolyHash(p));
+    if (q != NULL) {
+        hash = PolyHashMix(hash, PolyHash(q));
+    }
+
+    MemoEntry *found = MemoFind(m, hash, op, p, q, x);
+    if (found != NULL) {
+        m->stats.hits++;
+        found->referenced = true;
+        return PolyClone(&(found->result));
+    }
+    m->stats.misses++;
+
+    Poly result;
+    PolyMemo *outer = memo_context;
+    switch (op) {
+        case MEMO_ADD:
+            result = PolyAdd(p, q);
+            break;
+        case MEMO_MUL:
+            memo_context = m;
+            result = PolyMul(p, q);
+            memo_context = outer;
+            break;
+        default:
+            result = PolyAt(p, x);
+            break;
+    }
+
+    // Wynik zastępczy przerwanej operacji nie może trafić do pamięci.
+    PolyError error = PolyLastError();
+    if (error == POLY_ERR_BUDGET || error == POLY_ERR_NO_MEMORY) {
+        return result;
+    }
+
+    size_t elems = PolyNodeCount(p) + PolyNodeCount(&result);
+    if (q != NULL) {
+        elems += PolyNodeCount(q);
+    }
+    size_t bytes = sizeof(MemoEntry) + elems * MEMO_ELEM_BYTES;
+    if (bytes <= m->max_bytes) {
+        MemoEvict(m, bytes);
+        MemoEntry e = {
+            .p = PolyClone(p),
+            .q = (q != NULL) ? PolyClone(q) : PolyZero(),
+            .x = x,
+            .result = PolyClone(&result),
+            .hash = hash,
+            .bytes = bytes,
+            .op = op
+        };
+        MemoInsert(m, &e);
+    }
+    return result;
+}
+
+Poly PolyMemoAdd(PolyMemo *m, const Poly *p, const Poly *q) {
+    return MemoCompute(m, MEMO_ADD, p, q, 0);
+}
+
+Poly PolyMemoMul(PolyMemo *m, const Poly *p, const Poly *q) {
+    return MemoCompute(m, MEMO_MUL, p, q, 0);
+}
+
+Poly PolyMemoAt(PolyMemo *m, const Poly *p, poly_coeff_t x) {
+    return MemoCompute(m, MEMO_AT, p, NULL, x);
+}
+
+Poly PolyMemoMulNested(const Poly *p, const Poly *q) {
+    if (memo_context == NULL || PolyIsCoeff(p) || PolyIsCoeff(q)) {
+        return PolyMul(p, q);
+    }
+    return MemoCompute(memo_context, MEMO_MUL, p, q, 0);
+}
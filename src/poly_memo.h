@@ -0,0 +1,114 @@
+/** @file
+   Interfejs pamięci podręcznej wyników operacji na wielomianach
+
+   Pamięć podręczna zapamiętuje wyniki dodawania, mnożenia i wyliczania
+   wartości wielomianów. Kluczem jest skrót (PolyHash) argumentów, a przy
+   trafieniu argumenty są dodatkowo porównywane, więc wynik jest zawsze
+   poprawny. Rozmiar pamięci jest ograniczony liczbą bajtów; po jej
+   przekroczeniu wpisy są usuwane algorytmem zegarowym (CLOCK), który
+   przybliża usuwanie najdawniej używanych wpisów.
+
+   Przy mnożeniu pamięć obejmuje też iloczyny współczynników liczone
+   rekurencyjnie przez PolyMul, o ile żaden z czynników nie jest stałą,
+   więc powtarzające się podiloczyny (np. potęgi tego samego
+   współczynnika) liczone są raz. Wyszukiwania podiloczynów wliczają się
+   do statystyk. Pamięć podręczna nie jest bezpieczna dla wątków: iloczyny
+   współczynników liczone w innych wątkach planisty z niej nie korzystają.
+
+   Argumenty i wyniki są przechowywane jako kopie z poly.h, które
+   współdzielą elementy list z oryginałami, więc zapamiętanie wyniku i jego
+   zwrócenie przy trafieniu zajmują czas stały.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_MEMO_H__
+#define __POLY_MEMO_H__
+
+#include <stddef.h>
+#include "poly.h"
+
+/**
+ * Pamięć podręczna wyników operacji.
+ */
+typedef struct PolyMemo PolyMemo;
+
+/**
+ * Statystyki pamięci podręcznej.
+ */
+typedef struct PolyMemoStats {
+    size_t hits; ///< liczba trafień
+    size_t misses; ///< liczba chybień
+    size_t evictions; ///< liczba wpisów usuniętych z braku miejsca
+    size_t entries; ///< liczba przechowywanych wpisów
+    size_t bytes; ///< szacowany rozmiar przechowywanych wpisów w bajtach
+} PolyMemoStats;
+
+/**
+ * Tworzy pustą pamięć podręczną.
+ * @param[in] max_bytes : ograniczenie szacowanego rozmiaru wpisów w bajtach
+ * @return pamięć podręczna
+ */
+PolyMemo *PolyMemoNew(size_t max_bytes);
+
+/**
+ * Usuwa pamięć podręczną wraz ze wszystkimi wpisami.
+ * @param[in] m : pamięć podręczna
+ */
+void PolyMemoDestroy(PolyMemo *m);
+
+/**
+ * Usuwa wszystkie wpisy. Statystyki trafień i chybień nie są zerowane.
+ * @param[in] m : pamięć podręczna
+ */
+void PolyMemoFlush(PolyMemo *m);
+
+/**
+ * Zwraca statystyki pamięci podręcznej.
+ * @param[in] m : pamięć podręczna
+ * @return statystyki
+ */
+PolyMemoStats PolyMemoGetStats(const PolyMemo *m);
+
+/**
+ * Dodaje dwa wielomiany, korzystając z pamięci podręcznej.
+ * @param[in] m : pamięć podręczna
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p + q@f$
+ */
+Poly PolyMemoAdd(PolyMemo *m, const Poly *p, const Poly *q);
+
+/**
+ * Mnoży dwa wielomiany, korzystając z pamięci podręcznej także przy
+ * iloczynach współczynników w trakcie mnożenia.
+ * @param[in] m : pamięć podręczna
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p * q@f$
+ */
+Poly PolyMemoMul(PolyMemo *m, const Poly *p, const Poly *q);
+
+/**
+ * Wylicza wartość wielomianu w punkcie @p x, korzystając z pamięci
+ * podręcznej.
+ * @param[in] m : pamięć podręczna
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] x : wartość argumentu @f$x@f$
+ * @return @f$p(x, x_0, x_1, \ldots)@f$
+ */
+Poly PolyMemoAt(PolyMemo *m, const Poly *p, poly_coeff_t x);
+
+/**
+ * Mnoży współczynniki jednomianów w rekurencji PolyMul. W trakcie
+ * PolyMemoMul w bieżącym wątku korzysta z jej pamięci podręcznej, o ile
+ * żaden z czynników nie jest stałą, a w przeciwnym razie działa tak jak
+ * PolyMul. Funkcja dla modułów biblioteki.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p * q@f$
+ */
+Poly PolyMemoMulNested(const Poly *p, const Poly *q);
+
+#endif /* __POLY_MEMO_H__ */
@@ -0,0 +1,892 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include "poly.h"
+#include "poly_resultant.h"
+
+/**
+ * Największa suma stopni, dla której rugownik liczony jest ciągiem
+ * podrugowników. Dla większych używana jest metoda modularna.
+ */
+#define RESULTANT_PRS_MAX_DEG 10
+
+/**
+ * Największa liczba punktów wartościowania w metodzie modularnej.
+ * Interpolacja (InterpolateMod) jest kwadratowa względem liczby punktów,
+ * więc limit dobrany jest tak, by kończyła się w sekundach; gdy potrzeba
+ * więcej punktów, używany jest ciąg podrugowników.
+ */
+#define RESULTANT_MAX_POINTS (1u << 14)
+
+/** Typ reszt modulo liczba pierwsza */
+typedef unsigned long long mod_t;
+
+/** Liczby pierwsze (mniejsze od 2^62) używane w metodzie modularnej */
+static const mod_t RESULTANT_PRIMES[] = {
+    4611686018427387847ULL,
+    4611686018427387817ULL,
+    4611686018427387787ULL,
+    4611686018427387761ULL
+};
+
+/** Liczba liczb pierwszych w tablicy RESULTANT_PRIMES */
+#define RESULTANT_PRIMES_COUNT 4
+
+/** Liczba liczb pierwszych, z których odtwarzany jest wynik */
+#define RESULTANT_PRIMES_USED 2
+
+
+
+/**
+ * @param a : reszta
+ * @param b : reszta
+ * @param m : moduł
+ * @return `a + b mod m`
+ */
+static inline mod_t ModAdd(mod_t a, mod_t b, mod_t m) {
+    mod_t s = a + b;
+    return (s >= m) ? s - m : s;
+}
+
+/**
+ * @param a : reszta
+ * @param b : reszta
+ * @param m : moduł
+ * @return `a - b mod m`
+ */
+static inline mod_t ModSub(mod_t a, mod_t b, mod_t m) {
+    return (a >= b) ? a - b : a + m - b;
+}
+
+/**
+ * @param a : reszta
+ * @param b : reszta
+ * @param m : moduł
+ * @return `a * b mod m`
+ */
+static inline mod_t ModMul(mod_t a, mod_t b, mod_t m) {
+    return (mod_t) (((unsigned __int128) a * b) % m);
+}
+
+/**
+ * @param a : reszta
+ * @param e : wykładnik
+ * @param m : moduł
+ * @return `a^e mod m`
+ */
+static mod_t ModPow(mod_t a, unsigned long long e, mod_t m) {
+    mod_t res = 1 % m;
+    while (e > 0) {
+        if (e & 1) {
+            res = ModMul(res, a, m);
+        }
+        a = ModMul(a, a, m);
+        e >>= 1;
+    }
+    return res;
+}
+
+/**
+ * @param a : niezerowa reszta
+ * @param m : moduł - liczba pierwsza
+ * @return odwrotność @p a modulo @p m
+ */
+static mod_t ModInv(mod_t a, mod_t m) {
+    return ModPow(a, m - 2, m);
+}
+
+/**
+ * @param c : współczynnik
+ * @param m : moduł
+ * @return reszta z dzielenia @p c przez @p m
+ */
+static mod_t ModFromCoeff(poly_coeff_t c, mod_t m) {
+    if (c >= 0) {
+        return (mod_t) c % m;
+    }
+    else {
+        mod_t r = (mod_t) (-(c + 1)) % m; // -(c + 1) nie przepełnia się
+        return ModSub(m - 1, r, m);
+    }
+}
+
+
+
+/**
+ * Potęguje wielomian.
+ * @param p : wielomian
+ * @param e : wykładnik
+ * @return `p^e`
+ */
+static Poly PolyPowSimple(const Poly *p, unsigned e) {
+    Poly res = PolyFromCoeff(1);
+    Poly base = PolyClone(p);
+    while (e > 0) {
+        if (e & 1) {
+            Poly mul = PolyMul(&res, &base);
+            PolyDestroy(&res);
+            res = mul;
+        }
+        e >>= 1;
+        if (e > 0) {
+            Poly sq = PolyMul(&base, &base);
+            PolyDestroy(&base);
+            base = sq;
+        }
+    }
+    PolyDestroy(&base);
+    return res;
+}
+
+/**
+ * @param p : wielomian
+ * @return liczba zmiennych, od których może zależeć wielomian
+ * (głębokość zagnieżdżenia)
+ */
+static unsigned PolyNumVars(const Poly *p) {
+    unsigned vars = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        unsigned sub = PolyNumVars(&(l->head->poly)) + 1;
+        if (sub > vars) {
+            vars = sub;
+        }
+    }
+    return vars;
+}
+
+/**
+ * Rozkłada wielomian na współczynniki przy kolejnych potęgach zmiennej głównej.
+ * @param p : wielomian
+ * @param deg : tu zapisywany jest stopień (-1 dla wielomianu zerowego)
+ * @return tablica `max(deg, 0) + 1` współczynników (nowych wielomianów)
+ */
+static Poly *PolyToDenseMain(const Poly *p, poly_exp_t *deg) {
+    *deg = PolyDegBy(p, 0);
+    size_t size = (size_t) (*deg < 0 ? 0 : *deg) + 1;
+    Poly *c = (Poly *) malloc(size * sizeof(struct Poly));
+    for (size_t i = 0; i < size; i++) {
+        c[i] = PolyZero();
+    }
+
+    c[0] = PolyFromCoeff(p->coeff);
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        const Mono *m = l->head;
+        if (m->exp == 0) {
+            Poly sum = PolyAdd(&c[0], &(m->poly));
+            PolyDestroy(&c[0]);
+            c[0] = sum;
+        }
+        else {
+            c[m->exp] = PolyClone(&(m->poly));
+        }
+    }
+    return c;
+}
+
+/**
+ * Składa wielomian ze współczynników przy kolejnych potęgach zmiennej głównej.
+ * Przejmuje na własność tablicę @p c i jej zawartość.
+ * @param c : tablica `deg + 1` współczynników
+ * @param deg : stopień
+ * @return wielomian `c[0] + c[1] * x + ... + c[deg] * x^deg`
+ */
+static Poly PolyFromDenseMain(Poly *c, poly_exp_t deg) {
+    Mono *monos = (Mono *) malloc((size_t) (deg + 1) * sizeof(struct Mono));
+    unsigned n = 0;
+    for (poly_exp_t i = 0; i <= deg; i++) {
+        if (PolyIsZero(&c[i])) {
+            PolyDestroy(&c[i]);
+        }
+        else {
+            monos[n++] = MonoFromPoly(&c[i], i);
+        }
+    }
+    Poly res = PolyAddMonos(n, monos);
+    free(monos);
+    free(c);
+    return res;
+}
+
+/**
+ * Rozkłada wielomian na współczynniki przy kolejnych potęgach zadanej zmiennej.
+ * Współczynniki są wielomianami pozostałych zmiennych - zmienne o indeksach
+ * większych od @p var_idx mają indeks mniejszy o jeden.
+ * @param p : wielomian
+ * @param var_idx : indeks zmiennej
+ * @param deg : tu zapisywany jest stopień względem zmiennej
+ * (-1 dla wielomianu zerowego)
+ * @return tablica `max(deg, 0) + 1` współczynników (nowych wielomianów)
+ */
+static Poly *PolyCoeffsBy(const Poly *p, unsigned var_idx, poly_exp_t *deg) {
+    if (var_idx == 0) {
+        return PolyToDenseMain(p, deg);
+    }
+
+    *deg = PolyDegBy(p, var_idx);
+    size_t size = (size_t) (*deg < 0 ? 0 : *deg) + 1;
+    size_t count = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        count++;
+    }
+
+    Mono *monos = (Mono *) malloc((size * count + 1) * sizeof(struct Mono));
+    unsigned *n = (unsigned *) calloc(size, sizeof(unsigned));
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        poly_exp_t sub_deg;
+        Poly *sub = PolyCoeffsBy(&(l->head->poly), var_idx - 1, &sub_deg);
+        for (poly_exp_t i = 0; i <= sub_deg; i++) {
+            monos[i * count + n[i]++] = MonoFromPoly(&sub[i], l->head->exp);
+        }
+        if (sub_deg < 0) {
+            PolyDestroy(&sub[0]);
+        }
+        free(sub);
+    }
+
+    Poly *c = (Poly *) malloc(size * sizeof(struct Poly));
+    for (size_t i = 0; i < size; i++) {
+        c[i] = PolyAddMonos(n[i], monos + i * count);
+    }
+    c[0].coeff += p->coeff;
+
+    free(n);
+    free(monos);
+    return c;
+}
+
+/**
+ * Usuwa tablicę wielomianów.
+ * @param c : tablica
+ * @param deg : indeks ostatniego elementu (-1 oznacza jeden element)
+ */
+static void PolyArrayDestroy(Poly *c, poly_exp_t deg) {
+    for (poly_exp_t i = 0; i <= (deg < 0 ? 0 : deg); i++) {
+        PolyDestroy(&c[i]);
+    }
+    free(c);
+}
+
+/**
+ * Dzieli wielomian przez liczbę, gdy wiadomo, że dzielenie jest dokładne.
+ * @param p : wielomian
+ * @param c : niezerowa liczba
+ * @return `p / c`
+ */
+static Poly PolyScalarDivExact(const Poly *p, poly_coeff_t c) {
+    unsigned count = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        count++;
+    }
+
+    Mono *monos = (Mono *) malloc((count + 1) * sizeof(struct Mono));
+    unsigned n = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        Poly d = PolyScalarDivExact(&(l->head->poly), c);
+        monos[n++] = MonoFromPoly(&d, l->head->exp);
+    }
+    Poly res = PolyAddMonos(n, monos);
+    res.coeff += p->coeff / c;
+    free(monos);
+    return res;
+}
+
+/**
+ * Dzieli wielomian przez wielomian, gdy wiadomo, że dzielenie jest dokładne.
+ * @param p : wielomian
+ * @param q : niezerowy wielomian
+ * @return `p / q`
+ */
+static Poly PolyDivExact(const Poly *p, const Poly *q) {
+    assert(!PolyIsZero(q));
+    if (PolyIsZero(p)) {
+        return PolyZero();
+    }
+    if (PolyIsCoeff(q)) {
+        return PolyScalarDivExact(p, q->coeff);
+    }
+
+    poly_exp_t dp, dq;
+    Poly *a = PolyToDenseMain(p, &dp);
+    Poly *b = PolyToDenseMain(q, &dq);
+    assert(dp >= dq);
+
+    Poly *quot = (Poly *) malloc((size_t) (dp - dq + 1) * sizeof(struct Poly));
+    for (poly_exp_t i = dp; i >= dq; i--) {
+        Poly t = PolyDivExact(&a[i], &b[dq]);
+        if (!PolyIsZero(&t)) {
+            for (poly_exp_t j = 0; j < dq; j++) {
+                Poly tb = PolyMul(&t, &b[j]);
+                Poly diff = PolySub(&a[i - dq + j], &tb);
+                PolyDestroy(&tb);
+                PolyDestroy(&a[i - dq + j]);
+                a[i - dq + j] = diff;
+            }
+        }
+        quot[i - dq] = t;
+    }
+
+    PolyArrayDestroy(a, dp);
+    PolyArrayDestroy(b, dq);
+    return PolyFromDenseMain(quot, dp - dq);
+}
+
+
+
+/**
+ * Liczy pseudoresztę `lc(b)^(da - db + 1) * a mod b`.
+ * @param a : współczynniki dzielnej
+ * @param da : stopień dzielnej
+ * @param b : współczynniki dzielnika
+ * @param db : stopień dzielnika, `db <= da`
+ * @param dr : tu zapisywany jest stopień pseudoreszty (-1 dla zera)
+ * @return tablica `max(dr, 0) + 1` współczynników pseudoreszty
+ */
+static Poly *PseudoRem(const Poly *a, poly_exp_t da, const Poly *b,
+                       poly_exp_t db, poly_exp_t *dr) {
+    Poly *r = (Poly *) malloc((size_t) (da + 1) * sizeof(struct Poly));
+    for (poly_exp_t i = 0; i <= da; i++) {
+        r[i] = PolyClone(&a[i]);
+    }
+
+    for (poly_exp_t i = da; i >= db; i--) {
+        Poly t = r[i];
+        r[i] = PolyZero();
+        for (poly_exp_t j = 0; j < i; j++) {
+            Poly scaled = PolyMul(&r[j], &b[db]);
+            PolyDestroy(&r[j]);
+            r[j] = scaled;
+        }
+        for (poly_exp_t j = 0; j < db; j++) {
+            Poly tb = PolyMul(&t, &b[j]);
+            Poly diff = PolySub(&r[i - db + j], &tb);
+            PolyDestroy(&tb);
+            PolyDestroy(&r[i - db + j]);
+            r[i - db + j] = diff;
+        }
+        PolyDestroy(&t);
+    }
+
+    *dr = db - 1;
+    while (*dr >= 0 && PolyIsZero(&r[*dr])) {
+        (*dr)--;
+    }
+    for (poly_exp_t i = (*dr < 0 ? 1 : *dr + 1); i <= da; i++) {
+        PolyDestroy(&r[i]);
+    }
+    return r;
+}
+
+/**
+ * Liczy rugownik ciągiem podrugowników (algorytm 3.3.7 z "A Course in
+ * Computational Algebraic Number Theory" H. Cohena, bez wyciągania treści).
+ * Przejmuje na własność tablice @p a i @p b.
+ * @param a : współczynniki pierwszego wielomianu
+ * @param da : stopień pierwszego wielomianu, `da >= 1`
+ * @param b : współczynniki drugiego wielomianu
+ * @param db : stopień drugiego wielomianu, `db >= 1`
+ * @return rugownik
+ */
+static Poly ResultantPRS(Poly *a, poly_exp_t da, Poly *b, poly_exp_t db) {
+    int sign = 1;
+    if (da < db) {
+        Poly *tc = a; a = b; b = tc;
+        poly_exp_t td = da; da = db; db = td;
+        if ((da & 1) && (db & 1)) {
+            sign = -1;
+        }
+    }
+
+    Poly g = PolyFromCoeff(1);
+    Poly h = PolyFromCoeff(1);
+    Poly res;
+    while (true) {
+        poly_exp_t delta = da - db;
+        if ((da & 1) && (db & 1)) {
+            sign = -sign;
+        }
+
+        poly_exp_t dr;
+        Poly *r = PseudoRem(a, da, b, db, &dr);
+        PolyArrayDestroy(a, da);
+        a = b;
+        da = db;
+
+        Poly h_delta = PolyPowSimple(&h, (unsigned) delta);
+        Poly divisor = PolyMul(&g, &h_delta);
+        PolyDestroy(&h_delta);
+        for (poly_exp_t i = 0; i <= (dr < 0 ? 0 : dr); i++) {
+            Poly quot = PolyDivExact(&r[i], &divisor);
+            PolyDestroy(&r[i]);
+            r[i] = quot;
+        }
+        PolyDestroy(&divisor);
+        b = r;
+        db = dr;
+
+        PolyDestroy(&g);
+        g = PolyClone(&a[da]);
+        if (delta == 1) {
+            PolyDestroy(&h);
+            h = PolyClone(&g);
+        }
+        else if (delta > 1) {
+            Poly g_delta = PolyPowSimple(&g, (unsigned) delta);
+            Poly h_delta1 = PolyPowSimple(&h, (unsigned) delta - 1);
+            PolyDestroy(&h);
+            h = PolyDivExact(&g_delta, &h_delta1);
+            PolyDestroy(&g_delta);
+            PolyDestroy(&h_delta1);
+        }
+
+        if (db < 0) {
+            res = PolyZero();
+            break;
+        }
+        else if (db == 0) {
+            Poly b_da = PolyPowSimple(&b[0], (unsigned) da);
+            Poly h_da1 = PolyPowSimple(&h, (unsigned) da - 1);
+            res = PolyDivExact(&b_da, &h_da1);
+            PolyDestroy(&b_da);
+            PolyDestroy(&h_da1);
+            break;
+        }
+    }
+
+    PolyDestroy(&g);
+    PolyDestroy(&h);
+    PolyArrayDestroy(a, da);
+    PolyArrayDestroy(b, db);
+
+    if (sign < 0) {
+        Poly neg = PolyNeg(&res);
+        PolyDestroy(&res);
+        res = neg;
+    }
+    return res;
+}
+
+
+
+/**
+ * Wylicza wartość wielomianu modulo @p m w punkcie @p y.
+ * @param p : wielomian
+ * @param y : wartości kolejnych zmiennych
+ * @param m : moduł
+ * @return wartość @p p w punkcie @p y modulo @p m
+ */
+static mod_t PolyEvalMod(const Poly *p, const mod_t *y, mod_t m) {
+    mod_t val = ModFromCoeff(p->coeff, m);
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        mod_t sub = PolyEvalMod(&(l->head->poly), y + 1, m);
+        val = ModAdd(val, ModMul(sub, ModPow(y[0], (mod_t) l->head->exp, m), m), m);
+    }
+    return val;
+}
+
+/**
+ * Liczy rugownik dwóch wielomianów jednej zmiennej nad ciałem reszt modulo
+ * @p m algorytmem Euklidesa. Modyfikuje tablice @p a i @p b.
+ * @param a : współczynniki pierwszego wielomianu
+ * @param da : stopień pierwszego wielomianu (niezerowy współczynnik wiodący)
+ * @param b : współczynniki drugiego wielomianu
+ * @param db : stopień drugiego wielomianu (niezerowy współczynnik wiodący)
+ * @param m : moduł - liczba pierwsza
+ * @return rugownik modulo @p m
+ */
+static mod_t UniResultantMod(mod_t *a, int da, mod_t *b, int db, mod_t m) {
+    mod_t res = 1;
+    if (da < db) {
+        mod_t *tc = a; a = b; b = tc;
+        int td = da; da = db; db = td;
+        if ((da & 1) && (db & 1)) {
+            res = m - 1;
+        }
+    }
+
+    while (db > 0) {
+        mod_t inv = ModInv(b[db], m);
+        for (int i = da; i >= db; i--) {
+            mod_t q = ModMul(a[i], inv, m);
+            if (q != 0) {
+                for (int j = 0; j < db; j++) {
+                    a[i - db + j] = ModSub(a[i - db + j], ModMul(q, b[j], m), m);
+                }
+            }
+            a[i] = 0;
+        }
+
+        int dr = db - 1;
+        while (dr >= 0 && a[dr] == 0) {
+            dr--;
+        }
+        if (dr < 0) {
+            return 0;
+        }
+
+        if ((da & 1) && (db & 1)) {
+            res = ModSub(0, res, m);
+        }
+        res = ModMul(res, ModPow(b[db], (mod_t) (da - dr), m), m);
+
+        mod_t *tc = a; a = b; b = tc;
+        da = db;
+        db = dr;
+    }
+
+    return ModMul(res, ModPow(b[0], (mod_t) da, m), m);
+}
+
+/**
+ * Dane zadania liczącego rugowniki w części punktów wartościowania.
+ */
+typedef struct ResultantJob {
+    const Poly *a; ///< współczynniki pierwszego wielomianu
+    poly_exp_t da; ///< stopień pierwszego wielomianu
+    const Poly *b; ///< współczynniki drugiego wielomianu
+    poly_exp_t db; ///< stopień drugiego wielomianu
+    unsigned vars; ///< liczba pozostałych zmiennych
+    const mod_t *strides; ///< wykładniki podstawienia Kroneckera
+    const mod_t *points; ///< punkty wartościowania
+    mod_t *values; ///< miejsce na wartości rugownika w punktach
+    size_t begin; ///< pierwszy punkt zadania
+    size_t end; ///< punkt za ostatnim punktem zadania
+    mod_t prime; ///< moduł
+} ResultantJob;
+
+/**
+ * Podstawia za kolejne zmienne potęgi punktu (podstawienie Kroneckera).
+ * @param z : punkt
+ * @param strides : wykładniki podstawienia
+ * @param vars : liczba zmiennych
+ * @param y : tu zapisywane są wartości zmiennych
+ * @param m : moduł
+ */
+static void KroneckerPoint(mod_t z, const mod_t *strides, unsigned vars,
+                           mod_t *y, mod_t m) {
+    for (unsigned i = 0; i < vars; i++) {
+        y[i] = ModPow(z, strides[i], m);
+    }
+}
+
+/**
+ * Liczy rugowniki w punktach zadania.
+ * @param arg : zadanie (ResultantJob)
+ * @return NULL
+ */
+static void *ResultantWorker(void *arg) {
+    ResultantJob *job = (ResultantJob *) arg;
+    mod_t m = job->prime;
+    mod_t *y = (mod_t *) malloc((job->vars + 1) * sizeof(mod_t));
+    mod_t *ea = (mod_t *) malloc((size_t) (job->da + 1) * sizeof(mod_t));
+    mod_t *eb = (mod_t *) malloc((size_t) (job->db + 1) * sizeof(mod_t));
+
+    for (size_t k = job->begin; k < job->end; k++) {
+        KroneckerPoint(job->points[k], job->strides, job->vars, y, m);
+        for (poly_exp_t i = 0; i <= job->da; i++) {
+            ea[i] = PolyEvalMod(&job->a[i], y, m);
+        }
+        for (poly_exp_t i = 0; i <= job->db; i++) {
+            eb[i] = PolyEvalMod(&job->b[i], y, m);
+        }
+        job->values[k] = UniResultantMod(ea, job->da, eb, job->db, m);
+    }
+
+    free(eb);
+    free(ea);
+    free(y);
+    return NULL;
+}
+
+/**
+ * Interpoluje wielomian jednej zmiennej modulo @p m wzorem Lagrange'a.
+ * @param x : różne punkty
+ * @param v : wartości w punktach
+ * @param n : liczba punktów
+ * @param c : tu zapisywane jest @p n współczynników wyniku
+ * @param m : moduł - liczba pierwsza
+ */
+static void InterpolateMod(const mod_t *x, const mod_t *v, size_t n, mod_t *c,
+                           mod_t m) {
+    // M(z) = (z - x_0) * ... * (z - x_{n-1})
+    mod_t *prod = (mod_t *) calloc(n + 1, sizeof(mod_t));
+    mod_t *quot = (mod_t *) malloc(n * sizeof(mod_t));
+    prod[0] = 1;
+    for (size_t j = 0; j < n; j++) {
+        for (size_t i = j + 1; i > 0; i--) {
+            prod[i] = ModSub(prod[i - 1], ModMul(prod[i], x[j], m), m);
+        }
+        prod[0] = ModSub(0, ModMul(prod[0], x[j], m), m);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        c[i] = 0;
+    }
+    for (size_t j = 0; j < n; j++) {
+        // quot = M(z) / (z - x_j), weight = M'(x_j) = quot(x_j)
+        quot[n - 1] = prod[n];
+        for (size_t i = n - 1; i > 0; i--) {
+            quot[i - 1] = ModAdd(prod[i], ModMul(x[j], quot[i], m), m);
+        }
+        mod_t weight = 0;
+        for (size_t i = n; i > 0; i--) {
+            weight = ModAdd(ModMul(weight, x[j], m), quot[i - 1], m);
+        }
+
+        mod_t scale = ModMul(v[j], ModInv(weight, m), m);
+        if (scale != 0) {
+            for (size_t i = 0; i < n; i++) {
+                c[i] = ModAdd(c[i], ModMul(scale, quot[i], m), m);
+            }
+        }
+    }
+
+    free(quot);
+    free(prod);
+}
+
+/**
+ * Składa wielomian z gęstej tablicy współczynników podstawienia Kroneckera.
+ * @param c : współczynniki
+ * @param strides : wykładniki podstawienia
+ * @param bounds : ograniczenia stopni kolejnych zmiennych
+ * @param vars : liczba zmiennych
+ * @param offset : indeks współczynnika przy zerowych wykładnikach
+ * @return wielomian
+ */
+static Poly PolyFromKronecker(const poly_coeff_t *c, const mod_t *strides,
+                              const poly_exp_t *bounds, unsigned vars,
+                              size_t offset) {
+    if (vars == 0) {
+        return PolyFromCoeff(c[offset]);
+    }
+
+    Mono *monos = (Mono *) malloc((size_t) (bounds[0] + 1) * sizeof(struct Mono));
+    unsigned n = 0;
+    for (poly_exp_t e = 0; e <= bounds[0]; e++) {
+        Poly sub = PolyFromKronecker(c, strides + 1, bounds + 1, vars - 1,
+                                     offset + (size_t) e * strides[0]);
+        if (PolyIsZero(&sub)) {
+            PolyDestroy(&sub);
+        }
+        else {
+            monos[n++] = MonoFromPoly(&sub, e);
+        }
+    }
+    Poly res = PolyAddMonos(n, monos);
+    free(monos);
+    return res;
+}
+
+/**
+ * Liczy rugownik metodą modularną: podstawienie Kroneckera za pozostałe
+ * zmienne, rugowniki jednej zmiennej w wielu punktach dla kilku liczb
+ * pierwszych, interpolacja i chińskie twierdzenie o resztach.
+ * @param a : współczynniki pierwszego wielomianu
+ * @param da : stopień pierwszego wielomianu, `da >= 1`
+ * @param b : współczynniki drugiego wielomianu
+ * @param db : stopień drugiego wielomianu, `db >= 1`
+ * @param threads : liczba wątków
+ * @param res : tu zapisywany jest wynik
+ * @return Czy udało się policzyć rugownik?
+ */
+static bool ResultantModular(const Poly *a, poly_exp_t da, const Poly *b,
+                             poly_exp_t db, unsigned threads, Poly *res) {
+    unsigned vars = 0;
+    for (poly_exp_t i = 0; i <= da; i++) {
+        unsigned v = PolyNumVars(&a[i]);
+        vars = (v > vars) ? v : vars;
+    }
+    for (poly_exp_t i = 0; i <= db; i++) {
+        unsigned v = PolyNumVars(&b[i]);
+        vars = (v > vars) ? v : vars;
+    }
+
+    // deg_y Res(a, b) <= da * deg_y(b) + db * deg_y(a)
+    poly_exp_t *bounds = (poly_exp_t *) malloc((vars + 1) * sizeof(poly_exp_t));
+    mod_t *strides = (mod_t *) malloc((vars + 1) * sizeof(mod_t));
+    mod_t points_count = 1;
+    bool too_big = false;
+    for (unsigned v = 0; v < vars; v++) {
+        poly_exp_t deg_a = 0, deg_b = 0;
+        for (poly_exp_t i = 0; i <= da; i++) {
+            poly_exp_t d = PolyDegBy(&a[i], v);
+            deg_a = (d > deg_a) ? d : deg_a;
+        }
+        for (poly_exp_t i = 0; i <= db; i++) {
+            poly_exp_t d = PolyDegBy(&b[i], v);
+            deg_b = (d > deg_b) ? d : deg_b;
+        }
+        bounds[v] = da * deg_b + db * deg_a;
+        strides[v] = points_count;
+        points_count *= (mod_t) bounds[v] + 1;
+        if (points_count > RESULTANT_MAX_POINTS) {
+            too_big = true;
+            break;
+        }
+    }
+    if (too_big) {
+        free(strides);
+        free(bounds);
+        return false;
+    }
+
+    size_t n = (size_t) points_count;
+    mod_t *points = (mod_t *) malloc(n * sizeof(mod_t));
+    mod_t *values = (mod_t *) malloc(n * sizeof(mod_t));
+    mod_t *y = (mod_t *) malloc((vars + 1) * sizeof(mod_t));
+    mod_t *residues[RESULTANT_PRIMES_USED];
+    mod_t primes[RESULTANT_PRIMES_USED];
+    unsigned used = 0;
+
+    for (unsigned pi = 0; pi < RESULTANT_PRIMES_COUNT && used < RESULTANT_PRIMES_USED; pi++) {
+        mod_t m = RESULTANT_PRIMES[pi];
+
+        // Pomijamy punkty, w których zeruje się któryś współczynnik wiodący.
+        size_t found = 0;
+        for (mod_t z = 1; found < n && z <= 2 * (mod_t) n + 64; z++) {
+            KroneckerPoint(z, strides, vars, y, m);
+            if (PolyEvalMod(&a[da], y, m) != 0 && PolyEvalMod(&b[db], y, m) != 0) {
+                points[found++] = z;
+            }
+        }
+        if (found < n) {
+            continue;
+        }
+
+        if (threads > n) {
+            threads = (unsigned) n;
+        }
+        ResultantJob *jobs = (ResultantJob *) malloc(threads * sizeof(ResultantJob));
+        pthread_t *tids = (pthread_t *) malloc(threads * sizeof(pthread_t));
+        for (unsigned t = 0; t < threads; t++) {
+            jobs[t] = (ResultantJob) {
+                .a = a, .da = da, .b = b, .db = db, .vars = vars,
+                .strides = strides, .points = points, .values = values,
+                .begin = n * t / threads, .end = n * (t + 1) / threads,
+                .prime = m
+            };
+        }
+        bool *started = (bool *) calloc(threads, sizeof(bool));
+        for (unsigned t = 1; t < threads; t++) {
+            started[t] = (pthread_create(&tids[t], NULL, ResultantWorker, &jobs[t]) == 0);
+            if (!started[t]) {
+                ResultantWorker(&jobs[t]);
+            }
+        }
+        ResultantWorker(&jobs[0]);
+        for (unsigned t = 1; t < threads; t++) {
+            if (started[t]) {
+                pthread_join(tids[t], NULL);
+            }
+        }
+        free(started);
+        free(tids);
+        free(jobs);
+
+        residues[used] = (mod_t *) malloc(n * sizeof(mod_t));
+        InterpolateMod(points, values, n, residues[used], m);
+        primes[used] = m;
+        used++;
+    }
+
+    bool ok = (used == RESULTANT_PRIMES_USED);
+    if (ok) {
+        // Chińskie twierdzenie o resztach i reprezentant symetryczny.
+        mod_t p1 = primes[0], p2 = primes[1];
+        mod_t inv = ModInv(p1 % p2, p2);
+        unsigned __int128 mod = (unsigned __int128) p1 * p2;
+        poly_coeff_t *c = (poly_coeff_t *) malloc(n * sizeof(poly_coeff_t));
+        for (size_t i = 0; i < n; i++) {
+            mod_t r1 = residues[0][i], r2 = residues[1][i];
+            mod_t t = ModMul(ModSub(r2, r1 % p2, p2), inv, p2);
+            unsigned __int128 x = r1 + (unsigned __int128) p1 * t;
+            if (x > mod / 2) {
+                c[i] = (poly_coeff_t) (-(__int128) (mod - x));
+            }
+            else {
+                c[i] = (poly_coeff_t) x;
+            }
+        }
+        *res = PolyFromKronecker(c, strides, bounds, vars, 0);
+        free(c);
+    }
+
+    for (unsigned i = 0; i < used; i++) {
+        free(residues[i]);
+    }
+    free(y);
+    free(values);
+    free(points);
+    free(strides);
+    free(bounds);
+    return ok;
+}
+
+/**
+ * Liczy rugownik, wybierając metodę.
+ * @param p : wielomian
+ * @param q : wielomian
+ * @param var_idx : indeks rugowanej zmiennej
+ * @param threads : liczba wątków metody modularnej
+ * @param modular : Czy wymusić metodę modularną?
+ * @return rugownik
+ */
+static Poly ResultantDispatch(const Poly *p, const Poly *q, unsigned var_idx,
+                              unsigned threads, bool modular) {
+    poly_exp_t da, db;
+    Poly *a = PolyCoeffsBy(p, var_idx, &da);
+    Poly *b = PolyCoeffsBy(q, var_idx, &db);
+
+    Poly res;
+    if (da < 0 || db < 0) {
+        res = PolyZero();
+    }
+    else if (da == 0) {
+        res = PolyPowSimple(&a[0], (unsigned) db);
+    }
+    else if (db == 0) {
+        res = PolyPowSimple(&b[0], (unsigned) da);
+    }
+    else if (!modular && da + db <= RESULTANT_PRS_MAX_DEG) {
+        return ResultantPRS(a, da, b, db);
+    }
+    else if (!ResultantModular(a, da, b, db, threads, &res)) {
+        return ResultantPRS(a, da, b, db);
+    }
+
+    PolyArrayDestroy(a, da);
+    PolyArrayDestroy(b, db);
+    return res;
+}
+
+Poly PolyResultant(const Poly *p, const Poly *q, unsigned var_idx) {
+    return ResultantDispatch(p, q, var_idx, 1, false);
+}
+
+Poly PolyResultantParallel(const Poly *p, const Poly *q, unsigned var_idx,
+                           unsigned threads) {
+    return ResultantDispatch(p, q, var_idx, (threads == 0) ? 1 : threads, true);
+}
+
+Poly PolyDiscriminant(const Poly *p, unsigned var_idx) {
+    poly_exp_t n;
+    Poly *c = PolyCoeffsBy(p, var_idx, &n);
+    if (n < 1) {
+        PolyArrayDestroy(c, n);
+        return PolyZero();
+    }
+
+    Poly dp = PolyDerivative(p, var_idx);
+    Poly res = PolyResultant(p, &dp, var_idx);
+    Poly disc = PolyDivExact(&res, &c[n]);
+    PolyDestroy(&res);
+    PolyDestroy(&dp);
+    PolyArrayDestroy(c, n);
+
+    if ((n * (n - 1) / 2) % 2 == 1) {
+        Poly neg = PolyNeg(&disc);
+        PolyDestroy(&disc);
+        disc = neg;
+    }
+    return disc;
+}
@@ -0,0 +1,57 @@
+/** @file
+   Interfejs rugowników i wyróżników wielomianów
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_RESULTANT_H__
+#define __POLY_RESULTANT_H__
+
+#include "poly.h"
+
+/**
+ * Liczy rugownik dwóch wielomianów względem zadanej zmiennej.
+ * Zmienne indeksowane są tak jak w PolyDegBy.
+ * Wynik jest wielomianem pozostałych zmiennych: zmienna o indeksie
+ * @p var_idx zostaje usunięta, a indeksy zmiennych większych od niej
+ * zmniejszają się o jeden.
+ *
+ * Dla małych wielomianów używany jest ciąg podrugowników (subresultant PRS),
+ * dla większych - obliczenia modulo liczby pierwsze: wartościowanie
+ * pozostałych zmiennych w wielu punktach, rugowniki jednej zmiennej
+ * i interpolacja.
+ * Wynik jest poprawny, o ile współczynniki rugownika mieszczą się
+ * w typie poly_coeff_t.
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @param[in] var_idx : indeks rugowanej zmiennej
+ * @return rugownik @p p i @p q względem zmiennej o indeksie @p var_idx
+ */
+Poly PolyResultant(const Poly *p, const Poly *q, unsigned var_idx);
+
+/**
+ * Liczy rugownik tak jak PolyResultant, zawsze metodą modularną,
+ * rozkładając wartościowania w punktach na @p threads wątków.
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @param[in] var_idx : indeks rugowanej zmiennej
+ * @param[in] threads : liczba wątków (0 traktowane jest jak 1)
+ * @return rugownik @p p i @p q względem zmiennej o indeksie @p var_idx
+ */
+Poly PolyResultantParallel(const Poly *p, const Poly *q, unsigned var_idx,
+                           unsigned threads);
+
+/**
+ * Liczy wyróżnik wielomianu względem zadanej zmiennej:
+ * @f$(-1)^{n(n-1)/2} \mathrm{Res}(p, p') / \mathrm{lc}(p)@f$,
+ * gdzie @f$n@f$ jest stopniem @p p względem tej zmiennej.
+ * Zmienne wyniku indeksowane są tak jak w PolyResultant.
+ * Dla wielomianu stopnia mniejszego od 1 wynikiem jest zero.
+ * @param[in] p : wielomian
+ * @param[in] var_idx : indeks zmiennej
+ * @return wyróżnik @p p względem zmiennej o indeksie @p var_idx
+ */
+Poly PolyDiscriminant(const Poly *p, unsigned var_idx);
+
+#endif /* __POLY_RESULTANT_H__ */
@@ -0,0 +1,690 @@
+#include <stdlib.h>
+#include <string.h>
+#include "poly.h"
+#include "poly_roots.h"
+#include "poly_shift.h"
+
+/** Maksymalna głębokość podziału przedziałów na połowy */
+#define ROOTS_MAX_DEPTH 61
+
+/** Maksymalny wykładnik ograniczenia modułów pierwiastków */
+#define ROOTS_MAX_BOUND 61
+
+/** Liczba bitów w słowie liczby wielu słów */
+#define LIMB_BITS 64
+
+/** Liczba bitów cyfry w zapisie z opóźnionym przeniesieniem */
+#define NAIL_BITS 48
+
+/**
+ * Liczba kroków przesunięcia między normalizacjami cyfr. Każdy krok co
+ * najwyżej podwaja moduł cyfry, a cyfra musi się mieścić w 63 bitach.
+ */
+#define NAIL_PASSES (62 - NAIL_BITS)
+
+/** Rozmiar bloku współczynników przesuwanego w pamięci podręcznej */
+#define SHIFT_BLOCK_BYTES (1u << 15)
+
+/**
+ * Słowo liczby wielu słów.
+ */
+typedef unsigned long limb_t;
+
+/**
+ * Wielomian jednej zmiennej o współczynnikach całkowitych dowolnej
+ * wielkości. Każdy współczynnik zajmuje `w` słów i zapisany jest
+ * w kodzie uzupełnień do dwóch, od najmniej znaczącego słowa.
+ */
+typedef struct BigPoly {
+    size_t n; ///< liczba współczynników
+    size_t w; ///< liczba słów na współczynnik
+    limb_t *d; ///< współczynniki
+} BigPoly;
+
+/**
+ * Stan wyszukiwania pierwiastków na jednej półprostej.
+ */
+typedef struct RootSearch {
+    RootInterval *out; ///< znalezione przedziały
+    size_t count; ///< liczba znalezionych przedziałów
+    unsigned bound; ///< pierwiastki leżą w przedziale @f$(0, 2^{bound})@f$
+    bool negative; ///< czy szukamy pierwiastków ujemnych
+    bool ok; ///< czy dotychczas udało się izolować pierwiastki
+} RootSearch;
+
+/**
+ * Zwraca wskaźnik na współczynnik wielomianu.
+ * @param q : wielomian
+ * @param i : indeks współczynnika
+ * @return wskaźnik na pierwsze słowo współczynnika
+ */
+static limb_t *BigCoeff(const BigPoly *q, size_t i) {
+    return q->d + i * q->w;
+}
+
+/**
+ * Sprawdza, czy liczba jest ujemna.
+ * @param a : liczba
+ * @param w : liczba słów
+ * @return Czy liczba jest ujemna?
+ */
+static bool BigIsNeg(const limb_t *a, size_t w) {
+    return (a[w - 1] >> (LIMB_BITS - 1)) != 0;
+}
+
+/**
+ * Zwraca znak liczby.
+ * @param a : liczba
+ * @param w : liczba słów
+ * @return -1, 0 lub 1
+ */
+static int BigSign(const limb_t *a, size_t w) {
+    if (BigIsNeg(a, w)) {
+        return -1;
+    }
+    for (size_t i = 0; i < w; i++) {
+        if (a[i] != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Liczy, na ilu bitach mieści się moduł liczby: @f$|a| \le 2^{bits}@f$.
+ * @param a : liczba
+ * @param w : liczba słów
+ * @return liczba bitów
+ */
+static size_t BigBits(const limb_t *a, size_t w) {
+    limb_t ext = BigIsNeg(a, w) ? ~0UL : 0;
+    for (size_t i = w; i-- > 0; ) {
+        limb_t x = a[i] ^ ext;
+        if (x != 0) {
+            return i * LIMB_BITS + (LIMB_BITS - __builtin_clzl(x));
+        }
+    }
+    return 0;
+}
+
+/**
+ * Liczy zera na końcu zapisu binarnego niezerowej liczby.
+ * @param a : liczba
+ * @param w : liczba słów
+ * @return liczba zer
+ */
+static size_t BigTrailingZeros(const limb_t *a, size_t w) {
+    size_t i = 0;
+    while (i + 1 < w && a[i] == 0) {
+        i++;
+    }
+    return i * LIMB_BITS + __builtin_ctzl(a[i]);
+}
+
+/**
+ * Odczytuje bity liczby od bitu @p pos. Bity powyżej zapisu liczby są
+ * równe bitowi znaku.
+ * @param a : liczba
+ * @param w : liczba słów
+ * @param pos : numer pierwszego bitu
+ * @param len : liczba bitów (co najwyżej LIMB_BITS)
+ * @return odczytane bity
+ */
+static limb_t BigGetBits(const limb_t *a, size_t w, size_t pos, size_t len) {
+    limb_t ext = BigIsNeg(a, w) ? ~0UL : 0;
+    size_t i = pos / LIMB_BITS, bits = pos % LIMB_BITS;
+    limb_t lo = (i < w) ? a[i] : ext;
+    limb_t hi = (i + 1 < w) ? a[i + 1] : ext;
+    limb_t x = (bits == 0) ? lo : ((lo >> bits) | (hi << (LIMB_BITS - bits)));
+    return (len == LIMB_BITS) ? x : (x & ((1UL << len) - 1));
+}
+
+/**
+ * Zmienia znak liczby. Wynik musi się mieścić w @p w słowach.
+ * @param a : liczba
+ * @param w : liczba słów
+ */
+static void BigNegate(limb_t *a, size_t w) {
+    limb_t carry = 1;
+    for (size_t i = 0; i < w; i++) {
+        a[i] = ~a[i] + carry;
+        carry = carry && a[i] == 0;
+    }
+}
+
+/**
+ * Mnoży liczbę przez @f$2^s@f$. Wynik musi się mieścić w @p w słowach.
+ * @param a : liczba
+ * @param w : liczba słów
+ * @param s : przesunięcie
+ */
+static void BigShiftLeft(limb_t *a, size_t w, size_t s) {
+    size_t limbs = s / LIMB_BITS, bits = s % LIMB_BITS;
+    for (size_t i = w; i-- > 0; ) {
+        limb_t x = 0;
+        if (i >= limbs) {
+            x = a[i - limbs] << bits;
+            if (bits != 0 && i > limbs) {
+                x |= a[i - limbs - 1] >> (LIMB_BITS - bits);
+            }
+        }
+        a[i] = x;
+    }
+}
+
+/**
+ * Dzieli liczbę przez @f$2^s@f$, zaokrąglając w dół.
+ * @param a : liczba
+ * @param w : liczba słów
+ * @param s : przesunięcie
+ */
+static void BigShiftRight(limb_t *a, size_t w, size_t s) {
+    limb_t ext = BigIsNeg(a, w) ? ~0UL : 0;
+    size_t limbs = s / LIMB_BITS, bits = s % LIMB_BITS;
+    for (size_t i = 0; i < w; i++) {
+        size_t j = i + limbs;
+        limb_t lo = (j < w) ? a[j] : ext;
+        limb_t hi = (j + 1 < w) ? a[j + 1] : ext;
+        a[i] = (bits == 0) ? lo : ((lo >> bits) | (hi << (LIMB_BITS - bits)));
+    }
+}
+
+/**
+ * Tworzy wielomian o liczbowych współczynnikach.
+ * @param c : współczynniki
+ * @param n : liczba współczynników
+ * @return wielomian
+ */
+static BigPoly BigPolyFromCoeffs(const poly_coeff_t *c, size_t n) {
+    BigPoly q = {.n = n, .w = 1};
+    q.d = (limb_t *) malloc(n * sizeof(limb_t));
+    for (size_t i = 0; i < n; i++) {
+        q.d[i] = (limb_t) c[i];
+    }
+    return q;
+}
+
+/**
+ * Tworzy kopię wielomianu.
+ * @param q : wielomian
+ * @return kopia
+ */
+static BigPoly BigPolyClone(const BigPoly *q) {
+    BigPoly r = *q;
+    r.d = (limb_t *) malloc(q->n * q->w * sizeof(limb_t));
+    memcpy(r.d, q->d, q->n * q->w * sizeof(limb_t));
+    return r;
+}
+
+/**
+ * Usuwa wielomian z pamięci.
+ * @param q : wielomian
+ */
+static void BigPolyDestroy(BigPoly *q) {
+    free(q->d);
+}
+
+/**
+ * Liczy największą liczbę bitów modułu współczynnika.
+ * @param q : wielomian
+ * @return liczba bitów
+ */
+static size_t BigPolyMaxBits(const BigPoly *q) {
+    size_t bits = 0;
+    for (size_t i = 0; i < q->n; i++) {
+        size_t b = BigBits(BigCoeff(q, i), q->w);
+        if (b > bits) {
+            bits = b;
+        }
+    }
+    return bits;
+}
+
+/**
+ * Zmienia liczbę słów współczynników tak, by mieściły się w nich liczby
+ * o module nie większym niż @f$2^{bits}@f$. Zmniejszenie jest poprawne,
+ * jeśli bieżące współczynniki mieszczą się w nowej liczbie słów.
+ * @param q : wielomian
+ * @param bits : liczba bitów modułu
+ */
+static void BigPolyResize(BigPoly *q, size_t bits) {
+    size_t w = (bits + 1) / LIMB_BITS + 1;
+    if (w == q->w) {
+        return;
+    }
+
+    limb_t *d = (limb_t *) malloc(q->n * w * sizeof(limb_t));
+    size_t common = (w < q->w) ? w : q->w;
+    for (size_t i = 0; i < q->n; i++) {
+        const limb_t *a = BigCoeff(q, i);
+        limb_t ext = BigIsNeg(a, q->w) ? ~0UL : 0;
+        memcpy(d + i * w, a, common * sizeof(limb_t));
+        for (size_t j = common; j < w; j++) {
+            d[i * w + j] = ext;
+        }
+    }
+    free(q->d);
+    q->d = d;
+    q->w = w;
+}
+
+/**
+ * Zapewnia miejsce na współczynniki o module nie większym niż
+ * @f$2^{bits}@f$.
+ * @param q : wielomian
+ * @param bits : liczba bitów modułu
+ */
+static void BigPolyReserve(BigPoly *q, size_t bits) {
+    if ((bits + 1) / LIMB_BITS + 1 > q->w) {
+        BigPolyResize(q, bits);
+    }
+}
+
+/**
+ * Odwraca kolejność współczynników: @f$x^d q(1/x)@f$.
+ * @param q : wielomian
+ */
+static void BigPolyReverse(BigPoly *q) {
+    limb_t *tmp = (limb_t *) malloc(q->w * sizeof(limb_t));
+    for (size_t i = 0, j = q->n - 1; i < j; i++, j--) {
+        memcpy(tmp, BigCoeff(q, i), q->w * sizeof(limb_t));
+        memcpy(BigCoeff(q, i), BigCoeff(q, j), q->w * sizeof(limb_t));
+        memcpy(BigCoeff(q, j), tmp, q->w * sizeof(limb_t));
+    }
+    free(tmp);
+}
+
+/**
+ * Przenosi nadmiar cyfr liczby zapisanej w cyfrach NAIL_BITS-bitowych
+ * ze znakiem: wszystkie cyfry poza najwyższą trafiają do przedziału
+ * @f$[0, 2^{NAIL\_BITS})@f$.
+ * @param x : cyfry, od najmniej znaczącej
+ * @param wd : liczba cyfr
+ */
+static void NailsNormalize(limb_t *x, size_t wd) {
+    long carry = 0;
+    for (size_t k = 0; k + 1 < wd; k++) {
+        long v = (long) x[k] + carry;
+        x[k] = (limb_t) v & ((1UL << NAIL_BITS) - 1);
+        carry = v >> NAIL_BITS;
+    }
+    x[wd - 1] += (limb_t) carry;
+}
+
+/**
+ * Przesuwa o 1 wielomian o współczynnikach zapisanych w cyfrach
+ * NAIL_BITS-bitowych. Krok @f$t@f$ schematu Hornera dodaje do każdego
+ * współczynnika @f$j \ge n - 2 - t@f$ następny współczynnik sprzed kroku,
+ * więc cyfry dodaje się niezależnie, bez przeniesień. Przeniesienia
+ * wykonuje się co NAIL_PASSES kroków, a kroki te przechodzą kolejno bloki
+ * współczynników mieszczące się w pamięci podręcznej, od najwyższych.
+ * Blok zapamiętuje swój najniższy współczynnik przed każdym krokiem, bo
+ * potrzebuje go blok sąsiedni.
+ * @param x : współczynniki, po @p wd znormalizowanych cyfr
+ * @param n : liczba współczynników
+ * @param wd : liczba cyfr współczynnika
+ */
+static void NailsShiftOne(limb_t *x, size_t n, size_t wd) {
+    size_t block = SHIFT_BLOCK_BYTES / (wd * sizeof(limb_t));
+    if (block == 0) {
+        block = 1;
+    }
+    limb_t *in = (limb_t *) malloc(NAIL_PASSES * wd * sizeof(limb_t));
+    limb_t *out = (limb_t *) malloc(NAIL_PASSES * wd * sizeof(limb_t));
+
+    for (size_t p = 0; p + 1 < n; p += NAIL_PASSES) {
+        size_t passes = (n - 1 - p < NAIL_PASSES) ? n - 1 - p : NAIL_PASSES;
+        // Najniższy współczynnik zmieniany w tych krokach.
+        size_t first = n - 1 - p - passes;
+        size_t lo;
+        for (size_t hi = n; hi > first; hi = lo) {
+            lo = (hi - first > block) ? hi - block : first;
+            for (size_t t = 0; t < passes; t++) {
+                size_t i = n - 2 - p - t;
+                size_t start = (lo > i) ? lo : i;
+                size_t end = (hi < n) ? hi - 1 : n - 1;
+                memcpy(out + t * wd, x + lo * wd, wd * sizeof(limb_t));
+                if (start < end) {
+                    limb_t *a = x + start * wd;
+                    for (size_t k = 0; k < (end - start) * wd; k++) {
+                        a[k] += a[k + wd];
+                    }
+                }
+                if (hi < n && start < hi) {
+                    limb_t *a = x + (hi - 1) * wd;
+                    for (size_t k = 0; k < wd; k++) {
+                        a[k] += in[t * wd + k];
+                    }
+                }
+            }
+            for (size_t j = lo; j < hi; j++) {
+                NailsNormalize(x + j * wd, wd);
+            }
+            limb_t *tmp = in;
+            in = out;
+            out = tmp;
+        }
+    }
+
+    free(out);
+    free(in);
+}
+
+/**
+ * Przesuwa wielomian o 1: @f$q(x + 1)@f$. Jeśli wynik mieści się w typie
+ * poly_coeff_t, używa szybkiego przesunięcia Taylora, w przeciwnym razie
+ * schematu Hornera na cyfrach z opóźnionym przeniesieniem (NailsShiftOne).
+ * @param q : wielomian
+ */
+static void BigPolyShiftOne(BigPoly *q) {
+    // Współczynniki q(x + 1) mają moduł co najwyżej 2^n max |q_i|.
+    BigPolyReserve(q, BigPolyMaxBits(q) + q->n);
+    if (q->w == 1) {
+        PolyTaylorShiftCoeffs((poly_coeff_t *) q->d, q->n, 1);
+        return;
+    }
+
+    // Najwyższa cyfra zaczyna się powyżej zapisu liczby i niesie jej znak.
+    size_t wd = q->w * LIMB_BITS / NAIL_BITS + 2;
+    limb_t *x = (limb_t *) malloc(q->n * wd * sizeof(limb_t));
+    for (size_t j = 0; j < q->n; j++) {
+        for (size_t k = 0; k < wd; k++) {
+            x[j * wd + k] = BigGetBits(BigCoeff(q, j), q->w, k * NAIL_BITS,
+                                       (k + 1 < wd) ? NAIL_BITS : LIMB_BITS);
+        }
+    }
+
+    NailsShiftOne(x, q->n, wd);
+
+    // Cyfry poza najwyższą są nieujemne, zajmują rozłączne bity i pokrywają
+    // cały zapis liczby, więc najwyższa (znak) nie jest potrzebna.
+    for (size_t j = 0; j < q->n; j++) {
+        const limb_t *y = x + j * wd;
+        limb_t *a = BigCoeff(q, j);
+        for (size_t i = 0; i < q->w; i++) {
+            size_t pos = i * LIMB_BITS;
+            limb_t v = 0;
+            for (size_t k = pos / NAIL_BITS; k * NAIL_BITS < pos + LIMB_BITS; k++) {
+                if (k * NAIL_BITS >= pos) {
+                    v |= y[k] << (k * NAIL_BITS - pos);
+                }
+                else {
+                    v |= y[k] >> (pos - k * NAIL_BITS);
+                }
+            }
+            a[i] = v;
+        }
+    }
+    free(x);
+}
+
+/**
+ * Zastępuje wielomian przez @f$2^d q(x/2)@f$ podzielony przez największą
+ * wspólną potęgę dwójki współczynników. Pierwiastki z przedziału
+ * @f$(0, 1/2)@f$ przechodzą na przedział @f$(0, 1)@f$.
+ * @param q : niezerowy wielomian stopnia @f$d@f$
+ */
+static void BigPolyHalve(BigPoly *q) {
+    size_t d = q->n - 1;
+    size_t t = (size_t) -1;
+    for (size_t i = 0; i < q->n; i++) {
+        if (BigSign(BigCoeff(q, i), q->w) != 0) {
+            size_t z = d - i + BigTrailingZeros(BigCoeff(q, i), q->w);
+            if (z < t) {
+                t = z;
+            }
+        }
+    }
+
+    size_t bits = 0;
+    for (size_t i = 0; i < q->n; i++) {
+        size_t b = BigBits(BigCoeff(q, i), q->w);
+        if (b != 0 && d - i >= t && b + (d - i - t) > bits) {
+            bits = b + (d - i - t);
+        }
+    }
+    BigPolyReserve(q, bits);
+
+    for (size_t i = 0; i < q->n; i++) {
+        if (d - i >= t) {
+            BigShiftLeft(BigCoeff(q, i), q->w, d - i - t);
+        }
+        else {
+            BigShiftRight(BigCoeff(q, i), q->w, t - (d - i));
+        }
+    }
+}
+
+/**
+ * Liczy zmiany znaku w ciągu współczynników.
+ * @param q : wielomian
+ * @return liczba zmian znaku
+ */
+static size_t BigPolyVariations(const BigPoly *q) {
+    size_t count = 0;
+    int last = 0;
+    for (size_t i = 0; i < q->n; i++) {
+        int s = BigSign(BigCoeff(q, i), q->w);
+        if (s != 0) {
+            if (last != 0 && s != last) {
+                count++;
+            }
+            last = s;
+        }
+    }
+    return count;
+}
+
+/**
+ * Ogranicza z góry, zgodnie z regułą Kartezjusza, liczbę pierwiastków
+ * wielomianu w przedziale @f$(0, 1)@f$. Jest ona równa liczbie zmian znaku
+ * współczynników @f$(x + 1)^d q(1/(x + 1))@f$.
+ * @param q : wielomian
+ * @return liczba zmian znaku
+ */
+static size_t DescartesBound(const BigPoly *q) {
+    BigPoly t = BigPolyClone(q);
+    BigPolyReverse(&t);
+    BigPolyShiftOne(&t);
+    size_t count = BigPolyVariations(&t);
+    BigPolyDestroy(&t);
+    return count;
+}
+
+/**
+ * Zapisuje przedział @f$(c/2^k, (c + 1)/2^k)@f$ (lub punkt @f$c/2^k@f$)
+ * przeskalowany do przedziału wyszukiwania.
+ * @param s : stan wyszukiwania
+ * @param c : licznik lewego końca
+ * @param k : głębokość podziału
+ * @param exact : czy pierwiastek leży w punkcie @f$c/2^k@f$
+ */
+static void RootSearchAdd(RootSearch *s, poly_coeff_t c, unsigned k, bool exact) {
+    poly_coeff_t left = c, right = exact ? c : c + 1;
+    unsigned scale = 0;
+    if (k >= s->bound) {
+        scale = k - s->bound;
+    }
+    else {
+        left <<= s->bound - k;
+        right <<= s->bound - k;
+    }
+
+    if (s->negative) {
+        s->out[s->count++] = (RootInterval) {.left = -right, .right = -left, .scale = scale};
+    }
+    else {
+        s->out[s->count++] = (RootInterval) {.left = left, .right = right, .scale = scale};
+    }
+}
+
+/**
+ * Izoluje pierwiastki wielomianu leżące w przedziale @f$(0, 1)@f$,
+ * odpowiadającym przedziałowi @f$(c/2^k, (c + 1)/2^k)@f$ wyszukiwania,
+ * oraz pierwiastek w punkcie 0. Niszczy zawartość wielomianu.
+ * @param q : wielomian
+ * @param c : licznik lewego końca
+ * @param k : głębokość podziału
+ * @param s : stan wyszukiwania
+ */
+static void IsolateRoots(BigPoly *q, poly_coeff_t c, unsigned k, RootSearch *s) {
+    if (!s->ok) {
+        return;
+    }
+
+    if (BigSign(BigCoeff(q, 0), q->w) == 0) {
+        RootSearchAdd(s, c, k, true);
+        size_t z = 0;
+        while (z + 1 < q->n && BigSign(BigCoeff(q, z), q->w) == 0) {
+            z++;
+        }
+        memmove(q->d, BigCoeff(q, z), (q->n - z) * q->w * sizeof(limb_t));
+        q->n -= z;
+    }
+    if (q->n <= 1) {
+        return;
+    }
+
+    size_t variations = DescartesBound(q);
+    if (variations == 0) {
+        return;
+    }
+    if (variations == 1) {
+        RootSearchAdd(s, c, k, false);
+        return;
+    }
+    if (k == ROOTS_MAX_DEPTH) {
+        s->ok = false;
+        return;
+    }
+
+    BigPolyHalve(q);
+    BigPoly right = BigPolyClone(q);
+    BigPolyShiftOne(&right);
+    BigPolyResize(q, BigPolyMaxBits(q));
+    BigPolyResize(&right, BigPolyMaxBits(&right));
+    IsolateRoots(q, 2 * c, k + 1, s);
+    IsolateRoots(&right, 2 * c + 1, k + 1, s);
+    BigPolyDestroy(&right);
+}
+
+/**
+ * Liczy, na ilu bitach mieści się moduł współczynnika.
+ * @param a : współczynnik
+ * @return liczba bitów
+ */
+static unsigned CoeffBits(poly_coeff_t a) {
+    unsigned long m = (a < 0) ? -(unsigned long) a : (unsigned long) a;
+    return (m == 0) ? 0 : LIMB_BITS - __builtin_clzl(m);
+}
+
+/**
+ * Wylicza wykładnik @f$m@f$ takiego, że moduły wszystkich pierwiastków są
+ * mniejsze niż @f$2^m@f$ (ograniczenie Fujiwary).
+ * @param c : współczynniki
+ * @param n : liczba współczynników
+ * @return wykładnik @f$m@f$
+ */
+static unsigned RootBound(const poly_coeff_t *c, size_t n) {
+    int lead = (int) CoeffBits(c[n - 1]);
+    unsigned m = 0;
+    for (size_t i = 1; i < n; i++) {
+        if (c[n - 1 - i] != 0) {
+            int e = (int) CoeffBits(c[n - 1 - i]) - lead + 1;
+            unsigned term = (e <= 0) ? 0 : (unsigned) ((e + (int) i - 1) / (int) i);
+            if (term > m) {
+                m = term;
+            }
+        }
+    }
+    return m + 1;
+}
+
+/**
+ * Izoluje pierwiastki dodatnie wielomianu (lub ujemne, jeśli
+ * `s->negative`) o niezerowym wyrazie wolnym.
+ * @param c : współczynniki
+ * @param n : liczba współczynników
+ * @param s : stan wyszukiwania
+ */
+static void IsolateHalfLine(const poly_coeff_t *c, size_t n, RootSearch *s) {
+    BigPoly q = BigPolyFromCoeffs(c, n);
+    if (s->negative) {
+        // q(-x); zmiana znaku -2^63 wymaga drugiego słowa.
+        BigPolyReserve(&q, BigPolyMaxBits(&q));
+        for (size_t i = 1; i < n; i += 2) {
+            BigNegate(BigCoeff(&q, i), q.w);
+        }
+    }
+
+    // Reguła Kartezjusza dla całej półprostej.
+    size_t variations = BigPolyVariations(&q);
+    s->bound = RootBound(c, n);
+    if (variations == 1) {
+        RootSearchAdd(s, 0, 0, false);
+    }
+    else if (variations > 1) {
+        if (s->bound > ROOTS_MAX_BOUND) {
+            s->ok = false;
+        }
+        else {
+            // q(2^m x) ma pierwiastki w przedziale (0, 1).
+            BigPolyReserve(&q, BigPolyMaxBits(&q) + s->bound * (n - 1));
+            for (size_t i = 1; i < n; i++) {
+                BigShiftLeft(BigCoeff(&q, i), q.w, s->bound * i);
+            }
+            IsolateRoots(&q, 0, 0, s);
+        }
+    }
+    BigPolyDestroy(&q);
+}
+
+bool PolyRealRootIntervals(const Poly *p, RootInterval out[], size_t *count) {
+    *count = 0;
+    if (PolyIsZero(p)) {
+        return false;
+    }
+
+    poly_exp_t deg = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        if (!PolyIsCoeff(&(l->head->poly))) {
+            return false;
+        }
+        deg = l->head->exp;
+    }
+    if (deg == 0) {
+        return true;
+    }
+
+    size_t n = (size_t) deg + 1;
+    poly_coeff_t *c = (poly_coeff_t *) calloc(n, sizeof(poly_coeff_t));
+    c[0] = p->coeff;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        c[l->head->exp] += l->head->poly.coeff;
+    }
+
+    // Dzielimy przez x^z, pierwiastek 0 zapisujemy osobno.
+    size_t z = 0;
+    while (c[z] == 0) {
+        z++;
+    }
+
+    RootSearch s = {.out = out, .count = 0, .negative = true, .ok = true};
+    IsolateHalfLine(c + z, n - z, &s);
+    for (size_t i = 0, j = s.count - 1; i < s.count && i < j; i++, j--) {
+        RootInterval tmp = out[i];
+        out[i] = out[j];
+        out[j] = tmp;
+    }
+    if (z > 0) {
+        out[s.count++] = (RootInterval) {.left = 0, .right = 0, .scale = 0};
+    }
+    s.negative = false;
+    if (s.ok) {
+        IsolateHalfLine(c + z, n - z, &s);
+    }
+
+    free(c);
+    *count = s.count;
+    return s.ok;
+}
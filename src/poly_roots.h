@@ -0,0 +1,50 @@
+/** @file
+   Interfejs izolacji pierwiastków rzeczywistych wielomianów jednej zmiennej
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_ROOTS_H__
+#define __POLY_ROOTS_H__
+
+#include "poly.h"
+
+/**
+ * Przedział izolujący pierwiastek rzeczywisty.
+ * Końcami przedziału są liczby diadyczne `left / 2^scale`
+ * i `right / 2^scale`. Jeśli `left == right`, to pierwiastek leży dokładnie
+ * w tym punkcie, w przeciwnym razie przedział jest otwarty i zawiera
+ * dokładnie jeden pierwiastek.
+ */
+typedef struct RootInterval {
+    poly_coeff_t left; ///< licznik lewego końca
+    poly_coeff_t right; ///< licznik prawego końca
+    unsigned scale; ///< wykładnik potęgi dwójki w mianowniku
+} RootInterval;
+
+/**
+ * Izoluje pierwiastki rzeczywiste wielomianu zmiennej @f$x_0@f$
+ * (współczynniki muszą być liczbami) metodą Vincenta-Collinsa-Akritasa:
+ * przedziały są dzielone na połowy, dopóki reguła znaków Kartezjusza nie
+ * rozstrzygnie liczby pierwiastków. Obliczenia są dokładne. Przesunięcie
+ * @f$q(x + 1)@f$ wielomianu stopnia @f$n@f$ może wydłużyć współczynniki
+ * o @f$n@f$ bitów, więc szybkie przesunięcie Taylora na typie
+ * poly_coeff_t wystarcza tylko dla stopni poniżej około 60. Dla wyższych
+ * przesunięcie jest klasyczne, na liczbach wielu słów, o koszcie
+ * @f$O(n^2)@f$ dodawań na słowo współczynnika, a współczynniki mają
+ * @f$O(n)@f$ słów. Koszt całej izolacji rośnie więc mniej więcej jak
+ * czwarta potęga stopnia: metoda nadaje się do stopni rzędu kilku tysięcy
+ * (stopień 3000 to dziesiątki sekund), a nie dziesiątek tysięcy.
+ * Wielomian nie powinien mieć pierwiastków wielokrotnych (poza zerem),
+ * w przeciwnym razie izolacja może się nie udać.
+ * @param[in] p : wielomian
+ * @param[out] out : tablica na co najmniej `PolyDeg(p)` przedziałów
+ * @param[out] count : liczba znalezionych pierwiastków
+ * @return Czy udało się wyznaczyć przedziały? Fałsz, gdy wielomian nie jest
+ * niezerowym wielomianem jednej zmiennej, gdy ma pierwiastki wielokrotne
+ * lub gdy pierwiastki leżą bliżej siebie niż @f$2^{-61}@f$.
+ */
+bool PolyRealRootIntervals(const Poly *p, RootInterval out[], size_t *count);
+
+#endif /* __POLY_ROOTS_H__ */
@@ -0,0 +1,365 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include "poly.h"
+#include "poly_sched.h"
+
+/** Pojemność kolejki zadań wątku (potęga dwójki) */
+#define SCHED_DEQUE_SIZE 4096
+
+/** Koszt, od którego obliczenie jest rozgałęziane */
+#define SCHED_FORK_CUTOFF 32
+
+/** Liczba nieudanych przeglądów kolejek, po której wątek zasypia */
+#define SCHED_IDLE_ROUNDS 64
+
+/**
+ * Kolejka zadań wątku. Właściciel odkłada i zdejmuje zadania z dołu,
+ * a pozostałe wątki podkradają je z góry.
+ */
+typedef struct SchedDeque {
+    atomic_long top; ///< indeks najstarszego zadania
+    atomic_long bottom; ///< indeks za najnowszym zadaniem
+    _Atomic(PolyTask *) tasks[SCHED_DEQUE_SIZE]; ///< zadania
+} SchedDeque;
+
+/**
+ * Planista zadań.
+ */
+struct PolySched {
+    unsigned threads; ///< liczba wątków wraz z wywołującym
+    unsigned started; ///< liczba utworzonych wątków wraz z wywołującym
+    SchedDeque *deques; ///< kolejki, kolejka 0 należy do wątku wywołującego
+    pthread_t *tids; ///< wątki planisty (indeksy od 1)
+    pthread_mutex_t caller_lock; ///< blokada wątku wywołującego
+    pthread_mutex_t lock; ///< blokada usypiania wątków
+    pthread_cond_t wake; ///< budzenie uśpionych wątków
+    atomic_uint sleepers; ///< liczba uśpionych wątków
+    atomic_bool stop; ///< czy wątki mają się zakończyć
+};
+
+/**
+ * Planista i kolejka bieżącego wątku.
+ */
+typedef struct SchedContext {
+    PolySched *sched; ///< planista lub NULL poza planistą
+    unsigned index; ///< indeks kolejki wątku
+    unsigned seed; ///< stan generatora wyboru wątków do podkradania
+} SchedContext;
+
+/** Planista, w ramach którego działa bieżący wątek */
+static _Thread_local SchedContext sched_context;
+
+/**
+ * Argument wątku planisty.
+ */
+typedef struct SchedWorkerArg {
+    PolySched *sched; ///< planista
+    unsigned index; ///< indeks kolejki wątku
+} SchedWorkerArg;
+
+/**
+ * Odkłada zadanie na dół kolejki. Wywoływana tylko przez właściciela.
+ * @param d : kolejka
+ * @param task : zadanie
+ * @return Czy zadanie się zmieściło?
+ */
+static bool DequePush(SchedDeque *d, PolyTask *task) {
+    long b = atomic_load_explicit(&(d->bottom), memory_order_relaxed);
+    long t = atomic_load_explicit(&(d->top), memory_order_acquire);
+    if (b - t >= SCHED_DEQUE_SIZE) {
+        return false;
+    }
+    atomic_store_explicit(&(d->tasks[b & (SCHED_DEQUE_SIZE - 1)]), task,
+                          memory_order_relaxed);
+    atomic_store_explicit(&(d->bottom), b + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * Zdejmuje zadanie z dołu kolejki. Wywoływana tylko przez właściciela.
+ * @param d : kolejka
+ * @return zadanie lub NULL, gdy kolejka jest pusta
+ */
+static PolyTask *DequePop(SchedDeque *d) {
+    long b = atomic_load_explicit(&(d->bottom), memory_order_relaxed) - 1;
+    atomic_store_explicit(&(d->bottom), b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&(d->top), memory_order_relaxed);
+    PolyTask *task = NULL;
+    if (t <= b) {
+        task = atomic_load_explicit(&(d->tasks[b & (SCHED_DEQUE_SIZE - 1)]),
+                                    memory_order_relaxed);
+        if (t == b) {
+            // Ostatnie zadanie - rywalizujemy o nie z podkradającymi.
+            if (!atomic_compare_exchange_strong_explicit(&(d->top), &t, t + 1,
+                                                         memory_order_seq_cst,
+                                                         memory_order_relaxed)) {
+                task = NULL;
+            }
+            atomic_store_explicit(&(d->bottom), b + 1, memory_order_relaxed);
+        }
+    }
+    else {
+        atomic_store_explicit(&(d->bottom), b + 1, memory_order_relaxed);
+    }
+    return task;
+}
+
+/**
+ * Podkrada zadanie z góry kolejki.
+ * @param d : kolejka
+ * @return zadanie lub NULL, gdy kolejka jest pusta lub inny wątek był
+ * szybszy
+ */
+static PolyTask *DequeSteal(SchedDeque *d) {
+    long t = atomic_load_explicit(&(d->top), memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&(d->bottom), memory_order_acquire);
+    if (t >= b) {
+        return NULL;
+    }
+    PolyTask *task = atomic_load_explicit(&(d->tasks[t & (SCHED_DEQUE_SIZE - 1)]),
+                                          memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&(d->top), &t, t + 1,
+                                                 memory_order_seq_cst,
+                                                 memory_order_relaxed)) {
+        return NULL;
+    }
+    return task;
+}
+
+/**
+ * Wykonuje zadanie i oznacza je jako wykonane. Zadanie zaczyna bez błędu,
+ * a po nim wątek wraca do swojego kodu błędu - zadanie może się wykonać
+ * w trakcie czekania na inne, w wątku, którego obliczenie już zgłosiło błąd.
+ * @param task : zadanie
+ */
+static void TaskRun(PolyTask *task) {
+    PolyError saved = PolyLastError();
+    PolyClearError();
+    task->run(task);
+    task->error = PolyLastError();
+    PolyRestoreError(saved);
+    atomic_store_explicit(&(task->done), true, memory_order_release);
+}
+
+/**
+ * Próbuje podkraść zadanie z kolejki innego wątku, zaczynając od
+ * losowo wybranej.
+ * @param ctx : kontekst bieżącego wątku
+ * @return zadanie lub NULL
+ */
+static PolyTask *SchedStealAny(SchedContext *ctx) {
+    PolySched *s = ctx->sched;
+    ctx->seed = ctx->seed * 1103515245u + 12345u;
+    unsigned start = (ctx->seed >> 16) % s->threads;
+    for (unsigned k = 0; k < s->threads; k++) {
+        unsigned victim = (start + k) % s->threads;
+        if (victim != ctx->index) {
+            PolyTask *task = DequeSteal(&(s->deques[victim]));
+            if (task != NULL) {
+                return task;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Sprawdza, czy w którejś kolejce są zadania.
+ * @param s : planista
+ * @return Czy są zadania do podkradzenia?
+ */
+static bool SchedHasWork(PolySched *s) {
+    for (unsigned k = 0; k < s->threads; k++) {
+        SchedDeque *d = &(s->deques[k]);
+        if (atomic_load(&(d->top)) < atomic_load(&(d->bottom))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Pętla wątku planisty: podkrada i wykonuje zadania, a gdy długo ich
+ * nie ma - zasypia do czasu odłożenia nowego zadania.
+ * @param arg : argument wątku (SchedWorkerArg)
+ * @return NULL
+ */
+static void *SchedWorker(void *arg) {
+    SchedWorkerArg *worker = (SchedWorkerArg *) arg;
+    PolySched *s = worker->sched;
+    sched_context = (SchedContext) {.sched = s, .index = worker->index,
+                                    .seed = worker->index};
+    free(worker);
+
+    unsigned idle = 0;
+    while (!atomic_load(&(s->stop))) {
+        PolyTask *task = SchedStealAny(&sched_context);
+        if (task != NULL) {
+            TaskRun(task);
+            idle = 0;
+        }
+        else if (++idle < SCHED_IDLE_ROUNDS) {
+            sched_yield();
+        }
+        else {
+            pthread_mutex_lock(&(s->lock));
+            atomic_fetch_add(&(s->sleepers), 1);
+            if (!atomic_load(&(s->stop)) && !SchedHasWork(s)) {
+                pthread_cond_wait(&(s->wake), &(s->lock));
+            }
+            atomic_fetch_sub(&(s->sleepers), 1);
+            pthread_mutex_unlock(&(s->lock));
+            idle = 0;
+        }
+    }
+    sched_context.sched = NULL;
+    return NULL;
+}
+
+PolySched *PolySchedNew(unsigned threads) {
+    PolySched *s = (PolySched *) malloc(sizeof(struct PolySched));
+    s->threads = (threads == 0) ? 1 : threads;
+    s->deques = (SchedDeque *) calloc(s->threads, sizeof(SchedDeque));
+    s->tids = (pthread_t *) malloc(s->threads * sizeof(pthread_t));
+    pthread_mutex_init(&(s->caller_lock), NULL);
+    pthread_mutex_init(&(s->lock), NULL);
+    pthread_cond_init(&(s->wake), NULL);
+    atomic_init(&(s->sleepers), 0);
+    atomic_init(&(s->stop), false);
+
+    // Wątki, których nie udało się utworzyć, po prostu nie podkradają
+    // zadań - ich kolejki pozostają puste.
+    s->started = 1;
+    for (unsigned t = 1; t < s->threads; t++) {
+        SchedWorkerArg *arg = (SchedWorkerArg *) malloc(sizeof(SchedWorkerArg));
+        *arg = (SchedWorkerArg) {.sched = s, .index = t};
+        if (pthread_create(&(s->tids[t]), NULL, SchedWorker, arg) != 0) {
+            free(arg);
+            break;
+        }
+        s->started++;
+    }
+    return s;
+}
+
+void PolySchedDestroy(PolySched *s) {
+    if (s == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&(s->lock));
+    atomic_store(&(s->stop), true);
+    pthread_cond_broadcast(&(s->wake));
+    pthread_mutex_unlock(&(s->lock));
+    for (unsigned t = 1; t < s->started; t++) {
+        pthread_join(s->tids[t], NULL);
+    }
+    pthread_cond_destroy(&(s->wake));
+    pthread_mutex_destroy(&(s->lock));
+    pthread_mutex_destroy(&(s->caller_lock));
+    free(s->tids);
+    free(s->deques);
+    free(s);
+}
+
+bool PolyTaskShouldFork(size_t cost) {
+    return sched_context.sched != NULL && sched_context.sched->threads > 1
+           && cost >= SCHED_FORK_CUTOFF;
+}
+
+void PolyTaskFork(PolyTask *task) {
+    atomic_init(&(task->done), false);
+    PolySched *s = sched_context.sched;
+    if (s == NULL || !DequePush(&(s->deques[sched_context.index]), task)) {
+        TaskRun(task);
+        return;
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load(&(s->sleepers)) > 0) {
+        pthread_mutex_lock(&(s->lock));
+        pthread_cond_signal(&(s->wake));
+        pthread_mutex_unlock(&(s->lock));
+    }
+}
+
+PolyError PolyTaskJoin(PolyTask *task) {
+    while (!atomic_load_explicit(&(task->done), memory_order_acquire)) {
+        // Najpierw zadania z własnej kolejki (zwykle właśnie to zadanie),
+        // a gdy ktoś je podkradł - pomagamy innym wątkom.
+        PolyTask *other = DequePop(&(sched_context.sched->deques[sched_context.index]));
+        if (other == NULL) {
+            other = SchedStealAny(&sched_context);
+        }
+        if (other != NULL) {
+            TaskRun(other);
+        }
+        else {
+            sched_yield();
+        }
+    }
+    return task->error;
+}
+
+/**
+ * Rozpoczyna operację w wątku wywołującym: wątek przejmuje kolejkę 0.
+ * W wątku planisty (wywołanie zagnieżdżone) nic nie robi.
+ * @param s : planista
+ * @return Czy trzeba wywołać SchedLeave?
+ */
+static bool SchedEnter(PolySched *s) {
+    if (sched_context.sched != NULL) {
+        return false;
+    }
+    pthread_mutex_lock(&(s->caller_lock));
+    sched_context = (SchedContext) {.sched = s, .index = 0, .seed = 0};
+    return true;
+}
+
+/**
+ * Kończy operację rozpoczętą przez SchedEnter.
+ * @param s : planista
+ * @param entered : wynik SchedEnter
+ */
+static void SchedLeave(PolySched *s, bool entered) {
+    if (entered) {
+        sched_context.sched = NULL;
+        pthread_mutex_unlock(&(s->caller_lock));
+    }
+}
+
+void PolySchedRun(PolySched *s, PolyTask *task) {
+    bool entered = SchedEnter(s);
+    atomic_init(&(task->done), false);
+    TaskRun(task);
+    SchedLeave(s, entered);
+}
+
+Poly PolySchedMul(PolySched *s, const Poly *p, const Poly *q) {
+    bool entered = SchedEnter(s);
+    Poly res = PolyMul(p, q);
+    SchedLeave(s, entered);
+    return res;
+}
+
+Poly PolySchedAdd(PolySched *s, const Poly *p, const Poly *q) {
+    bool entered = SchedEnter(s);
+    Poly res = PolyAdd(p, q);
+    SchedLeave(s, entered);
+    return res;
+}
+
+Poly PolySchedAt(PolySched *s, const Poly *p, poly_coeff_t x) {
+    bool entered = SchedEnter(s);
+    Poly res = PolyAt(p, x);
+    SchedLeave(s, entered);
+    return res;
+}
+
+bool PolySchedIsEq(PolySched *s, const Poly *p, const Poly *q) {
+    bool entered = SchedEnter(s);
+    bool res = PolyIsEq(p, q);
+    SchedLeave(s, entered);
+    return res;
+}
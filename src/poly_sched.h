@@ -0,0 +1,135 @@
+/** @file
+   Interfejs planisty zadań z podkradaniem pracy
+
+   Operacje na wielomianach zagnieżdżonych schodzą rekurencyjnie do
+   współczynników kolejnych jednomianów, a te wywołania są od siebie
+   niezależne. Planista pozwala je wykonywać równolegle: każdy wątek ma
+   własną kolejkę zadań (deque Chase'a-Leva), do której odkłada zadania
+   i z której zdejmuje je bez blokad, a bezczynne wątki podkradają zadania
+   z przeciwnego końca cudzych kolejek.
+
+   Operacje z poly.c rozgałęziają się tylko wtedy, gdy wątek działa
+   w ramach planisty (PolySchedMul i pokrewne) i podproblem jest
+   wystarczająco duży; w pozostałych przypadkach działają sekwencyjnie
+   tak jak dotąd. Wyniki nie zależą od liczby wątków.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_SCHED_H__
+#define __POLY_SCHED_H__
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include "poly.h"
+
+/**
+ * Planista zadań.
+ */
+typedef struct PolySched PolySched;
+
+/**
+ * Zadanie planisty. Struktura należy do wątku, który rozgałęzia
+ * obliczenie, i musi istnieć aż do powrotu z PolyTaskJoin.
+ */
+typedef struct PolyTask {
+    void (*run)(struct PolyTask *task); ///< funkcja wykonująca zadanie
+    PolyError error; ///< kod błędu zgłoszonego przez zadanie
+    atomic_bool done; ///< czy zadanie zostało wykonane
+} PolyTask;
+
+/**
+ * Tworzy planistę z pulą wątków. Wątek wywołujący operacje planisty
+ * również wykonuje zadania, więc tworzonych jest `threads - 1` wątków.
+ * @param[in] threads : łączna liczba wątków (0 traktowane jest jak 1)
+ * @return planista
+ */
+PolySched *PolySchedNew(unsigned threads);
+
+/**
+ * Kończy wątki planisty i usuwa go z pamięci.
+ * @param[in] s : planista
+ */
+void PolySchedDestroy(PolySched *s);
+
+/**
+ * Mnoży dwa wielomiany tak jak PolyMul, rozgałęziając obliczenia
+ * współczynników na wątki planisty. Wywołania z różnych wątków
+ * korzystające z tego samego planisty wykonywane są po kolei.
+ * @param[in] s : planista
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @return `p * q`
+ */
+Poly PolySchedMul(PolySched *s, const Poly *p, const Poly *q);
+
+/**
+ * Dodaje dwa wielomiany tak jak PolyAdd, korzystając z planisty.
+ * @param[in] s : planista
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @return `p + q`
+ */
+Poly PolySchedAdd(PolySched *s, const Poly *p, const Poly *q);
+
+/**
+ * Wylicza wartość wielomianu tak jak PolyAt, korzystając z planisty.
+ * @param[in] s : planista
+ * @param[in] p : wielomian
+ * @param[in] x : wartość argumentu
+ * @return @f$p(x, x_0, x_1, \ldots)@f$
+ */
+Poly PolySchedAt(PolySched *s, const Poly *p, poly_coeff_t x);
+
+/**
+ * Sprawdza równość wielomianów tak jak PolyIsEq, korzystając z planisty.
+ * @param[in] s : planista
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @return `p = q`
+ */
+bool PolySchedIsEq(PolySched *s, const Poly *p, const Poly *q);
+
+/**
+ * Wykonuje zadanie w wątku wywołującym w ramach planisty, tak że
+ * rozgałęzienia wykonywane przez zadanie trafiają do wątków planisty.
+ * Wywołania z różnych wątków korzystające z tego samego planisty
+ * wykonywane są po kolei. Błąd zadania zapisywany jest w polu `error`
+ * zadania, a kod błędu wątku wywołującego się nie zmienia. Funkcja dla
+ * modułów biblioteki.
+ * @param[in] s : planista
+ * @param[in] task : zadanie z ustawionym polem `run`
+ */
+void PolySchedRun(PolySched *s, PolyTask *task);
+
+/**
+ * Sprawdza, czy opłaca się rozgałęzić obliczenie o zadanym koszcie,
+ * czyli czy bieżący wątek działa w ramach planisty, a koszt przekracza
+ * próg. Funkcja dla modułów biblioteki.
+ * @param[in] cost : szacowany koszt, np. liczba elementów list
+ * @return Czy rozgałęzić obliczenie?
+ */
+bool PolyTaskShouldFork(size_t cost);
+
+/**
+ * Odkłada zadanie do kolejki bieżącego wątku, skąd mogą je podkraść inne
+ * wątki. Poza planistą albo przy pełnej kolejce zadanie wykonywane jest
+ * od razu. Funkcja dla modułów biblioteki.
+ * @param[in] task : zadanie z ustawionym polem `run`
+ */
+void PolyTaskFork(PolyTask *task);
+
+/**
+ * Czeka na wykonanie zadania odłożonego przez PolyTaskFork. W trakcie
+ * czekania wątek wykonuje zadania ze swojej kolejki lub podkradzione.
+ * Każde zadanie wykonywane jest od wyzerowanego kodu błędu, a potem
+ * wątek, który je wykonał, wraca do swojego kodu. Błąd zadania nie
+ * ustawia się więc w żadnym wątku, tylko jest zwracany. Funkcja dla
+ * modułów biblioteki.
+ * @param[in] task : zadanie
+ * @return kod błędu zgłoszonego przez zadanie lub POLY_OK
+ */
+PolyError PolyTaskJoin(PolyTask *task);
+
+#endif /* __POLY_SCHED_H__ */
@@ -0,0 +1,537 @@
+#include <stdlib.h>
+#include "poly.h"
+#include "poly_series.h"
+
+/** Największy dopuszczalny moduł operacji na szeregach */
+#define SERIES_MAX_MOD 2147483647L
+
+
+
+/**
+ * Redukuje liczbę modulo @p m do przedziału `[0, m)`.
+ * @param c : liczba
+ * @param m : moduł (0 oznacza brak redukcji)
+ * @return `c mod m`
+ */
+static poly_coeff_t CoeffMod(poly_coeff_t c, poly_coeff_t m) {
+    if (m == 0) {
+        return c;
+    }
+    c %= m;
+    return (c < 0) ? c + m : c;
+}
+
+/**
+ * @param a : liczba (z przedziału `[0, m)`, gdy `m != 0`)
+ * @param b : liczba (z przedziału `[0, m)`, gdy `m != 0`)
+ * @param m : moduł (0 oznacza brak redukcji)
+ * @return `a * b mod m`
+ */
+static poly_coeff_t CoeffMulMod(poly_coeff_t a, poly_coeff_t b, poly_coeff_t m) {
+    return CoeffMod(a * b, m);
+}
+
+/**
+ * @param a : liczba niepodzielna przez @p m
+ * @param m : moduł - liczba pierwsza
+ * @return odwrotność @p a modulo @p m
+ */
+static poly_coeff_t CoeffInvMod(poly_coeff_t a, poly_coeff_t m) {
+    poly_coeff_t res = 1;
+    poly_coeff_t base = CoeffMod(a, m);
+    for (poly_coeff_t e = m - 2; e > 0; e >>= 1) {
+        if (e & 1) {
+            res = CoeffMulMod(res, base, m);
+        }
+        base = CoeffMulMod(base, base, m);
+    }
+    return res;
+}
+
+/**
+ * @param m : moduł
+ * @return Czy moduł jest dopuszczalny dla operacji na szeregach?
+ */
+static bool SeriesModIsValid(poly_coeff_t m) {
+    return (m > 2) && (m <= SERIES_MAX_MOD);
+}
+
+/**
+ * Redukuje wszystkie współczynniki wielomianu modulo @p m.
+ * @param p : wielomian
+ * @param m : moduł (0 oznacza zwykłą kopię)
+ * @return wielomian o współczynnikach z przedziału `[0, m)`
+ */
+static Poly PolyReduceMod(const Poly *p, poly_coeff_t m) {
+    if (m == 0) {
+        return PolyClone(p);
+    }
+
+    unsigned count = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        count++;
+    }
+    Mono *monos = (Mono *) malloc((count + 1) * sizeof(struct Mono));
+    unsigned n = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        Poly r = PolyReduceMod(&(l->head->poly), m);
+        monos[n++] = MonoFromPoly(&r, l->head->exp);
+    }
+    Poly res = PolyAddMonos(n, monos);
+    res.coeff = CoeffMod(res.coeff + CoeffMod(p->coeff, m), m);
+    free(monos);
+    return res;
+}
+
+/**
+ * Zastępuje wielomian wskazywany przez @p p jego redukcją modulo @p m.
+ * @param p : wielomian
+ * @param m : moduł (0 oznacza brak redukcji)
+ */
+static void PolyReduceModInPlace(Poly *p, poly_coeff_t m) {
+    if (m != 0) {
+        Poly r = PolyReduceMod(p, m);
+        PolyDestroy(p);
+        *p = r;
+    }
+}
+
+/**
+ * Wyraz szeregu: współczynnik i wykładnik przy @f$x_0@f$.
+ */
+typedef struct SeriesTerm {
+    const Poly *poly; ///< współczynnik
+    poly_exp_t exp; ///< wykładnik
+} SeriesTerm;
+
+/**
+ * Wypisuje wyrazy wielomianu w kolejności rosnących wykładników.
+ * Wyraz wolny wielomianu jest wskazywany przez @p constant.
+ * @param p : wielomian
+ * @param constant : miejsce na wielomian stały równy wyrazowi wolnemu @p p
+ * @param count : tu zapisywana jest liczba wyrazów
+ * @return tablica wyrazów
+ */
+static SeriesTerm *SeriesTerms(const Poly *p, Poly *constant, unsigned *count) {
+    unsigned size = 1;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        size++;
+    }
+
+    SeriesTerm *terms = (SeriesTerm *) malloc(size * sizeof(SeriesTerm));
+    *constant = PolyFromCoeff(p->coeff);
+    *count = 0;
+    if (p->coeff != 0) {
+        terms[(*count)++] = (SeriesTerm) {.poly = constant, .exp = 0};
+    }
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        terms[(*count)++] = (SeriesTerm) {.poly = &(l->head->poly), .exp = l->head->exp};
+    }
+    return terms;
+}
+
+/**
+ * Suma iloczynów wyrazów pogrupowanych według wykładnika przy @f$x_0@f$.
+ * Iloczyny sumowane są w gęstej tablicy indeksowanej wykładnikiem, jeśli
+ * nie jest ona dużo większa od liczby par wyrazów, a w przeciwnym razie
+ * zbierane są jako jednomiany i sumowane przez PolyAddMonos.
+ */
+typedef struct SeriesAcc {
+    Poly *dense; ///< sumy dla kolejnych wykładników (lub NULL)
+    Mono *monos; ///< zebrane jednomiany (gdy nie ma tablicy gęstej)
+    size_t size; ///< ograniczenie wykładników
+    unsigned count; ///< liczba zebranych jednomianów
+    poly_coeff_t mod; ///< moduł (0 oznacza brak redukcji)
+} SeriesAcc;
+
+/**
+ * Inicjuje pustą sumę.
+ * @param acc : suma
+ * @param size : ograniczenie wykładników
+ * @param pairs : największa liczba dodawanych iloczynów
+ * @param m : moduł (0 oznacza brak redukcji)
+ */
+static void SeriesAccInit(SeriesAcc *acc, size_t size, size_t pairs, poly_coeff_t m) {
+    acc->size = size;
+    acc->count = 0;
+    acc->mod = m;
+    if (size <= 2 * pairs + 64) {
+        acc->dense = (Poly *) malloc(size * sizeof(struct Poly));
+        acc->monos = NULL;
+        for (size_t i = 0; i < size; i++) {
+            acc->dense[i] = PolyZero();
+        }
+    }
+    else {
+        acc->dense = NULL;
+        acc->monos = (Mono *) malloc(pairs * sizeof(struct Mono));
+    }
+}
+
+/**
+ * Dodaje do sumy wyraz `mul * x_0^e`. Przejmuje na własność @p mul.
+ * @param acc : suma
+ * @param e : wykładnik, `e < acc->size`
+ * @param mul : współczynnik
+ */
+static void SeriesAccAdd(SeriesAcc *acc, size_t e, Poly *mul) {
+    if (acc->dense == NULL) {
+        acc->monos[acc->count++] = MonoFromPoly(mul, (poly_exp_t) e);
+    }
+    else if (PolyIsCoeff(mul) && PolyIsCoeff(&acc->dense[e])) {
+        acc->dense[e].coeff = CoeffMod(acc->dense[e].coeff + mul->coeff, acc->mod);
+    }
+    else {
+        Poly sum = PolyAdd(&acc->dense[e], mul);
+        PolyDestroy(mul);
+        PolyDestroy(&acc->dense[e]);
+        acc->dense[e] = sum;
+        PolyReduceModInPlace(&acc->dense[e], acc->mod);
+    }
+}
+
+/**
+ * Składa wielomian z sumy i zwalnia pamięć sumy.
+ * @param acc : suma
+ * @return wielomian
+ */
+static Poly SeriesAccFinish(SeriesAcc *acc) {
+    if (acc->dense != NULL) {
+        acc->monos = (Mono *) malloc(acc->size * sizeof(struct Mono));
+        for (size_t i = 0; i < acc->size; i++) {
+            if (PolyIsZero(&acc->dense[i])) {
+                PolyDestroy(&acc->dense[i]);
+            }
+            else {
+                acc->monos[acc->count++] = MonoFromPoly(&acc->dense[i], (poly_exp_t) i);
+            }
+        }
+        free(acc->dense);
+    }
+
+    Poly res = PolyAddMonos(acc->count, acc->monos);
+    free(acc->monos);
+    PolyReduceModInPlace(&res, acc->mod);
+    return res;
+}
+
+/**
+ * Mnoży dwa wielomiany z obcięciem względem @f$x_0@f$ i redukcją modulo @p m.
+ * Pary wyrazów, których iloczyn ma stopień co najmniej @p n, są pomijane.
+ * @param p : wielomian
+ * @param q : wielomian
+ * @param n : ograniczenie stopnia (ujemne oznacza brak obcięcia)
+ * @param m : moduł (0 oznacza brak redukcji)
+ * @return `p * q mod (x_0^n, m)`
+ */
+static Poly SeriesMul(const Poly *p, const Poly *q, poly_exp_t n, poly_coeff_t m) {
+    if (PolyIsZero(p) || PolyIsZero(q) || n == 0) {
+        return PolyZero();
+    }
+    if (PolyIsCoeff(p) && PolyIsCoeff(q)) {
+        return PolyFromCoeff(CoeffMulMod(p->coeff, q->coeff, m));
+    }
+
+    Poly cp, cq;
+    unsigned tp, tq;
+    SeriesTerm *a = SeriesTerms(p, &cp, &tp);
+    SeriesTerm *b = SeriesTerms(q, &cq, &tq);
+
+    size_t size = (size_t) a[tp - 1].exp + (size_t) b[tq - 1].exp + 1;
+    if (n > 0 && (size_t) n < size) {
+        size = (size_t) n;
+    }
+
+    SeriesAcc acc;
+    SeriesAccInit(&acc, size, (size_t) tp * tq, m);
+    for (unsigned i = 0; i < tp && (size_t) a[i].exp < size; i++) {
+        for (unsigned j = 0; j < tq; j++) {
+            size_t e = (size_t) a[i].exp + b[j].exp;
+            if (e >= size) {
+                break;
+            }
+            Poly mul = SeriesMul(a[i].poly, b[j].poly, -1, m);
+            SeriesAccAdd(&acc, e, &mul);
+        }
+    }
+
+    free(b);
+    free(a);
+    return SeriesAccFinish(&acc);
+}
+
+/**
+ * Mnoży dwa wielomiany, zachowując tylko wyrazy stopnia (po wszystkich
+ * zmiennych) mniejszego niż @p n.
+ * Dla każdej pary wyrazów znane są w czasie stałym (PolyOrd, PolyDeg)
+ * najmniejszy i największy stopień współczynników, pamiętane w elementach
+ * list. Pary, których iloczyn na pewno przekracza ograniczenie,
+ * są pomijane w całości, a pary mieszczące się w nim w całości mnożone są
+ * bez dalszego sprawdzania.
+ * @param p : wielomian
+ * @param q : wielomian
+ * @param n : ograniczenie stopnia
+ * @return iloczyn obcięty do wyrazów stopnia mniejszego niż @p n
+ */
+static Poly SeriesMulTotal(const Poly *p, const Poly *q, poly_exp_t n) {
+    if (PolyIsZero(p) || PolyIsZero(q) || n <= 0) {
+        return PolyZero();
+    }
+    if (PolyDeg(p) + PolyDeg(q) < n) {
+        return SeriesMul(p, q, -1, 0);
+    }
+
+    Poly cp, cq;
+    unsigned tp, tq;
+    SeriesTerm *a = SeriesTerms(p, &cp, &tp);
+    SeriesTerm *b = SeriesTerms(q, &cq, &tq);
+    poly_exp_t *ord = (poly_exp_t *) malloc((tp + tq) * sizeof(poly_exp_t));
+    poly_exp_t *deg = (poly_exp_t *) malloc((tp + tq) * sizeof(poly_exp_t));
+    for (unsigned i = 0; i < tp; i++) {
+        ord[i] = PolyOrd(a[i].poly);
+        deg[i] = PolyDeg(a[i].poly);
+    }
+    for (unsigned j = 0; j < tq; j++) {
+        ord[tp + j] = PolyOrd(b[j].poly);
+        deg[tp + j] = PolyDeg(b[j].poly);
+    }
+
+    size_t size = (size_t) a[tp - 1].exp + (size_t) b[tq - 1].exp + 1;
+    if ((size_t) n < size) {
+        size = (size_t) n;
+    }
+
+    SeriesAcc acc;
+    SeriesAccInit(&acc, size, (size_t) tp * tq, 0);
+    for (unsigned i = 0; i < tp && (size_t) a[i].exp < size; i++) {
+        for (unsigned j = 0; j < tq; j++) {
+            size_t e = (size_t) a[i].exp + b[j].exp;
+            if (e >= size) {
+                break;
+            }
+            poly_exp_t rest = n - (poly_exp_t) e;
+            if (ord[i] + ord[tp + j] >= rest) {
+                continue;
+            }
+            Poly mul;
+            if (deg[i] + deg[tp + j] < rest) {
+                mul = SeriesMul(a[i].poly, b[j].poly, -1, 0);
+            }
+            else {
+                mul = SeriesMulTotal(a[i].poly, b[j].poly, rest);
+            }
+            SeriesAccAdd(&acc, e, &mul);
+        }
+    }
+
+    free(deg);
+    free(ord);
+    free(b);
+    free(a);
+    return SeriesAccFinish(&acc);
+}
+
+/**
+ * @param p : szereg
+ * @param c : tu zapisywany jest wyraz wolny, jeśli jest liczbą
+ * @return Czy współczynnik przy @f$x_0^0@f$ jest liczbą?
+ */
+static bool SeriesConstant(const Poly *p, poly_coeff_t *c) {
+    *c = p->coeff;
+    return PolyIsCoeff(p) || p->list->head->exp > 0;
+}
+
+/**
+ * Zastępuje @p acc wynikiem @p val, niszcząc poprzednią wartość.
+ * @param acc : wielomian
+ * @param val : nowa wartość
+ */
+static void PolyReplace(Poly *acc, Poly val) {
+    PolyDestroy(acc);
+    *acc = val;
+}
+
+/**
+ * Liczy odwrotność szeregu modulo @p m metodą Newtona:
+ * @f$g \leftarrow g(2 - pg)@f$.
+ * @param p : szereg o odwracalnym wyrazie wolnym
+ * @param c : wyraz wolny @p p
+ * @param n : liczba wyrazów wyniku
+ * @param m : moduł (0 oznacza obliczenia na liczbach całkowitych)
+ * @return `1 / p mod (x_0^n, m)`
+ */
+static Poly SeriesInv(const Poly *p, poly_coeff_t c, poly_exp_t n, poly_coeff_t m) {
+    if (n <= 0) {
+        return PolyZero();
+    }
+
+    Poly g = PolyFromCoeff((m == 0) ? c : CoeffInvMod(c, m));
+    Poly two = PolyFromCoeff(2);
+    for (poly_exp_t k = 1; k < n; k *= 2) {
+        poly_exp_t k2 = (k < n - k) ? 2 * k : n;
+        Poly pg = SeriesMul(p, &g, k2, m);
+        Poly t = PolySub(&two, &pg);
+        PolyReduceModInPlace(&t, m);
+        PolyReplace(&g, SeriesMul(&g, &t, k2, m));
+        PolyDestroy(&t);
+        PolyDestroy(&pg);
+    }
+    PolyDestroy(&two);
+    return g;
+}
+
+/**
+ * Całkuje szereg modulo @p m (stała całkowania równa 0).
+ * @param p : szereg o wyrazach stopnia mniejszego niż @p m - 1
+ * @param m : moduł - liczba pierwsza
+ * @return @f$\int p \, dx_0@f$
+ */
+static Poly SeriesIntegrate(const Poly *p, poly_coeff_t m) {
+    Poly constant;
+    unsigned count;
+    SeriesTerm *terms = SeriesTerms(p, &constant, &count);
+    Mono *monos = (Mono *) malloc((count + 1) * sizeof(struct Mono));
+    for (unsigned i = 0; i < count; i++) {
+        Poly scale = PolyFromCoeff(CoeffInvMod(terms[i].exp + 1, m));
+        Poly integral = SeriesMul(terms[i].poly, &scale, -1, m);
+        monos[i] = MonoFromPoly(&integral, terms[i].exp + 1);
+    }
+    Poly res = PolyAddMonos(count, monos);
+    free(monos);
+    free(terms);
+    return res;
+}
+
+/**
+ * Liczy logarytm szeregu modulo @p m: @f$\int p' / p@f$.
+ * @param p : szereg o wyrazie wolnym równym 1
+ * @param n : liczba wyrazów wyniku
+ * @param m : moduł - liczba pierwsza
+ * @return `log(p) mod (x_0^n, m)`
+ */
+static Poly SeriesLog(const Poly *p, poly_exp_t n, poly_coeff_t m) {
+    if (n <= 1) {
+        return PolyZero();
+    }
+
+    Poly dp = PolyDerivative(p, 0);
+    PolyReduceModInPlace(&dp, m);
+    Poly inv = SeriesInv(p, 1, n - 1, m);
+    Poly quot = SeriesMul(&dp, &inv, n - 1, m);
+    Poly res = SeriesIntegrate(&quot, m);
+    PolyDestroy(&quot);
+    PolyDestroy(&inv);
+    PolyDestroy(&dp);
+    return res;
+}
+
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t n) {
+    if (n <= 0) {
+        return PolyZero();
+    }
+    return SeriesMul(p, q, n, 0);
+}
+
+Poly PolyMulTruncDeg(const Poly *p, const Poly *q, poly_exp_t n) {
+    return SeriesMulTotal(p, q, n);
+}
+
+Poly PolyPowTruncDeg(const Poly *p, unsigned e, poly_exp_t n) {
+    Poly res = (n > 0) ? PolyFromCoeff(1) : PolyZero();
+    Poly base = PolyClone(p);
+    while (e > 0) {
+        if (e & 1) {
+            PolyReplace(&res, SeriesMulTotal(&res, &base, n));
+        }
+        e >>= 1;
+        if (e > 0) {
+            PolyReplace(&base, SeriesMulTotal(&base, &base, n));
+        }
+    }
+    PolyDestroy(&base);
+    return res;
+}
+
+bool PolySeriesInv(const Poly *p, poly_exp_t n, Poly *res) {
+    poly_coeff_t c;
+    if (!SeriesConstant(p, &c) || (c != 1 && c != -1)) {
+        return false;
+    }
+    *res = SeriesInv(p, c, n, 0);
+    return true;
+}
+
+bool PolySeriesLog(const Poly *p, poly_exp_t n, poly_coeff_t mod, Poly *res) {
+    poly_coeff_t c;
+    if (!SeriesModIsValid(mod) || n > mod || !SeriesConstant(p, &c)
+        || CoeffMod(c, mod) != 1) {
+        return false;
+    }
+
+    Poly r = PolyReduceMod(p, mod);
+    *res = SeriesLog(&r, n, mod);
+    PolyDestroy(&r);
+    return true;
+}
+
+bool PolySeriesExp(const Poly *p, poly_exp_t n, poly_coeff_t mod, Poly *res) {
+    poly_coeff_t c;
+    if (!SeriesModIsValid(mod) || n > mod || !SeriesConstant(p, &c)
+        || CoeffMod(c, mod) != 0) {
+        return false;
+    }
+    if (n <= 0) {
+        *res = PolyZero();
+        return true;
+    }
+
+    // g <- g * (1 - log(g) + p)
+    Poly r = PolyReduceMod(p, mod);
+    Poly one = PolyFromCoeff(1);
+    Poly one_p = PolyAdd(&r, &one);
+    Poly g = PolyFromCoeff(1);
+    for (poly_exp_t k = 1; k < n; k *= 2) {
+        poly_exp_t k2 = (k < n - k) ? 2 * k : n;
+        Poly lg = SeriesLog(&g, k2, mod);
+        Poly t = PolySub(&one_p, &lg);
+        PolyReduceModInPlace(&t, mod);
+        PolyReplace(&g, SeriesMul(&g, &t, k2, mod));
+        PolyDestroy(&t);
+        PolyDestroy(&lg);
+    }
+    PolyDestroy(&one_p);
+    PolyDestroy(&one);
+    PolyDestroy(&r);
+    *res = g;
+    return true;
+}
+
+bool PolySeriesSqrt(const Poly *p, poly_exp_t n, poly_coeff_t mod, Poly *res) {
+    poly_coeff_t c;
+    if (!SeriesModIsValid(mod) || !SeriesConstant(p, &c) || CoeffMod(c, mod) != 1) {
+        return false;
+    }
+    if (n <= 0) {
+        *res = PolyZero();
+        return true;
+    }
+
+    // g <- (g + p / g) / 2
+    Poly r = PolyReduceMod(p, mod);
+    Poly half = PolyFromCoeff(CoeffInvMod(2, mod));
+    Poly g = PolyFromCoeff(1);
+    for (poly_exp_t k = 1; k < n; k *= 2) {
+        poly_exp_t k2 = (k < n - k) ? 2 * k : n;
+        Poly inv = SeriesInv(&g, 1, k2, mod);
+        Poly quot = SeriesMul(&r, &inv, k2, mod);
+        Poly sum = PolyAdd(&g, &quot);
+        PolyReplace(&g, SeriesMul(&sum, &half, k2, mod));
+        PolyDestroy(&sum);
+        PolyDestroy(&quot);
+        PolyDestroy(&inv);
+    }
+    PolyDestroy(&half);
+    PolyDestroy(&r);
+    *res = g;
+    return true;
+}
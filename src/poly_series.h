@@ -0,0 +1,98 @@
+/** @file
+   Interfejs obciętego mnożenia i operacji na szeregach potęgowych
+
+   Szereg potęgowy reprezentowany jest wielomianem zmiennej @f$x_0@f$
+   (współczynniki mogą być wielomianami kolejnych zmiennych) obciętym
+   do wyrazów stopnia mniejszego niż zadane @p n.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_SERIES_H__
+#define __POLY_SERIES_H__
+
+#include "poly.h"
+
+/**
+ * Mnoży dwa wielomiany, pomijając wyrazy stopnia co najmniej @p n
+ * względem zmiennej @f$x_0@f$. Takie wyrazy w ogóle nie są wyliczane.
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @param[in] n : ograniczenie stopnia
+ * @return `p * q mod x_0^n`
+ */
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t n);
+
+/**
+ * Mnoży dwa wielomiany, zachowując tylko wyrazy stopnia (po wszystkich
+ * zmiennych, tak jak w PolyDeg) mniejszego niż @p n.
+ * Iloczyny współczynników, które na pewno przekroczyłyby ograniczenie,
+ * nie są wyliczane.
+ * @param[in] p : wielomian
+ * @param[in] q : wielomian
+ * @param[in] n : ograniczenie stopnia
+ * @return `p * q` obcięty do wyrazów stopnia mniejszego niż @p n
+ */
+Poly PolyMulTruncDeg(const Poly *p, const Poly *q, poly_exp_t n);
+
+/**
+ * Potęguje wielomian, zachowując tylko wyrazy stopnia (po wszystkich
+ * zmiennych) mniejszego niż @p n. Obcinany jest każdy iloczyn pośredni.
+ * @param[in] p : wielomian
+ * @param[in] e : wykładnik
+ * @param[in] n : ograniczenie stopnia
+ * @return `p^e` obcięty do wyrazów stopnia mniejszego niż @p n
+ */
+Poly PolyPowTruncDeg(const Poly *p, unsigned e, poly_exp_t n);
+
+/**
+ * Liczy odwrotność szeregu metodą Newtona.
+ * Wyraz wolny (współczynnik przy @f$x_0^0@f$) musi być liczbą 1 lub -1.
+ * @param[in] p : szereg
+ * @param[in] n : liczba wyrazów wyniku
+ * @param[out] res : `1 / p mod x_0^n`
+ * @return Czy szereg jest odwracalny?
+ */
+bool PolySeriesInv(const Poly *p, poly_exp_t n, Poly *res);
+
+/**
+ * Liczy logarytm szeregu modulo liczba pierwsza @p mod metodą Newtona.
+ * Wyraz wolny szeregu musi być równy 1 modulo @p mod.
+ * Współczynniki wyniku należą do przedziału `[0, mod)`.
+ * @param[in] p : szereg
+ * @param[in] n : liczba wyrazów wyniku, `n <= mod`
+ * @param[in] mod : liczba pierwsza, `2 < mod < 2^31`
+ * @param[out] res : `log(p) mod x_0^n`
+ * @return Czy poprawne są argumenty?
+ */
+bool PolySeriesLog(const Poly *p, poly_exp_t n, poly_coeff_t mod, Poly *res);
+
+/**
+ * Liczy funkcję wykładniczą szeregu modulo liczba pierwsza @p mod
+ * metodą Newtona.
+ * Wyraz wolny szeregu musi być równy 0 modulo @p mod.
+ * Współczynniki wyniku należą do przedziału `[0, mod)`.
+ * @param[in] p : szereg
+ * @param[in] n : liczba wyrazów wyniku, `n <= mod`
+ * @param[in] mod : liczba pierwsza, `2 < mod < 2^31`
+ * @param[out] res : `exp(p) mod x_0^n`
+ * @return Czy poprawne są argumenty?
+ */
+bool PolySeriesExp(const Poly *p, poly_exp_t n, poly_coeff_t mod, Poly *res);
+
+/**
+ * Liczy pierwiastek kwadratowy szeregu modulo liczba pierwsza @p mod
+ * metodą Newtona.
+ * Wyraz wolny szeregu musi być równy 1 modulo @p mod.
+ * Wynikiem jest pierwiastek o wyrazie wolnym 1.
+ * Współczynniki wyniku należą do przedziału `[0, mod)`.
+ * @param[in] p : szereg
+ * @param[in] n : liczba wyrazów wyniku
+ * @param[in] mod : liczba pierwsza, `2 < mod < 2^31`
+ * @param[out] res : `sqrt(p) mod x_0^n`
+ * @return Czy poprawne są argumenty?
+ */
+bool PolySeriesSqrt(const Poly *p, poly_exp_t n, poly_coeff_t mod, Poly *res);
+
+#endif /* __POLY_SERIES_H__ */
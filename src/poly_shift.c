@@ -0,0 +1,308 @@
+#include <stdlib.h>
+#include <string.h>
+#include "poly.h"
+#include "poly_shift.h"
+
+/** Rozmiar, poniżej którego mnożymy szkolnie */
+#define KARATSUBA_BASE 32
+
+/** Rozmiar bloków przesuwanych schematem Hornera */
+#define SHIFT_BASE 32
+
+
+
+/**
+ * Mnoży szkolnie dwa wielomiany długości @p n.
+ * @param a : współczynniki
+ * @param b : współczynniki
+ * @param n : długość
+ * @param res : miejsce na `2n` współczynników iloczynu
+ */
+static void MulSchoolbook(const poly_ucoeff_t *a, const poly_ucoeff_t *b,
+                          size_t n, poly_ucoeff_t *res) {
+    memset(res, 0, 2 * n * sizeof(poly_ucoeff_t));
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != 0) {
+            for (size_t j = 0; j < n; j++) {
+                res[i + j] += a[i] * b[j];
+            }
+        }
+    }
+}
+
+/**
+ * Mnoży algorytmem Karatsuby dwa wielomiany długości @p n
+ * (potęga dwójki lub liczba nie większa niż KARATSUBA_BASE).
+ * @param a : współczynniki
+ * @param b : współczynniki
+ * @param n : długość
+ * @param res : miejsce na `2n` współczynników iloczynu
+ * @param scratch : pamięć pomocnicza na `4n` współczynników
+ */
+static void MulKaratsuba(const poly_ucoeff_t *a, const poly_ucoeff_t *b,
+                         size_t n, poly_ucoeff_t *res, poly_ucoeff_t *scratch) {
+    if (n <= KARATSUBA_BASE) {
+        MulSchoolbook(a, b, n, res);
+        return;
+    }
+
+    size_t h = n / 2;
+    poly_ucoeff_t *sa = scratch;
+    poly_ucoeff_t *sb = scratch + h;
+    poly_ucoeff_t *mid = scratch + n;
+    poly_ucoeff_t *rest = scratch + 2 * n;
+
+    MulKaratsuba(a, b, h, res, rest);
+    MulKaratsuba(a + h, b + h, h, res + n, rest);
+    for (size_t i = 0; i < h; i++) {
+        sa[i] = a[i] + a[h + i];
+        sb[i] = b[i] + b[h + i];
+    }
+    MulKaratsuba(sa, sb, h, mid, rest);
+    for (size_t i = 0; i < n; i++) {
+        mid[i] -= res[i] + res[n + i];
+    }
+    for (size_t i = 0; i < n; i++) {
+        res[h + i] += mid[i];
+    }
+}
+
+/**
+ * Przesuwa w miejscu wielomian schematem Hornera w czasie @f$O(n^2)@f$.
+ * @param c : współczynniki
+ * @param n : długość
+ * @param a : przesunięcie
+ */
+static void ShiftHorner(poly_ucoeff_t *c, size_t n, poly_ucoeff_t a) {
+    for (size_t i = 0; i + 1 < n; i++) {
+        for (size_t j = n - 1; j > i; j--) {
+            c[j - 1] += a * c[j];
+        }
+    }
+}
+
+void PolyTaylorShiftCoeffs(poly_coeff_t *coeffs, size_t n, poly_coeff_t a) {
+    poly_ucoeff_t *c = (poly_ucoeff_t *) coeffs;
+    if (n <= 1 || a == 0) {
+        return;
+    }
+    if (n <= SHIFT_BASE) {
+        ShiftHorner(c, n, (poly_ucoeff_t) a);
+        return;
+    }
+
+    size_t size = SHIFT_BASE;
+    while (size < n) {
+        size *= 2;
+    }
+
+    poly_ucoeff_t *buf = (poly_ucoeff_t *) calloc(size, sizeof(poly_ucoeff_t));
+    memcpy(buf, c, n * sizeof(poly_ucoeff_t));
+    for (size_t o = 0; o < n; o += SHIFT_BASE) {
+        ShiftHorner(buf + o, SHIFT_BASE, (poly_ucoeff_t) a);
+    }
+
+    // pw - niższe współczynniki (x + a)^s, współczynnik przy x^s to 1
+    poly_ucoeff_t *pw = (poly_ucoeff_t *) calloc(size, sizeof(poly_ucoeff_t));
+    poly_ucoeff_t *prod = (poly_ucoeff_t *) malloc(2 * size * sizeof(poly_ucoeff_t));
+    poly_ucoeff_t *scratch = (poly_ucoeff_t *) malloc(4 * size * sizeof(poly_ucoeff_t));
+    pw[0] = (poly_ucoeff_t) a;
+    for (size_t s = 1; s < size; s *= 2) {
+        if (s >= SHIFT_BASE) {
+            // Łączymy sąsiednie bloki długości s: lo + (x + a)^s * hi.
+            for (size_t o = 0; o + s < n; o += 2 * s) {
+                MulKaratsuba(buf + o + s, pw, s, prod, scratch);
+                for (size_t i = 0; i < 2 * s; i++) {
+                    buf[o + i] += prod[i];
+                }
+            }
+        }
+        if (2 * s < size) {
+            // (L + x^s)^2 = L^2 + 2 x^s L + x^(2s)
+            MulKaratsuba(pw, pw, s, prod, scratch);
+            for (size_t i = 0; i < s; i++) {
+                prod[s + i] += 2 * pw[i];
+            }
+            memcpy(pw, prod, 2 * s * sizeof(poly_ucoeff_t));
+        }
+    }
+
+    memcpy(c, buf, n * sizeof(poly_ucoeff_t));
+    free(scratch);
+    free(prod);
+    free(pw);
+    free(buf);
+}
+
+
+
+/**
+ * Współczynnik wektora przesuwanych wielomianów wraz z położeniem.
+ */
+typedef struct ShiftEntry {
+    poly_exp_t exp; ///< wykładnik kolejnej zmiennej
+    size_t idx; ///< indeks w wektorze (wykładnik zmiennej przesuwanej)
+    Poly poly; ///< współczynnik
+} ShiftEntry;
+
+/**
+ * Porównuje elementy według wykładnika, a potem indeksu.
+ * @param a : element ShiftEntry
+ * @param b : element ShiftEntry
+ * @return wynik porównania dla qsort
+ */
+static int ShiftEntryCompare(const void *a, const void *b) {
+    const ShiftEntry *x = (const ShiftEntry *) a;
+    const ShiftEntry *y = (const ShiftEntry *) b;
+    if (x->exp != y->exp) {
+        return (x->exp < y->exp) ? -1 : 1;
+    }
+    return (x->idx < y->idx) ? -1 : (x->idx > y->idx);
+}
+
+/**
+ * Przesuwa wektor współczynników przy kolejnych potęgach zmiennej
+ * przesuwanej. Współczynniki są wielomianami dalszych zmiennych.
+ * Część liczbowa przesuwana jest bezpośrednio, a jednomiany rozdzielane
+ * według wykładnika następnej zmiennej i przesuwane rekurencyjnie.
+ * Przejmuje na własność zawartość wektora i zapisuje w nim wynik.
+ * @param v : wektor współczynników
+ * @param n : długość wektora
+ * @param a : przesunięcie
+ */
+static void ShiftPolyVector(Poly *v, size_t n, poly_coeff_t a) {
+    poly_coeff_t *consts = (poly_coeff_t *) malloc(n * sizeof(poly_coeff_t));
+    size_t entries_count = 0;
+    for (size_t i = 0; i < n; i++) {
+        consts[i] = v[i].coeff;
+        for (MonoList l = v[i].list; l != NULL; l = l->tail) {
+            entries_count++;
+        }
+    }
+    PolyTaylorShiftCoeffs(consts, n, a);
+
+    if (entries_count == 0) {
+        for (size_t i = 0; i < n; i++) {
+            v[i] = PolyFromCoeff(consts[i]);
+        }
+        free(consts);
+        return;
+    }
+
+    ShiftEntry *entries = (ShiftEntry *) malloc(entries_count * sizeof(ShiftEntry));
+    size_t k = 0;
+    for (size_t i = 0; i < n; i++) {
+        for (MonoList l = v[i].list; l != NULL; l = l->tail) {
+            entries[k++] = (ShiftEntry) {
+                .exp = l->head->exp, .idx = i, .poly = PolyClone(&(l->head->poly))
+            };
+        }
+        PolyDestroy(&v[i]);
+    }
+    qsort(entries, entries_count, sizeof(ShiftEntry), ShiftEntryCompare);
+
+    // Wyniki dla kolejnych wykładników dopisywane są na koniec tablicy out.
+    size_t out_size = 0, out_capacity = entries_count + n;
+    ShiftEntry *out = (ShiftEntry *) malloc(out_capacity * sizeof(ShiftEntry));
+    Poly *w = (Poly *) malloc(n * sizeof(struct Poly));
+    for (size_t begin = 0; begin < entries_count; ) {
+        size_t end = begin;
+        while (end < entries_count && entries[end].exp == entries[begin].exp) {
+            end++;
+        }
+
+        size_t len = entries[end - 1].idx + 1;
+        for (size_t i = 0; i < len; i++) {
+            w[i] = PolyZero();
+        }
+        for (size_t j = begin; j < end; j++) {
+            w[entries[j].idx] = entries[j].poly;
+        }
+        ShiftPolyVector(w, len, a);
+
+        for (size_t i = 0; i < len; i++) {
+            if (PolyIsZero(&w[i])) {
+                PolyDestroy(&w[i]);
+                continue;
+            }
+            if (out_size == out_capacity) {
+                out_capacity *= 2;
+                out = (ShiftEntry *) realloc(out, out_capacity * sizeof(ShiftEntry));
+            }
+            out[out_size++] = (ShiftEntry) {.exp = entries[begin].exp, .idx = i, .poly = w[i]};
+        }
+        begin = end;
+    }
+    free(w);
+    free(entries);
+
+    // Rozdzielamy wyniki z powrotem według indeksu (sortowanie przez zliczanie).
+    size_t *start = (size_t *) calloc(n + 1, sizeof(size_t));
+    for (size_t j = 0; j < out_size; j++) {
+        start[out[j].idx + 1]++;
+    }
+    for (size_t i = 0; i < n; i++) {
+        start[i + 1] += start[i];
+    }
+    Mono *monos = (Mono *) malloc((out_size + 1) * sizeof(struct Mono));
+    size_t *pos = (size_t *) malloc((n + 1) * sizeof(size_t));
+    memcpy(pos, start, (n + 1) * sizeof(size_t));
+    for (size_t j = 0; j < out_size; j++) {
+        monos[pos[out[j].idx]++] = MonoFromPoly(&out[j].poly, out[j].exp);
+    }
+    for (size_t i = 0; i < n; i++) {
+        v[i] = PolyAddMonos((unsigned) (start[i + 1] - start[i]), monos + start[i]);
+        v[i].coeff += consts[i];
+    }
+
+    free(pos);
+    free(monos);
+    free(start);
+    free(out);
+    free(consts);
+}
+
+Poly PolyTaylorShift(const Poly *p, poly_coeff_t a) {
+    if (PolyIsCoeff(p)) {
+        return PolyClone(p);
+    }
+
+    poly_exp_t deg = 0;
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        deg = l->head->exp;
+    }
+
+    size_t n = (size_t) deg + 1;
+    Poly *v = (Poly *) malloc(n * sizeof(struct Poly));
+    for (size_t i = 0; i < n; i++) {
+        v[i] = PolyZero();
+    }
+    v[0] = PolyFromCoeff(p->coeff);
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        if (l->head->exp == 0) {
+            Poly sum = PolyAdd(&v[0], &(l->head->poly));
+            PolyDestroy(&v[0]);
+            v[0] = sum;
+        }
+        else {
+            v[l->head->exp] = PolyClone(&(l->head->poly));
+        }
+    }
+
+    ShiftPolyVector(v, n, a);
+
+    Mono *monos = (Mono *) malloc(n * sizeof(struct Mono));
+    unsigned count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (PolyIsZero(&v[i])) {
+            PolyDestroy(&v[i]);
+        }
+        else {
+            monos[count++] = MonoFromPoly(&v[i], (poly_exp_t) i);
+        }
+    }
+    Poly res = PolyAddMonos(count, monos);
+    free(monos);
+    free(v);
+    return res;
+}
@@ -0,0 +1,37 @@
+/** @file
+   Interfejs przesunięcia Taylora wielomianów
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_SHIFT_H__
+#define __POLY_SHIFT_H__
+
+#include "poly.h"
+
+/**
+ * Przesuwa w miejscu wielomian jednej zmiennej zadany gęstą tablicą
+ * współczynników: `c[0] + c[1] * x + ...` zastępuje przez
+ * `c[0] + c[1] * (x + a) + ...`.
+ * Działa w czasie @f$O(M(n) \log n)@f$, gdzie @f$M(n)@f$ jest kosztem
+ * mnożenia algorytmem Karatsuby.
+ * Arytmetyka jest taka jak w pozostałych operacjach na wielomianach
+ * (modulo zakres typu poly_coeff_t).
+ * @param[in,out] c : tablica współczynników
+ * @param[in] n : długość tablicy
+ * @param[in] a : przesunięcie
+ */
+void PolyTaylorShiftCoeffs(poly_coeff_t *c, size_t n, poly_coeff_t a);
+
+/**
+ * Przesuwa zmienną główną wielomianu: wylicza @f$p(x_0 + a, x_1, \ldots)@f$.
+ * Współczynniki będące wielomianami kolejnych zmiennych przesuwane są
+ * osobno dla każdego jednomianu tych zmiennych.
+ * @param[in] p : wielomian
+ * @param[in] a : przesunięcie
+ * @return @f$p(x_0 + a, x_1, \ldots)@f$
+ */
+Poly PolyTaylorShift(const Poly *p, poly_coeff_t a);
+
+#endif /* __POLY_SHIFT_H__ */
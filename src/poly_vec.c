@@ -0,0 +1,557 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "poly.h"
+#include "poly_vec.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+/** Czy kompilator potrafi zbudować jądra AVX2 */
+#define POLY_VEC_AVX2 1
+#include <immintrin.h>
+#endif
+
+/** Liczba współczynników w rejestrze AVX2; wielokrotność odstępu wyrazów */
+#define VEC_GROUP 4
+
+_Static_assert(sizeof(poly_coeff_t) == sizeof(uint64_t),
+               "jądra liczą współczynniki jako słowa 64-bitowe");
+
+/**
+ * Jądra arytmetyki współczynników na tablicach długości `n`.
+ */
+typedef struct VecKernels {
+    /** `dst = a + b` */
+    void (*add)(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+    /** `dst += a * b` */
+    void (*mul_add)(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n);
+    /** `dst += a * s` */
+    void (*scale_add)(uint64_t *dst, const uint64_t *a, uint64_t s, size_t n);
+} VecKernels;
+
+/**
+ * Jądro skalarne `dst = a + b`.
+ * @param dst : wynik
+ * @param a : składnik
+ * @param b : składnik
+ * @param n : długość tablic
+ */
+static void ScalarAdd(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = a[i] + b[i];
+    }
+}
+
+/**
+ * Jądro skalarne `dst += a * b`.
+ * @param dst : wynik
+ * @param a : czynnik
+ * @param b : czynnik
+ * @param n : długość tablic
+ */
+static void ScalarMulAdd(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] += a[i] * b[i];
+    }
+}
+
+/**
+ * Jądro skalarne `dst += a * s`.
+ * @param dst : wynik
+ * @param a : czynnik
+ * @param s : skalar
+ * @param n : długość tablic
+ */
+static void ScalarScaleAdd(uint64_t *dst, const uint64_t *a, uint64_t s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] += a[i] * s;
+    }
+}
+
+/** Jądra skalarne */
+static const VecKernels vec_scalar = {
+    .add = ScalarAdd, .mul_add = ScalarMulAdd, .scale_add = ScalarScaleAdd
+};
+
+#ifdef POLY_VEC_AVX2
+
+/**
+ * Mnoży 64-bitowe słowa rejestrów, zostawiając młodsze 64 bity iloczynów.
+ * AVX2 nie ma takiej instrukcji, więc iloczyn składany jest z trzech
+ * mnożeń 32-bitowych połówek.
+ * @param a : czynniki
+ * @param b : czynniki
+ * @return iloczyny modulo @f$2^{64}@f$
+ */
+__attribute__((target("avx2")))
+static inline __m256i Avx2Mul64(__m256i a, __m256i b) {
+    __m256i lo = _mm256_mul_epu32(a, b);
+    __m256i a_hi_b = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+    __m256i a_b_hi = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+    __m256i cross = _mm256_slli_epi64(_mm256_add_epi64(a_hi_b, a_b_hi), 32);
+    return _mm256_add_epi64(lo, cross);
+}
+
+/**
+ * Jądro AVX2 `dst = a + b`.
+ * @param dst : wynik
+ * @param a : składnik
+ * @param b : składnik
+ * @param n : długość tablic
+ */
+__attribute__((target("avx2")))
+static void Avx2Add(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    size_t i = 0;
+    for (; i + VEC_GROUP <= n; i += VEC_GROUP) {
+        __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *) (b + i));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_add_epi64(va, vb));
+    }
+    ScalarAdd(dst + i, a + i, b + i, n - i);
+}
+
+/**
+ * Jądro AVX2 `dst += a * b`.
+ * @param dst : wynik
+ * @param a : czynnik
+ * @param b : czynnik
+ * @param n : długość tablic
+ */
+__attribute__((target("avx2")))
+static void Avx2MulAdd(uint64_t *dst, const uint64_t *a, const uint64_t *b, size_t n) {
+    size_t i = 0;
+    for (; i + VEC_GROUP <= n; i += VEC_GROUP) {
+        __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *) (b + i));
+        __m256i vd = _mm256_loadu_si256((const __m256i *) (dst + i));
+        vd = _mm256_add_epi64(vd, Avx2Mul64(va, vb));
+        _mm256_storeu_si256((__m256i *) (dst + i), vd);
+    }
+    ScalarMulAdd(dst + i, a + i, b + i, n - i);
+}
+
+/**
+ * Jądro AVX2 `dst += a * s`.
+ * @param dst : wynik
+ * @param a : czynnik
+ * @param s : skalar
+ * @param n : długość tablic
+ */
+__attribute__((target("avx2")))
+static void Avx2ScaleAdd(uint64_t *dst, const uint64_t *a, uint64_t s, size_t n) {
+    __m256i vs = _mm256_set1_epi64x((long long) s);
+    size_t i = 0;
+    for (; i + VEC_GROUP <= n; i += VEC_GROUP) {
+        __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i vd = _mm256_loadu_si256((const __m256i *) (dst + i));
+        vd = _mm256_add_epi64(vd, Avx2Mul64(va, vs));
+        _mm256_storeu_si256((__m256i *) (dst + i), vd);
+    }
+    ScalarScaleAdd(dst + i, a + i, s, n - i);
+}
+
+/** Jądra AVX2 */
+static const VecKernels vec_avx2 = {
+    .add = Avx2Add, .mul_add = Avx2MulAdd, .scale_add = Avx2ScaleAdd
+};
+
+#endif /* POLY_VEC_AVX2 */
+
+/** Czy używać jąder AVX2 */
+static atomic_bool vec_simd;
+
+/** Jednokrotne sprawdzenie możliwości procesora */
+static pthread_once_t vec_simd_once = PTHREAD_ONCE_INIT;
+
+/**
+ * Sprawdza, czy procesor obsługuje AVX2.
+ * @return Czy jądra AVX2 mogą działać?
+ */
+static bool VecCpuHasAvx2() {
+#ifdef POLY_VEC_AVX2
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+/**
+ * Włącza jądra AVX2, jeśli procesor je obsługuje.
+ */
+static void VecSimdDetect() {
+    atomic_store(&vec_simd, VecCpuHasAvx2());
+}
+
+/**
+ * Zwraca jądra wybrane dla bieżącego procesora.
+ * @return jądra
+ */
+static const VecKernels *VecKernelsGet() {
+    pthread_once(&vec_simd_once, VecSimdDetect);
+#ifdef POLY_VEC_AVX2
+    if (atomic_load(&vec_simd)) {
+        return &vec_avx2;
+    }
+#endif
+    return &vec_scalar;
+}
+
+bool PolyVecEnableSimd(bool enable) {
+    pthread_once(&vec_simd_once, VecSimdDetect);
+    atomic_store(&vec_simd, enable && VecCpuHasAvx2());
+    return atomic_load(&vec_simd);
+}
+
+/**
+ * Porównuje leksykograficznie wektory wykładników.
+ * @param a : wykładniki
+ * @param b : wykładniki
+ * @param vars : liczba zmiennych
+ * @return liczba ujemna, zero lub dodatnia, gdy `a < b`, `a = b`, `a > b`
+ */
+static int VecCompare(const poly_exp_t *a, const poly_exp_t *b, unsigned vars) {
+    for (unsigned v = 0; v < vars; v++) {
+        if (a[v] != b[v]) {
+            return (a[v] < b[v]) ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Sortuje stabilnie przez scalanie indeksy wierszy tablicy wykładników.
+ * @param idx : indeksy wierszy
+ * @param tmp : miejsce pomocnicze na @p n indeksów
+ * @param n : liczba indeksów
+ * @param exps : wiersze wykładników, po @p vars na wiersz
+ * @param vars : liczba zmiennych
+ */
+static void VecSortIndex(size_t *idx, size_t *tmp, size_t n, const poly_exp_t *exps,
+                         unsigned vars) {
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t mid = (lo + width < n) ? lo + width : n;
+            size_t hi = (lo + 2 * width < n) ? lo + 2 * width : n;
+            size_t a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) {
+                bool take_b = VecCompare(&exps[idx[b] * vars], &exps[idx[a] * vars], vars) < 0;
+                tmp[k++] = take_b ? idx[b++] : idx[a++];
+            }
+            while (a < mid) {
+                tmp[k++] = idx[a++];
+            }
+            while (b < hi) {
+                tmp[k++] = idx[b++];
+            }
+        }
+        memcpy(idx, tmp, n * sizeof(size_t));
+    }
+}
+
+/**
+ * Przydziela pamięć wektora z wyzerowanymi współczynnikami.
+ * @param v : wektor
+ * @param terms : liczba wyrazów
+ * @param lanes : liczba pasów
+ * @param vars : liczba zmiennych
+ * @return Czy starczyło pamięci?
+ */
+static bool VecAlloc(PolyVec *v, size_t terms, size_t lanes, unsigned vars) {
+    v->terms = terms;
+    v->lanes = lanes;
+    v->stride = (lanes + VEC_GROUP - 1) / VEC_GROUP * VEC_GROUP;
+    v->vars = vars;
+    v->exps = (poly_exp_t *) malloc((terms * vars + 1) * sizeof(poly_exp_t));
+    v->coeffs = (poly_coeff_t *) calloc(terms * v->stride + 1, sizeof(poly_coeff_t));
+    if (v->exps == NULL || v->coeffs == NULL) {
+        PolyVecDestroy(v);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Zwraca wiersz współczynników wyrazu jako słowa 64-bitowe.
+ * @param v : wektor
+ * @param t : numer wyrazu
+ * @return współczynniki wyrazu we wszystkich pasach
+ */
+static inline uint64_t *VecRow(const PolyVec *v, size_t t) {
+    return (uint64_t *) &(v->coeffs[t * v->stride]);
+}
+
+/**
+ * Usuwa z wektora wyrazy, które mają współczynnik 0 we wszystkich pasach.
+ * @param v : wektor
+ */
+static void VecCompact(PolyVec *v) {
+    size_t k = 0;
+    for (size_t t = 0; t < v->terms; t++) {
+        const uint64_t *row = VecRow(v, t);
+        bool zero = true;
+        for (size_t l = 0; l < v->lanes && zero; l++) {
+            zero = (row[l] == 0);
+        }
+        if (!zero) {
+            if (k != t) {
+                memcpy(&(v->exps[k * v->vars]), &(v->exps[t * v->vars]),
+                       v->vars * sizeof(poly_exp_t));
+                memcpy(VecRow(v, k), row, v->stride * sizeof(uint64_t));
+            }
+            k++;
+        }
+    }
+    v->terms = k;
+}
+
+/**
+ * Wyrazy wielomianów zbierane przy tworzeniu wektora.
+ */
+typedef struct VecTerms {
+    poly_exp_t *exps; ///< wykładniki wyrazów, po `vars` na wyraz
+    poly_coeff_t *coeffs; ///< współczynniki wyrazów
+    size_t *lanes; ///< pasy wyrazów
+    size_t count; ///< liczba zebranych wyrazów
+    unsigned vars; ///< liczba zmiennych
+} VecTerms;
+
+/**
+ * Zbiera wyrazy wielomianu.
+ * @param t : zebrane wyrazy z pamięcią na wszystkie
+ * @param p : wielomian
+ * @param v : indeks zmiennej głównej @p p
+ * @param e : wykładniki zmiennych o mniejszych indeksach, reszta zerowa
+ * @param lane : pas wielomianu
+ */
+static void VecCollect(VecTerms *t, const Poly *p, unsigned v, poly_exp_t e[], size_t lane) {
+    if (p->coeff != 0) {
+        memcpy(&(t->exps[t->count * t->vars]), e, t->vars * sizeof(poly_exp_t));
+        t->coeffs[t->count] = p->coeff;
+        t->lanes[t->count] = lane;
+        t->count++;
+    }
+    for (MonoList l = p->list; l != NULL; l = l->tail) {
+        e[v] = l->head->exp;
+        VecCollect(t, &(l->head->poly), v + 1, e, lane);
+    }
+    if (p->list != NULL) {
+        e[v] = 0;
+    }
+}
+
+bool PolyVecFromPolys(const Poly polys[], size_t count, unsigned vars, PolyVec *res) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (PolyDepth(&polys[i]) > vars) {
+            return false;
+        }
+        total += PolyTermCount(&polys[i]);
+    }
+
+    VecTerms t = {.count = 0, .vars = vars};
+    t.exps = (poly_exp_t *) malloc((total * vars + 1) * sizeof(poly_exp_t));
+    t.coeffs = (poly_coeff_t *) malloc((total + 1) * sizeof(poly_coeff_t));
+    t.lanes = (size_t *) malloc((total + 1) * sizeof(size_t));
+    size_t *idx = (size_t *) malloc((2 * total + 1) * sizeof(size_t));
+    poly_exp_t *e = (poly_exp_t *) calloc(vars + 1, sizeof(poly_exp_t));
+    bool ok = t.exps != NULL && t.coeffs != NULL && t.lanes != NULL && idx != NULL
+              && e != NULL;
+    if (ok) {
+        for (size_t i = 0; i < count; i++) {
+            VecCollect(&t, &polys[i], 0, e, i);
+        }
+        for (size_t i = 0; i < t.count; i++) {
+            idx[i] = i;
+        }
+        VecSortIndex(idx, idx + total, t.count, t.exps, vars);
+
+        size_t terms = 0;
+        for (size_t i = 0; i < t.count; i++) {
+            if (i == 0 || VecCompare(&t.exps[idx[i] * vars], &t.exps[idx[i - 1] * vars],
+                                     vars) != 0) {
+                terms++;
+            }
+        }
+        ok = VecAlloc(res, terms, count, vars);
+    }
+    if (ok) {
+        size_t k = 0;
+        for (size_t i = 0; i < t.count; i++) {
+            const poly_exp_t *exps = &t.exps[idx[i] * vars];
+            if (i > 0 && VecCompare(exps, &t.exps[idx[i - 1] * vars], vars) != 0) {
+                k++;
+            }
+            memcpy(&(res->exps[k * vars]), exps, vars * sizeof(poly_exp_t));
+            res->coeffs[k * res->stride + t.lanes[idx[i]]] = t.coeffs[idx[i]];
+        }
+    }
+    free(e);
+    free(idx);
+    free(t.lanes);
+    free(t.coeffs);
+    free(t.exps);
+    return ok;
+}
+
+Poly PolyVecGet(const PolyVec *v, size_t lane) {
+    Mono *monos = (Mono *) malloc((v->terms + 1) * sizeof(struct Mono));
+    if (monos == NULL) {
+        return PolyZero();
+    }
+    poly_coeff_t coeff = 0;
+    unsigned n = 0;
+    for (size_t t = 0; t < v->terms; t++) {
+        poly_coeff_t c = v->coeffs[t * v->stride + lane];
+        if (c == 0) {
+            continue;
+        }
+        if (v->vars == 0) {
+            coeff += c;
+            continue;
+        }
+        // Jednomian budowany jest od najbardziej zagnieżdżonej zmiennej.
+        const poly_exp_t *e = &(v->exps[t * v->vars]);
+        Poly p = PolyFromCoeff(c);
+        for (unsigned var = v->vars - 1; var > 0; var--) {
+            Mono m = MonoFromPoly(&p, e[var]);
+            p = PolyAddMonos(1, &m);
+        }
+        monos[n++] = MonoFromPoly(&p, e[0]);
+    }
+    Poly res = PolyAddMonos(n, monos);
+    free(monos);
+    res.coeff += coeff;
+    return res;
+}
+
+void PolyVecDestroy(PolyVec *v) {
+    free(v->exps);
+    free(v->coeffs);
+    v->exps = NULL;
+    v->coeffs = NULL;
+    v->terms = 0;
+}
+
+bool PolyVecAdd(const PolyVec *a, const PolyVec *b, PolyVec *res) {
+    if (a->lanes != b->lanes || a->vars != b->vars) {
+        return false;
+    }
+    unsigned vars = a->vars;
+    size_t terms = 0;
+    for (size_t i = 0, j = 0; i < a->terms || j < b->terms; terms++) {
+        int cmp = (i == a->terms) ? 1 : (j == b->terms) ? -1
+                  : VecCompare(&(a->exps[i * vars]), &(b->exps[j * vars]), vars);
+        i += (cmp <= 0);
+        j += (cmp >= 0);
+    }
+    if (!VecAlloc(res, terms, a->lanes, vars)) {
+        return false;
+    }
+
+    const VecKernels *k = VecKernelsGet();
+    size_t stride = res->stride;
+    for (size_t i = 0, j = 0, t = 0; t < terms; t++) {
+        int cmp = (i == a->terms) ? 1 : (j == b->terms) ? -1
+                  : VecCompare(&(a->exps[i * vars]), &(b->exps[j * vars]), vars);
+        const poly_exp_t *e = (cmp <= 0) ? &(a->exps[i * vars]) : &(b->exps[j * vars]);
+        memcpy(&(res->exps[t * vars]), e, vars * sizeof(poly_exp_t));
+        if (cmp == 0) {
+            k->add(VecRow(res, t), VecRow(a, i), VecRow(b, j), stride);
+        }
+        else {
+            memcpy(VecRow(res, t), (cmp < 0) ? VecRow(a, i) : VecRow(b, j),
+                   stride * sizeof(uint64_t));
+        }
+        i += (cmp <= 0);
+        j += (cmp >= 0);
+    }
+    VecCompact(res);
+    return true;
+}
+
+bool PolyVecMul(const PolyVec *a, const PolyVec *b, PolyVec *res) {
+    if (a->lanes != b->lanes || a->vars != b->vars) {
+        return false;
+    }
+    unsigned vars = a->vars;
+    size_t pairs = a->terms * b->terms;
+
+    // Szkielet wyniku: posortowane sumy wykładników wszystkich par wyrazów.
+    poly_exp_t *sums = (poly_exp_t *) calloc(pairs * vars + 1, sizeof(poly_exp_t));
+    size_t *idx = (size_t *) malloc((2 * pairs + 1) * sizeof(size_t));
+    size_t *target = (size_t *) malloc((pairs + 1) * sizeof(size_t));
+    bool ok = sums != NULL && idx != NULL && target != NULL;
+    size_t terms = 0;
+    if (ok) {
+        for (size_t i = 0; i < a->terms; i++) {
+            for (size_t j = 0; j < b->terms; j++) {
+                poly_exp_t *s = &sums[(i * b->terms + j) * vars];
+                for (unsigned v = 0; v < vars; v++) {
+                    s[v] = a->exps[i * vars + v] + b->exps[j * vars + v];
+                }
+                idx[i * b->terms + j] = i * b->terms + j;
+            }
+        }
+        VecSortIndex(idx, idx + pairs, pairs, sums, vars);
+        for (size_t p = 0; p < pairs; p++) {
+            if (p > 0 && VecCompare(&sums[idx[p] * vars], &sums[idx[p - 1] * vars],
+                                    vars) != 0) {
+                terms++;
+            }
+            target[p] = terms;
+        }
+        terms = (pairs > 0) ? terms + 1 : 0;
+        ok = VecAlloc(res, terms, a->lanes, vars);
+    }
+
+    if (ok) {
+        // Pary przeglądane są w kolejności wyrazów wyniku, więc każdy
+        // wiersz wyniku sumowany jest w pamięci podręcznej.
+        const VecKernels *k = VecKernelsGet();
+        for (size_t p = 0; p < pairs; p++) {
+            size_t pair = idx[p];
+            size_t t = target[p];
+            memcpy(&(res->exps[t * vars]), &sums[pair * vars], vars * sizeof(poly_exp_t));
+            k->mul_add(VecRow(res, t), VecRow(a, pair / b->terms),
+                       VecRow(b, pair % b->terms), res->stride);
+        }
+        VecCompact(res);
+    }
+    free(target);
+    free(idx);
+    free(sums);
+    return ok;
+}
+
+/**
+ * Podnosi liczbę do potęgi modulo @f$2^{64}@f$.
+ * @param x : podstawa
+ * @param e : wykładnik
+ * @return @f$x^e@f$
+ */
+static uint64_t VecPow(uint64_t x, poly_exp_t e) {
+    uint64_t res = 1;
+    while (e > 0) {
+        if (e & 1) {
+            res *= x;
+        }
+        x *= x;
+        e >>= 1;
+    }
+    return res;
+}
+
+void PolyVecAt(const PolyVec *v, const poly_coeff_t x[], poly_coeff_t out[]) {
+    const VecKernels *k = VecKernelsGet();
+    uint64_t *acc = (uint64_t *) out;
+    memset(acc, 0, v->lanes * sizeof(uint64_t));
+    for (size_t t = 0; t < v->terms; t++) {
+        uint64_t m = 1;
+        for (unsigned var = 0; var < v->vars; var++) {
+            m *= VecPow((uint64_t) x[var], v->exps[t * v->vars + var]);
+        }
+        k->scale_add(acc, VecRow(v, t), m, v->lanes);
+    }
+}
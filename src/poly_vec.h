@@ -0,0 +1,102 @@
+/** @file
+   Interfejs wektorów wielomianów o wspólnym szkielecie wykładników
+
+   Wektor wielomianów przechowuje wiele wielomianów (pasów) w układzie
+   struktury tablic: jeden wspólny, posortowany szkielet wyrazów
+   (wektorów wykładników zmiennych @f$x_0, \ldots, x_{n-1}@f$) i macierz
+   współczynników, w której współczynniki jednego wyrazu wszystkich pasów
+   leżą obok siebie. Pas, w którym wyraz nie występuje, ma w nim
+   współczynnik 0.
+
+   Dodawanie i mnożenie wyliczają szkielet wyniku raz dla całego wektora,
+   a współczynniki wszystkich pasów liczone są naraz jądrami wektorowymi
+   AVX2, wybieranymi w czasie działania programu, gdy procesor je
+   obsługuje (w przeciwnym razie działają jądra skalarne). Arytmetyka
+   współczynników jest modulo @f$2^{64}@f$, tak jak przy przepełnieniu
+   w poly.h.
+
+   @author Konrad Komisarczyk
+   @copyright Uniwersytet Warszawski
+*/
+
+#ifndef __POLY_VEC_H__
+#define __POLY_VEC_H__
+
+#include <stddef.h>
+#include "poly.h"
+
+/**
+ * Wektor wielomianów o wspólnym szkielecie.
+ */
+typedef struct PolyVec {
+    poly_exp_t *exps; ///< wykładniki wyrazów szkieletu, po `vars` na wyraz
+    poly_coeff_t *coeffs; ///< współczynnik wyrazu `t` pasa `l` pod indeksem `t * stride + l`
+    size_t terms; ///< liczba wyrazów szkieletu
+    size_t lanes; ///< liczba pasów (wielomianów)
+    size_t stride; ///< odstęp między wyrazami w macierzy współczynników
+    unsigned vars; ///< liczba zmiennych
+} PolyVec;
+
+/**
+ * Tworzy wektor z wielomianów. Szkielet jest sumą zbiorów jednomianów
+ * wszystkich wielomianów, więc wektor jest zwarty, gdy wielomiany mają
+ * ten sam kształt i różnią się tylko współczynnikami.
+ * @param[in] polys : wielomiany
+ * @param[in] count : liczba wielomianów (pasów)
+ * @param[in] vars : liczba zmiennych, co najmniej `PolyDepth` każdego wielomianu
+ * @param[out] res : wektor
+ * @return Czy się udało? Fałsz, gdy @p vars jest za małe lub zabrakło pamięci.
+ */
+bool PolyVecFromPolys(const Poly polys[], size_t count, unsigned vars, PolyVec *res);
+
+/**
+ * Odczytuje jeden pas wektora jako wielomian.
+ * @param[in] v : wektor
+ * @param[in] lane : numer pasa
+ * @return wielomian
+ */
+Poly PolyVecGet(const PolyVec *v, size_t lane);
+
+/**
+ * Usuwa wektor z pamięci.
+ * @param[in] v : wektor
+ */
+void PolyVecDestroy(PolyVec *v);
+
+/**
+ * Dodaje wektory pas po pasie.
+ * @param[in] a : wektor
+ * @param[in] b : wektor o tej samej liczbie pasów i zmiennych
+ * @param[out] res : wektor `a + b`
+ * @return Czy się udało? Fałsz, gdy wektory są niezgodne lub zabrakło pamięci.
+ */
+bool PolyVecAdd(const PolyVec *a, const PolyVec *b, PolyVec *res);
+
+/**
+ * Mnoży wektory pas po pasie. Szkielet wyniku i przyporządkowanie par
+ * wyrazów czynników do wyrazów wyniku wyliczane są raz dla wszystkich pasów.
+ * @param[in] a : wektor
+ * @param[in] b : wektor o tej samej liczbie pasów i zmiennych
+ * @param[out] res : wektor `a * b`
+ * @return Czy się udało? Fałsz, gdy wektory są niezgodne lub zabrakło pamięci.
+ */
+bool PolyVecMul(const PolyVec *a, const PolyVec *b, PolyVec *res);
+
+/**
+ * Wylicza wartości wszystkich pasów w punkcie. Wartości jednomianów
+ * szkieletu liczone są raz, a sumy dla pasów jądrem wektorowym.
+ * @param[in] v : wektor
+ * @param[in] x : wartości zmiennych @f$x_0, \ldots, x_{vars-1}@f$
+ * @param[out] out : tablica na `lanes` wartości
+ */
+void PolyVecAt(const PolyVec *v, const poly_coeff_t x[], poly_coeff_t out[]);
+
+/**
+ * Włącza lub wyłącza jądra AVX2 (np. do porównania z jądrami skalarnymi).
+ * Domyślnie są włączone, jeśli procesor je obsługuje.
+ * @param[in] enable : czy używać jąder AVX2
+ * @return Czy jądra AVX2 są używane po zmianie?
+ */
+bool PolyVecEnableSimd(bool enable);
+
+#endif /* __POLY_VEC_H__ */
@@ -1,7 +1,21 @@
 #include "poly.h"
+#include "poly_async.h"
+#include "poly_batch.h"
+#include "poly_dist.h"
+#include "poly_hashcons.h"
+#include "poly_map.h"
+#include "poly_memo.h"
+#include "poly_resultant.h"
+#include "poly_series.h"
+#include "poly_roots.h"
+#include "poly_sched.h"
+#include "poly_shift.h"
+#include "poly_vec.h"
 #include "const_arr.h"
 #include <assert.h>
 #include <limits.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -30,6 +44,30 @@
 #define OVERFLOW "overflow"
 #define SIMPLE_ARITHMETIC "simple-aritmethic"
 #define SIMPLE_ARITHMETIC2 "simple-aritmethic2"
+#define DERIVATIVE "derivative"
+#define RESULTANT "resultant"
+#define SERIES "series"
+#define TAYLOR_SHIFT "taylor-shift"
+#define ROOTS "roots"
+#define HASHCONS "hashcons"
+#define CLONE "clone"
+#define MEMO "memo"
+#define HASH "hash"
+#define METADATA "metadata"
+#define DIST "dist"
+#define COMPACT "compact"
+#define MEMSTATS "memstats"
+#define MUL_PARALLEL "mul-parallel"
+#define SCHED "sched"
+#define ERRORS "errors"
+#define THREADS "threads"
+#define ADD_MONOS_BIG "add-monos-big"
+#define BATCH "batch"
+#define ASYNC "async"
+#define BUDGET "budget"
+#define VEC "vec"
+#define SUM_DOT "sum-dot"
+#define FMA "fma"
 
 bool SimpleArithmeticTest();
 
@@ -81,6 +119,54 @@ bool SimpleAtTest();
 
 bool OverflowTest();
 
+bool SimpleDerivativeTest();
+
+bool SimpleResultantTest();
+
+bool SimpleSeriesTest();
+
+bool SimpleTaylorShiftTest();
+
+bool SimpleRootsTest();
+
+bool SimpleHashConsTest();
+
+bool SimpleCloneTest();
+
+bool SimpleMemoTest();
+
+bool SimpleHashTest();
+
+bool SimpleMetadataTest();
+
+bool SimpleDistTest();
+
+bool CompactDistTest();
+
+bool AllocStatsTest();
+
+bool ParallelMulTest();
+
+bool SchedTest();
+
+bool ErrorReturnTest();
+
+bool ThreadStressTest();
+
+bool AddMonosBigTest();
+
+bool BatchTest();
+
+bool AsyncTest();
+
+bool BudgetTest();
+
+bool VecTest();
+
+bool SumDotTest();
+
+bool FmaTest();
+
 void MemoryThiefTest();
 
 void MemoryTest();
@@ -191,6 +277,102 @@ int main(int argc, char **argv)
     {
         return !OverflowTest();
     }
+    else if (strcmp(argv[1], DERIVATIVE) == 0)
+    {
+        return !SimpleDerivativeTest();
+    }
+    else if (strcmp(argv[1], RESULTANT) == 0)
+    {
+        return !SimpleResultantTest();
+    }
+    else if (strcmp(argv[1], SERIES) == 0)
+    {
+        return !SimpleSeriesTest();
+    }
+    else if (strcmp(argv[1], TAYLOR_SHIFT) == 0)
+    {
+        return !SimpleTaylorShiftTest();
+    }
+    else if (strcmp(argv[1], ROOTS) == 0)
+    {
+        return !SimpleRootsTest();
+    }
+    else if (strcmp(argv[1], HASHCONS) == 0)
+    {
+        return !SimpleHashConsTest();
+    }
+    else if (strcmp(argv[1], CLONE) == 0)
+    {
+        return !SimpleCloneTest();
+    }
+    else if (strcmp(argv[1], MEMO) == 0)
+    {
+        return !SimpleMemoTest();
+    }
+    else if (strcmp(argv[1], HASH) == 0)
+    {
+        return !SimpleHashTest();
+    }
+    else if (strcmp(argv[1], METADATA) == 0)
+    {
+        return !SimpleMetadataTest();
+    }
+    else if (strcmp(argv[1], DIST) == 0)
+    {
+        return !SimpleDistTest();
+    }
+    else if (strcmp(argv[1], COMPACT) == 0)
+    {
+        return !CompactDistTest();
+    }
+    else if (strcmp(argv[1], MEMSTATS) == 0)
+    {
+        return !AllocStatsTest();
+    }
+    else if (strcmp(argv[1], MUL_PARALLEL) == 0)
+    {
+        return !ParallelMulTest();
+    }
+    else if (strcmp(argv[1], SCHED) == 0)
+    {
+        return !SchedTest();
+    }
+    else if (strcmp(argv[1], ERRORS) == 0)
+    {
+        return !ErrorReturnTest();
+    }
+    else if (strcmp(argv[1], THREADS) == 0)
+    {
+        return !ThreadStressTest();
+    }
+    else if (strcmp(argv[1], ADD_MONOS_BIG) == 0)
+    {
+        return !AddMonosBigTest();
+    }
+    else if (strcmp(argv[1], BATCH) == 0)
+    {
+        return !BatchTest();
+    }
+    else if (strcmp(argv[1], ASYNC) == 0)
+    {
+        return !AsyncTest();
+    }
+    else if (strcmp(argv[1], BUDGET) == 0)
+    {
+        return !BudgetTest();
+    }
+    else if (strcmp(argv[1], VEC) == 0)
+    {
+        return !VecTest();
+    }
+    else if (strcmp(argv[1], SUM_DOT) == 0)
+    {
+        return !SumDotTest();
+    }
+    else if (strcmp(argv[1], FMA) == 0)
+    {
+        return !FmaTest();
+    }
     else if (strcmp(argv[1], ALL_TESTS) == 0)
     {
         int res = 0;
@@ -219,7 +401,31 @@ int main(int argc, char **argv)
         res += SimpleIsEqTest();
         res += SimpleAtTest();//
         res += OverflowTest();
-        printf("%d of 20 tests passed\n", res);
+        res += SimpleDerivativeTest();
+        res += SimpleResultantTest();
+        res += SimpleSeriesTest();
+        res += SimpleTaylorShiftTest();
+        res += SimpleRootsTest();
+        res += SimpleHashConsTest();
+        res += SimpleCloneTest();
+        res += SimpleMemoTest();
+        res += SimpleHashTest();
+        res += SimpleMetadataTest();
+        res += SimpleDistTest();
+        res += CompactDistTest();
+        res += AllocStatsTest();
+        res += ParallelMulTest();
+        res += SchedTest();
+        res += ErrorReturnTest();
+        res += ThreadStressTest();
+        res += AddMonosBigTest();
+        res += BatchTest();
+        res += AsyncTest();
+        res += BudgetTest();
+        res += VecTest();
+        res += SumDotTest();
+        res += FmaTest();
+        printf("%d of 44 tests passed\n", res);
     }
     else
     {
@@ -261,6 +467,30 @@ void PrintHelp(char *program_name)
     printf("\t%-*s - run simple equality test\n", width, EQ_SIMPLE);
     printf("\t%-*s - run rare polynomial test\n", width, RARE);
     printf("\t%-*s - run overflow test\n", width, OVERFLOW);
+    printf("\t%-*s - run derivative and gradient test\n", width, DERIVATIVE);
+    printf("\t%-*s - run resultant and discriminant test\n", width, RESULTANT);
+    printf("\t%-*s - run truncated multiplication and series test\n", width, SERIES);
+    printf("\t%-*s - run taylor shift test\n", width, TAYLOR_SHIFT);
+    printf("\t%-*s - run real root isolation test\n", width, ROOTS);
+    printf("\t%-*s - run hash-consing test\n", width, HASHCONS);
+    printf("\t%-*s - run copy-on-write clone test\n", width, CLONE);
+    printf("\t%-*s - run memoization cache test\n", width, MEMO);
+    printf("\t%-*s - run hashing and polynomial map test\n", width, HASH);
+    printf("\t%-*s - run cached degree and size test\n", width, METADATA);
+    printf("\t%-*s - run distributed representation test\n", width, DIST);
+    printf("\t%-*s - run adaptive coefficient width test\n", width, COMPACT);
+    printf("\t%-*s - run memory accounting test\n", width, MEMSTATS);
+    printf("\t%-*s - run parallel multiplication test\n", width, MUL_PARALLEL);
+    printf("\t%-*s - run work-stealing scheduler test\n", width, SCHED);
+    printf("\t%-*s - run error return test\n", width, ERRORS);
+    printf("\t%-*s - run multithreaded stress test\n", width, THREADS);
+    printf("\t%-*s - run large PolyAddMonos batch test\n", width, ADD_MONOS_BIG);
+    printf("\t%-*s - run batch job test\n", width, BATCH);
+    printf("\t%-*s - run asynchronous operations and cancellation test\n", width, ASYNC);
+    printf("\t%-*s - run resource budget test\n", width, BUDGET);
+    printf("\t%-*s - run polynomial vector (SIMD) test\n", width, VEC);
+    printf("\t%-*s - run PolySumN and PolyDot test\n", width, SUM_DOT);
+    printf("\t%-*s - run fused multiply-add test\n", width, FMA);
 }
 
 /**
@@ -1690,3 +1920,1786 @@ void MemoryTest()
     PolyDestroy(&p3);
     PolyDestroy(&p4);
 }
+
+bool TestDerivative(Poly a, unsigned var_idx, Poly res)
+{
+    Poly b = PolyDerivative(&a, var_idx);
+    bool is_eq = PolyIsEq(&b, &res);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    PolyDestroy(&res);
+    return is_eq;
+}
+
+bool SimpleDerivativeTest()
+{
+    bool res = true;
+    res &= TestDerivative(C(5), 0, C(0));
+    res &= TestDerivative(P(C(3), 2), 0, P(C(6), 1));
+    res &= TestDerivative(P(C(1), 0, C(1), 1), 0, C(1));
+    res &= TestDerivative(POLY_P, 0, P(P(C(2), 2), 1, C(3), 2));
+    res &= TestDerivative(POLY_P, 1, P(P(C(3), 2), 0, P(C(2), 1), 2));
+    res &= TestDerivative(P(P(C(1), 1), 1), 1, P(C(1), 1));
+    {
+        Poly p = POLY_P;
+        Poly grad[3];
+        PolyGradient(&p, grad, 3);
+        for (unsigned i = 0; i < 3; i++)
+        {
+            Poly d = PolyDerivative(&p, i);
+            res &= PolyIsEq(&d, &grad[i]);
+            PolyDestroy(&d);
+            PolyDestroy(&grad[i]);
+        }
+        PolyDestroy(&p);
+    }
+    if (!res)
+        fprintf(stderr, "[SimpleDerivativeTest] fail\n");
+    return res;
+}
+
+bool TestResultant(Poly a, Poly b, unsigned var_idx, Poly res)
+{
+    Poly c = PolyResultant(&a, &b, var_idx);
+    Poly d = PolyResultantParallel(&a, &b, var_idx, 2);
+    bool is_eq = PolyIsEq(&c, &res) && PolyIsEq(&d, &res);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    PolyDestroy(&c);
+    PolyDestroy(&d);
+    PolyDestroy(&res);
+    return is_eq;
+}
+
+bool TestDiscriminant(Poly a, unsigned var_idx, Poly res)
+{
+    Poly b = PolyDiscriminant(&a, var_idx);
+    bool is_eq = PolyIsEq(&b, &res);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    PolyDestroy(&res);
+    return is_eq;
+}
+
+bool SimpleResultantTest()
+{
+    bool res = true;
+    // Res_x(x^2 - y, x - 1) = 1 - y
+    res &= TestResultant(
+            P(P(C(-1), 1), 0, C(1), 2),
+            P(C(-1), 0, C(1), 1),
+            0,
+            P(C(1), 0, C(-1), 1));
+    // Res_y(x - y, y^2 - 2) = x^2 - 2
+    res &= TestResultant(
+            P(P(C(-1), 1), 0, C(1), 1),
+            P(P(C(-2), 0, C(1), 2), 0),
+            1,
+            P(C(-2), 0, C(1), 2));
+    // Res_x((x - 1)(x - 2), (x - 1)(x + 3)) = 0
+    res &= TestResultant(
+            P(C(2), 0, C(-3), 1, C(1), 2),
+            P(C(-3), 0, C(2), 1, C(1), 2),
+            0,
+            C(0));
+    // Res_x(2x^3 + x + 5, 3x^2 - 4) = 191
+    res &= TestResultant(
+            P(C(5), 0, C(1), 1, C(2), 3),
+            P(C(-4), 0, C(3), 2),
+            0,
+            C(191));
+    // Disc_x(x^2 + yx + z) = y^2 - 4z
+    res &= TestDiscriminant(
+            P(P(P(C(1), 1), 0), 0, P(C(1), 1), 1, C(1), 2),
+            0,
+            P(P(C(-4), 1), 0, C(1), 2));
+    // Disc_x(x^3 - 3x + 1) = 81
+    res &= TestDiscriminant(P(C(1), 0, C(-3), 1, C(1), 3), 0, C(81));
+    if (!res)
+        fprintf(stderr, "[SimpleResultantTest] fail\n");
+    return res;
+}
+
+bool TestMulTrunc(Poly a, Poly b, poly_exp_t n, Poly res)
+{
+    Poly c = PolyMulTrunc(&a, &b, n);
+    bool is_eq = PolyIsEq(&c, &res);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    PolyDestroy(&c);
+    PolyDestroy(&res);
+    return is_eq;
+}
+
+bool TestSeries(bool (*op)(const Poly *, poly_exp_t, poly_coeff_t, Poly *),
+                Poly a, poly_exp_t n, poly_coeff_t mod, Poly res)
+{
+    Poly b;
+    bool is_eq = op(&a, n, mod, &b);
+    if (is_eq)
+    {
+        is_eq = PolyIsEq(&b, &res);
+        PolyDestroy(&b);
+    }
+    PolyDestroy(&a);
+    PolyDestroy(&res);
+    return is_eq;
+}
+
+bool SimpleSeriesTest()
+{
+    bool res = true;
+    res &= TestMulTrunc(
+            P(C(1), 0, C(1), 1),
+            P(C(1), 0, C(1), 1),
+            2,
+            P(C(1), 0, C(2), 1));
+    res &= TestMulTrunc(
+            P(C(1), 0, P(C(1), 1), 1, C(1), 3),
+            P(P(C(2), 1), 0, C(1), 2),
+            3,
+            P(P(C(2), 1), 0, P(C(2), 2), 1, C(1), 2));
+    res &= TestMulTrunc(P(C(1), 5), P(C(1), 5), 10, C(0));
+    {
+        // (1 + x + y)^3 obcięte do stopnia < 2 to 1 + 3x + 3y
+        Poly a = P(P(C(1), 0, C(1), 1), 0, C(1), 1);
+        Poly b = PolyPowTruncDeg(&a, 3, 2);
+        Poly c = P(P(C(1), 0, C(3), 1), 0, C(3), 1);
+        res &= PolyIsEq(&b, &c);
+        PolyDestroy(&b);
+        PolyDestroy(&c);
+        // x^2 y^2 * (x + y^3) obcięte do stopnia < 6 to x^3 y^2
+        Poly d = P(P(C(1), 2), 2);
+        Poly e = P(P(C(1), 3), 0, C(1), 1);
+        b = PolyMulTruncDeg(&d, &e, 6);
+        c = P(P(C(1), 2), 3);
+        res &= PolyIsEq(&b, &c);
+        PolyDestroy(&b);
+        PolyDestroy(&c);
+        PolyDestroy(&d);
+        PolyDestroy(&e);
+        PolyDestroy(&a);
+    }
+    {
+        // 1 / (1 - x) = 1 + x + x^2 + x^3 + x^4
+        Poly a = P(C(1), 0, C(-1), 1);
+        Poly b;
+        res &= PolySeriesInv(&a, 5, &b);
+        Poly c = P(C(1), 0, C(1), 1, C(1), 2, C(1), 3, C(1), 4);
+        res &= PolyIsEq(&b, &c);
+        PolyDestroy(&a);
+        PolyDestroy(&b);
+        PolyDestroy(&c);
+        a = P(C(2), 0, C(1), 1);
+        res &= !PolySeriesInv(&a, 5, &b);
+        PolyDestroy(&a);
+    }
+    // exp(x) = 1 + x + x^2 / 2 + x^3 / 6 (mod 7)
+    res &= TestSeries(PolySeriesExp, P(C(1), 1), 4, 7,
+                      P(C(1), 0, C(1), 1, C(4), 2, C(6), 3));
+    // log(1 + x) = x - x^2 / 2 + x^3 / 3 (mod 7)
+    res &= TestSeries(PolySeriesLog, P(C(1), 0, C(1), 1), 4, 7,
+                      P(C(1), 1, C(3), 2, C(5), 3));
+    // sqrt(1 + 2x + x^2) = 1 + x
+    res &= TestSeries(PolySeriesSqrt, P(C(1), 0, C(2), 1, C(1), 2), 6, 101,
+                      P(C(1), 0, C(1), 1));
+    {
+        // exp(log(p)) = p
+        Poly a = P(C(1), 0, P(C(3), 1), 1, C(5), 2, C(2), 7);
+        Poly l, e;
+        res &= PolySeriesLog(&a, 8, 1000003, &l);
+        res &= PolySeriesExp(&l, 8, 1000003, &e);
+        res &= PolyIsEq(&a, &e);
+        PolyDestroy(&a);
+        PolyDestroy(&l);
+        PolyDestroy(&e);
+    }
+    if (!res)
+        fprintf(stderr, "[SimpleSeriesTest] fail\n");
+    return res;
+}
+
+bool TestTaylorShift(Poly a, poly_coeff_t shift, Poly res)
+{
+    Poly b = PolyTaylorShift(&a, shift);
+    bool is_eq = PolyIsEq(&b, &res);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    PolyDestroy(&res);
+    return is_eq;
+}
+
+bool SimpleTaylorShiftTest()
+{
+    bool res = true;
+    res &= TestTaylorShift(C(5), 3, C(5));
+    // x^2 -> (x + 1)^2
+    res &= TestTaylorShift(P(C(1), 2), 1, P(C(1), 0, C(2), 1, C(1), 2));
+    // x^2 y + x (y^2 + 3) + 5 -> (x + 2)^2 y + (x + 2) (y^2 + 3) + 5
+    res &= TestTaylorShift(
+            P(C(5), 0, P(C(3), 0, C(1), 2), 1, P(C(1), 1), 2),
+            2,
+            P(P(C(11), 0, C(4), 1, C(2), 2), 0,
+              P(C(3), 0, C(4), 1, C(1), 2), 1,
+              P(C(1), 1), 2));
+    {
+        // Porównanie ze schematem Hornera dla długich wielomianów
+        const size_t sizes[] = {33, 64, 100, 1000, 4097};
+        srand(7);
+        for (size_t t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++)
+        {
+            size_t n = sizes[t];
+            poly_coeff_t *c = malloc(n * sizeof(poly_coeff_t));
+            unsigned long *d = malloc(n * sizeof(unsigned long));
+            for (size_t i = 0; i < n; i++)
+                d[i] = (unsigned long)(c[i] = rand() % 201 - 100);
+            PolyTaylorShiftCoeffs(c, n, -3);
+            for (size_t i = 0; i + 1 < n; i++)
+                for (size_t j = n - 1; j > i; j--)
+                    d[j - 1] -= 3 * d[j];
+            for (size_t i = 0; i < n; i++)
+                res &= (unsigned long)c[i] == d[i];
+            free(c);
+            free(d);
+        }
+    }
+    {
+        // p(x + a, y) w punktach x = t jest równe p(t + a, y)
+        Poly a = P(P(C(1), 0, C(-2), 3), 0, C(7), 40, P(C(3), 1, C(1), 5), 77);
+        Poly b = PolyTaylorShift(&a, -2);
+        for (poly_coeff_t t = -3; t <= 3; t++)
+        {
+            Poly x = PolyAt(&b, t);
+            Poly y = PolyAt(&a, t - 2);
+            res &= PolyIsEq(&x, &y);
+            PolyDestroy(&x);
+            PolyDestroy(&y);
+        }
+        PolyDestroy(&a);
+        PolyDestroy(&b);
+    }
+    if (!res)
+        fprintf(stderr, "[SimpleTaylorShiftTest] fail\n");
+    return res;
+}
+
+/**
+ * Sprawdza, czy przedział zawiera liczbę @p x
+ * @param r przedział
+ * @param x liczba
+ * @return czy `x` leży w przedziale (lub jest jego jedynym punktem)
+ */
+bool RootIntervalContains(RootInterval r, double x)
+{
+    double left = (double)r.left / (double)(1UL << r.scale);
+    double right = (double)r.right / (double)(1UL << r.scale);
+    if (r.left == r.right)
+        return left == x;
+    return left < x && x < right;
+}
+
+bool SimpleRootsTest()
+{
+    bool res = true;
+    RootInterval out[8];
+    size_t count;
+    {
+        // x (2x - 1) (x + 3) (x^2 - 2)
+        Poly a = P(C(6), 1, C(-10), 2, C(-7), 3, C(5), 4, C(2), 5);
+        const double sqrt2 = 1.4142135623730951;
+        const double roots[] = {-3, -sqrt2, 0, 0.5, sqrt2};
+        res &= PolyRealRootIntervals(&a, out, &count);
+        res &= count == 5;
+        for (size_t i = 0; i < count && i < 5; i++)
+            res &= RootIntervalContains(out[i], roots[i]);
+        PolyDestroy(&a);
+    }
+    {
+        // (x - 1000)(x - 1001) (x^2 + 1)
+        Poly a = P(C(1001000), 0, C(-2001), 1, C(1001001), 2, C(-2001), 3, C(1), 4);
+        res &= PolyRealRootIntervals(&a, out, &count);
+        res &= count == 2;
+        res &= count == 2 && RootIntervalContains(out[0], 1000)
+               && RootIntervalContains(out[1], 1001);
+        PolyDestroy(&a);
+    }
+    {
+        // x^2 + 1 nie ma pierwiastków rzeczywistych
+        Poly a = P(C(1), 0, C(1), 2);
+        res &= PolyRealRootIntervals(&a, out, &count) && count == 0;
+        PolyDestroy(&a);
+        a = C(5);
+        res &= PolyRealRootIntervals(&a, out, &count) && count == 0;
+        a = C(0);
+        res &= !PolyRealRootIntervals(&a, out, &count);
+        a = P(P(C(1), 1), 1);
+        res &= !PolyRealRootIntervals(&a, out, &count);
+        PolyDestroy(&a);
+    }
+    if (!res)
+        fprintf(stderr, "[SimpleRootsTest] fail\n");
+    return res;
+}
+
+bool SimpleHashConsTest()
+{
+    bool res = true;
+    PolyTable *t = PolyTableNew();
+    // (x_1 + 1) x_0 + (x_1 + 1) x_0^2 - współczynniki są wspólne
+    Poly a = P(P(C(1), 0, C(1), 1), 1, P(C(1), 0, C(1), 1), 2);
+    Poly b = P(P(C(1), 0, C(1), 1), 1, P(C(1), 0, C(1), 1), 2);
+    Poly c = P(P(C(1), 0, C(2), 1), 1, P(C(1), 0, C(1), 1), 2);
+    Poly ia = PolyIntern(t, &a);
+    res &= PolyTableSize(t) == 3;
+    Poly ib = PolyIntern(t, &b);
+    res &= PolyTableSize(t) == 3;
+    res &= PolyInternedIsEq(&ia, &ib);
+    res &= PolyIsEq(&ia, &a);
+    Poly ic = PolyIntern(t, &c);
+    res &= !PolyInternedIsEq(&ia, &ic);
+    res &= PolyIsEq(&ic, &c);
+    // x_0^2 wspólny ogon
+    res &= ia.list->tail == ic.list->tail;
+    {
+        // operacje przyjmują internowane wielomiany
+        Poly sum = PolyAdd(&ia, &ib);
+        Poly expected = PolyAdd(&a, &b);
+        res &= PolyIsEq(&sum, &expected);
+        Poly isum = PolyIntern(t, &sum);
+        Poly iexpected = PolyIntern(t, &expected);
+        res &= PolyInternedIsEq(&isum, &iexpected);
+        PolyDestroy(&sum);
+        PolyDestroy(&expected);
+    }
+    Poly k = C(7);
+    Poly ik = PolyIntern(t, &k);
+    res &= PolyIsCoeff(&ik) && ik.coeff == 7;
+    // kopia internowanego wielomianu przeżywa tablicę
+    Poly kept = PolyClone(&ic);
+    PolyTableDestroy(t);
+    res &= PolyIsEq(&kept, &c);
+    PolyDestroy(&kept);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    PolyDestroy(&c);
+    if (!res)
+        fprintf(stderr, "[SimpleHashConsTest] fail\n");
+    return res;
+}
+
+bool SimpleCloneTest()
+{
+    bool res = true;
+    // x_0 + x_0^2 + x_0^3
+    Poly a = P(C(1), 1, C(1), 2, C(1), 3);
+    Poly b = PolyClone(&a);
+    res &= a.list == b.list;
+    {
+        // wynik dodawania stałej współdzieli listę z argumentem
+        Poly c = C(5);
+        Poly sum = PolyAdd(&b, &c);
+        PolyDestroy(&b);
+        res &= sum.list == a.list;
+        Poly expected = P(C(5), 0, C(1), 1, C(1), 2, C(1), 3);
+        res &= PolyIsEq(&sum, &expected);
+        PolyDestroy(&expected);
+        PolyDestroy(&sum);
+    }
+    {
+        // sumowanie jednomianów o współdzielonych współczynnikach
+        // nie zmienia oryginału
+        Mono m[3];
+        for (int i = 0; i < 3; i++)
+        {
+            Poly copy = PolyClone(&a);
+            m[i] = MonoFromPoly(&copy, i % 2 + 1);
+        }
+        Poly sum = PolyAddMonos(3, m);
+        Poly expected = P(P(C(2), 1, C(2), 2, C(2), 3), 1,
+                          P(C(1), 1, C(1), 2, C(1), 3), 2);
+        Poly a_copy = P(C(1), 1, C(1), 2, C(1), 3);
+        res &= PolyIsEq(&sum, &expected);
+        res &= PolyIsEq(&a, &a_copy);
+        PolyDestroy(&a_copy);
+        PolyDestroy(&expected);
+        PolyDestroy(&sum);
+    }
+    PolyDestroy(&a);
+    if (!res)
+        fprintf(stderr, "[SimpleCloneTest] fail\n");
+    return res;
+}
+
+bool SimpleMemoTest()
+{
+    bool res = true;
+    PolyMemo *m = PolyMemoNew(1 << 20);
+    // x_0 + 1
+    Poly a = P(C(1), 0, C(1), 1);
+    // x_1 * x_0
+    Poly b = P(P(C(1), 1), 1);
+    {
+        Poly r1 = PolyMemoMul(m, &a, &b);
+        Poly b_copy = P(P(C(1), 1), 1);
+        Poly r2 = PolyMemoMul(m, &a, &b_copy);
+        Poly expected = PolyMul(&a, &b);
+        res &= PolyIsEq(&r1, &expected) && PolyIsEq(&r2, &expected);
+        PolyMemoStats s = PolyMemoGetStats(m);
+        res &= s.hits == 1 && s.misses == 1 && s.entries == 1;
+        PolyDestroy(&expected);
+        PolyDestroy(&b_copy);
+        PolyDestroy(&r1);
+        PolyDestroy(&r2);
+    }
+    {
+        Poly r1 = PolyMemoAdd(m, &a, &b);
+        Poly r2 = PolyMemoAdd(m, &a, &b);
+        Poly expected = PolyAdd(&a, &b);
+        res &= PolyIsEq(&r1, &expected) && PolyIsEq(&r2, &expected);
+        PolyDestroy(&expected);
+        PolyDestroy(&r1);
+        PolyDestroy(&r2);
+        // inny punkt to inny wpis
+        Poly at2 = PolyMemoAt(m, &a, 2);
+        Poly at3 = PolyMemoAt(m, &a, 3);
+        Poly at2_again = PolyMemoAt(m, &a, 2);
+        res &= at2.coeff == 3 && at3.coeff == 4 && at2_again.coeff == 3;
+        PolyMemoStats s = PolyMemoGetStats(m);
+        res &= s.hits == 3 && s.misses == 4 && s.entries == 4;
+        PolyDestroy(&at2);
+        PolyDestroy(&at3);
+        PolyDestroy(&at2_again);
+    }
+    PolyMemoFlush(m);
+    {
+        PolyMemoStats s = PolyMemoGetStats(m);
+        res &= s.entries == 0 && s.bytes == 0;
+        Poly r = PolyMemoMul(m, &a, &b);
+        res &= PolyMemoGetStats(m).misses == 5;
+        PolyDestroy(&r);
+    }
+    PolyMemoDestroy(m);
+
+    // mała pamięć mieści tylko kilka wpisów
+    m = PolyMemoNew(1024);
+    for (poly_coeff_t x = 0; x < 100; x++)
+    {
+        Poly r = PolyMemoAt(m, &a, x);
+        res &= r.coeff == x + 1;
+        PolyDestroy(&r);
+    }
+    {
+        PolyMemoStats s = PolyMemoGetStats(m);
+        res &= s.bytes <= 1024 && s.entries > 0 && s.evictions > 0;
+        res &= s.entries + s.evictions == 100;
+    }
+    PolyMemoDestroy(m);
+
+    // iloczyny współczynników w trakcie mnożenia też trafiają do pamięci:
+    // (x_1 + 1)^2 przy x_0^2 i przy x_0^3 liczone jest raz
+    m = PolyMemoNew(1 << 20);
+    {
+        Poly u = P(P(C(1), 0, C(1), 1), 1, P(C(1), 0, C(1), 1), 2);
+        Poly v = P(P(C(1), 0, C(1), 1), 1);
+        Poly r = PolyMemoMul(m, &u, &v);
+        Poly expected = PolyMul(&u, &v);
+        res &= PolyIsEq(&r, &expected);
+        PolyMemoStats s = PolyMemoGetStats(m);
+        res &= s.hits == 1 && s.misses == 2 && s.entries == 2;
+        PolyDestroy(&expected);
+        PolyDestroy(&r);
+        PolyDestroy(&u);
+        PolyDestroy(&v);
+    }
+    PolyMemoDestroy(m);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    if (!res)
+        fprintf(stderr, "[SimpleMemoTest] fail\n");
+    return res;
+}
+
+bool SimpleHashTest()
+{
+    bool res = true;
+    // x_0^2 * (x_1 + 3) + 5
+    Poly a = P(C(5), 0, P(C(3), 0, C(1), 1), 2);
+    {
+        // ten sam wielomian zbudowany inaczej ma ten sam skrót
+        Poly b1 = P(C(2), 0, P(C(1), 1), 2);
+        Poly b2 = P(C(3), 0, P(C(3), 0), 2);
+        Poly b = PolyAdd(&b1, &b2);
+        res &= PolyIsEq(&a, &b) && PolyHash(&a) == PolyHash(&b);
+        PolyDestroy(&b1);
+        PolyDestroy(&b2);
+        PolyDestroy(&b);
+    }
+    // skrót nie zależy od uruchomienia
+    res &= PolyHash(&a) == 0xc2f9a0c7b10ac4c2ULL;
+    {
+        Poly c = P(C(5), 0, P(C(3), 0, C(2), 1), 2);
+        res &= PolyHash(&a) != PolyHash(&c) && !PolyIsEq(&a, &c);
+        Poly five = C(5);
+        res &= PolyHash(&five) != PolyHash(&a);
+        PolyDestroy(&c);
+    }
+    {
+        PolyMap *m = PolyMapNew();
+        for (poly_coeff_t i = 0; i < 200; i++)
+        {
+            Poly key = P(C(i), 0, C(1), 1);
+            Poly value = C(i * i);
+            res &= PolyMapPut(m, &key, &value);
+            PolyDestroy(&key);
+        }
+        res &= PolyMapSize(m) == 200;
+        for (poly_coeff_t i = 0; i < 200; i += 2)
+        {
+            Poly key = P(C(i), 0, C(1), 1);
+            res &= PolyMapRemove(m, &key);
+            PolyDestroy(&key);
+        }
+        res &= PolyMapSize(m) == 100;
+        for (poly_coeff_t i = 0; i < 200; i++)
+        {
+            Poly key = P(C(i), 0, C(1), 1);
+            const Poly *value = PolyMapGet(m, &key);
+            res &= (i % 2 == 0) ? value == NULL
+                                : value != NULL && value->coeff == i * i;
+            PolyDestroy(&key);
+        }
+        Poly key = P(C(1), 0, C(1), 1);
+        Poly value = C(-1);
+        res &= !PolyMapPut(m, &key, &value);
+        res &= PolyMapGet(m, &key)->coeff == -1 && PolyMapSize(m) == 100;
+        PolyDestroy(&key);
+        PolyMapDestroy(m);
+    }
+    {
+        PolySet *s = PolySetNew();
+        res &= PolySetAdd(s, &a);
+        Poly a_copy = P(C(5), 0, P(C(3), 0, C(1), 1), 2);
+        res &= !PolySetAdd(s, &a_copy) && PolySetContains(s, &a_copy);
+        Poly zero = C(0);
+        res &= !PolySetContains(s, &zero) && PolySetAdd(s, &zero);
+        res &= PolySetSize(s) == 2 && PolySetRemove(s, &a_copy);
+        res &= !PolySetContains(s, &a) && PolySetContains(s, &zero);
+        PolyDestroy(&a_copy);
+        PolySetDestroy(s);
+    }
+    PolyDestroy(&a);
+    if (!res)
+        fprintf(stderr, "[SimpleHashTest] fail\n");
+    return res;
+}
+
+/**
+ * Sprawdza zapamiętane parametry wielomianu, licząc je rekurencyjnie.
+ * @param p : wielomian
+ * @param deg : stopień wyliczony rekurencyjnie
+ * @param terms : liczba jednomianów wyliczona rekurencyjnie
+ * @param depth : głębokość wyliczona rekurencyjnie
+ * @param nodes : liczba elementów list wyliczona rekurencyjnie
+ * @return czy parametry się zgadzają
+ */
+bool CheckMetadata(const Poly *p, poly_exp_t *deg, size_t *terms,
+                   unsigned *depth, size_t *nodes)
+{
+    bool res = true;
+    *deg = PolyIsZero(p) ? -1 : 0;
+    *terms = (p->coeff != 0);
+    *depth = 0;
+    *nodes = 0;
+    poly_exp_t deg_main = PolyIsZero(p) ? -1 : 0;
+    poly_exp_t ord = (p->coeff != 0) ? 0 : -1;
+    for (MonoList l = p->list; l != NULL; l = l->tail)
+    {
+        poly_exp_t d;
+        size_t t, n;
+        unsigned h;
+        res &= CheckMetadata(&(l->head->poly), &d, &t, &h, &n);
+        if (l->head->exp + d > *deg)
+            *deg = l->head->exp + d;
+        if (h + 1 > *depth)
+            *depth = h + 1;
+        *terms += t;
+        *nodes += n + 1;
+        deg_main = l->head->exp;
+        // rekurencyjne sprawdzenie potwierdziło już PolyOrd współczynnika
+        poly_exp_t o = l->head->exp + PolyOrd(&(l->head->poly));
+        if (ord < 0 || o < ord)
+            ord = o;
+    }
+    res &= PolyDeg(p) == *deg && PolyDegBy(p, 0) == deg_main && PolyOrd(p) == ord;
+    res &= PolyTermCount(p) == *terms && PolyDepth(p) == *depth;
+    res &= PolyNodeCount(p) == *nodes;
+    return res;
+}
+
+bool SimpleMetadataTest()
+{
+    bool res = true;
+    poly_exp_t deg;
+    size_t terms, nodes;
+    unsigned depth;
+    {
+        Poly zero = C(0);
+        Poly c = C(4);
+        res &= CheckMetadata(&zero, &deg, &terms, &depth, &nodes)
+               && deg == -1 && terms == 0 && depth == 0 && nodes == 0;
+        res &= CheckMetadata(&c, &deg, &terms, &depth, &nodes)
+               && deg == 0 && terms == 1 && depth == 0 && nodes == 0;
+    }
+    // (x_1^2 + 1) * x_0 + x_0^3 + 7
+    Poly a = P(C(7), 0, P(C(1), 0, C(1), 2), 1, C(1), 3);
+    res &= CheckMetadata(&a, &deg, &terms, &depth, &nodes)
+           && deg == 3 && terms == 4 && depth == 2 && nodes == 3;
+    res &= PolyDegBy(&a, 0) == 3 && PolyDegBy(&a, 1) == 2;
+    // x_2 * x_0^2 - x_1
+    Poly b = P(P(C(-1), 1), 0, P(P(C(1), 1), 0), 2);
+    res &= CheckMetadata(&b, &deg, &terms, &depth, &nodes);
+    Poly x = PolyClone(&a);
+    for (int i = 0; i < 6; i++)
+    {
+        Poly mul = PolyMul(&x, (i % 2) ? &a : &b);
+        Poly sum = PolyAdd(&mul, &b);
+        Poly sub = PolySub(&sum, &a);
+        res &= CheckMetadata(&mul, &deg, &terms, &depth, &nodes);
+        res &= CheckMetadata(&sum, &deg, &terms, &depth, &nodes);
+        res &= CheckMetadata(&sub, &deg, &terms, &depth, &nodes);
+        PolyDestroy(&x);
+        PolyDestroy(&mul);
+        PolyDestroy(&sum);
+        x = sub;
+    }
+    // wyrazy się redukują i stopień maleje
+    Poly neg = PolyNeg(&x);
+    Poly hi = P(C(1), 20);
+    Poly y = PolyAdd(&x, &hi);
+    Poly z = PolyAdd(&y, &neg);
+    res &= CheckMetadata(&z, &deg, &terms, &depth, &nodes)
+           && deg == 20 && terms == 1 && depth == 1 && nodes == 1;
+    PolyDestroy(&neg);
+    PolyDestroy(&hi);
+    PolyDestroy(&y);
+    PolyDestroy(&z);
+    PolyDestroy(&x);
+    PolyDestroy(&a);
+    PolyDestroy(&b);
+    if (!res)
+        fprintf(stderr, "[SimpleMetadataTest] fail\n");
+    return res;
+}
+
+/**
+ * Sprawdza, czy wyrazy wielomianu rozproszonego są posortowane malejąco
+ * w jego porządku.
+ * @param d : wielomian rozproszony
+ * @return czy wyrazy są posortowane
+ */
+bool DistIsSorted(const PolyDist *d)
+{
+    poly_exp_t a[12], b[12];
+    for (size_t i = 0; i + 1 < d->count; i++)
+    {
+        PolyDistTermExps(d, i, a);
+        PolyDistTermExps(d, i + 1, b);
+        poly_exp_t da = 0, db = 0;
+        for (unsigned v = 0; v < d->vars; v++)
+        {
+            da += a[v];
+            db += b[v];
+        }
+        if (d->order != POLY_LEX && da != db)
+        {
+            if (da < db)
+                return false;
+            continue;
+        }
+        unsigned v = 0;
+        if (d->order == POLY_GREVLEX)
+        {
+            v = d->vars - 1;
+            while (a[v] == b[v])
+                v--;
+            if (a[v] >= b[v])
+                return false;
+        }
+        else
+        {
+            while (a[v] == b[v])
+                v++;
+            if (a[v] <= b[v])
+                return false;
+        }
+    }
+    return true;
+}
+
+bool SimpleDistTest()
+{
+    bool res = true;
+    const PolyOrder orders[] = {POLY_LEX, POLY_GRLEX, POLY_GREVLEX};
+    // (x_1^2 + 3) * x_0^2 - 2 * x_1 * x_2^3 + x_0 * x_2 + 5
+    Poly a = P(C(5), 0, P(P(C(1), 1), 0, C(1), 1), 1, P(C(3), 0, C(1), 2), 2);
+    Poly a_term = P(P(P(C(-2), 3), 1), 0);
+    Poly a_full = PolyAdd(&a, &a_term);
+    // x_0 * x_1 - x_1^2 * x_2 + 7
+    Poly b = P(P(C(7), 0, P(C(-1), 1), 2), 0, P(C(1), 1), 1);
+    for (int k = 0; k < 3; k++)
+    {
+        PolyDist da, db, sum, mul;
+        res &= PolyDistFromPoly(&a_full, 3, orders[k], &da);
+        res &= PolyDistFromPoly(&b, 3, orders[k], &db);
+        res &= da.count == PolyTermCount(&a_full) && da.deg == PolyDeg(&a_full);
+        res &= DistIsSorted(&da) && DistIsSorted(&db);
+        {
+            Poly back = PolyDistToPoly(&da);
+            res &= PolyIsEq(&back, &a_full);
+            PolyDestroy(&back);
+        }
+        res &= PolyDistAdd(&da, &db, &sum) && PolyDistMul(&da, &db, &mul);
+        res &= DistIsSorted(&sum) && DistIsSorted(&mul);
+        {
+            Poly expected_sum = PolyAdd(&a_full, &b);
+            Poly expected_mul = PolyMul(&a_full, &b);
+            Poly got_sum = PolyDistToPoly(&sum);
+            Poly got_mul = PolyDistToPoly(&mul);
+            res &= PolyIsEq(&got_sum, &expected_sum);
+            res &= PolyIsEq(&got_mul, &expected_mul);
+            res &= mul.deg == PolyDeg(&expected_mul);
+            PolyDestroy(&expected_sum);
+            PolyDestroy(&expected_mul);
+            PolyDestroy(&got_sum);
+            PolyDestroy(&got_mul);
+        }
+        {
+            // p - p = 0
+            Poly neg = PolyNeg(&a_full);
+            PolyDist dn, zero;
+            res &= PolyDistFromPoly(&neg, 3, orders[k], &dn);
+            res &= PolyDistAdd(&da, &dn, &zero) && zero.count == 0;
+            Poly z = PolyDistToPoly(&zero);
+            res &= PolyIsZero(&z);
+            PolyDistDestroy(&dn);
+            PolyDistDestroy(&zero);
+            PolyDestroy(&neg);
+        }
+        {
+            // kolejne potęgi wymagają szerszych pól wykładników
+            PolyDist pow;
+            Poly expected = PolyClone(&a_full);
+            res &= PolyDistFromPoly(&a_full, 12, orders[k], &pow);
+            res &= pow.words == 1;
+            for (int i = 0; i < 4; i++)
+            {
+                PolyDist next;
+                res &= PolyDistMul(&pow, &pow, &next);
+                PolyDistDestroy(&pow);
+                pow = next;
+                Poly sq = PolyMul(&expected, &expected);
+                PolyDestroy(&expected);
+                expected = sq;
+            }
+            Poly got = PolyDistToPoly(&pow);
+            res &= PolyIsEq(&got, &expected) && pow.deg == 64;
+            res &= pow.words == 2;
+            res &= DistIsSorted(&pow);
+            PolyDestroy(&got);
+            PolyDestroy(&expected);
+            PolyDistDestroy(&pow);
+        }
+        PolyDistDestroy(&da);
+        PolyDistDestroy(&db);
+        PolyDistDestroy(&sum);
+        PolyDistDestroy(&mul);
+    }
+    {
+        // x_0 > x_1 w grevlex, ale x_1^2 > x_0 * x_2
+        Poly p1 = P(P(P(C(1), 1), 0), 1);
+        Poly p2 = P(C(1), 1);
+        Poly p = PolyAdd(&p1, &p2);
+        Poly q = P(P(C(1), 2), 0);
+        PolyDist dp, dq, sum;
+        res &= PolyDistFromPoly(&p, 3, POLY_GREVLEX, &dp);
+        res &= PolyDistFromPoly(&q, 3, POLY_GREVLEX, &dq);
+        res &= PolyDistAdd(&dp, &dq, &sum) && sum.count == 3;
+        poly_exp_t e[3];
+        PolyDistTermExps(&sum, 0, e);
+        res &= e[0] == 0 && e[1] == 2 && e[2] == 0;
+        PolyDistTermExps(&sum, 1, e);
+        res &= e[0] == 1 && e[1] == 0 && e[2] == 1;
+        PolyDistTermExps(&sum, 2, e);
+        res &= e[0] == 1 && e[1] == 0 && e[2] == 0;
+        PolyDistDestroy(&dp);
+        PolyDistDestroy(&dq);
+        PolyDistDestroy(&sum);
+        PolyDestroy(&p1);
+        PolyDestroy(&p2);
+        PolyDestroy(&p);
+        PolyDestroy(&q);
+    }
+    {
+        // za mało zmiennych albo za dużo pól
+        PolyDist d;
+        res &= !PolyDistFromPoly(&a_full, 2, POLY_LEX, &d);
+        Poly c = C(-4);
+        res &= PolyDistFromPoly(&c, 0, POLY_GRLEX, &d) && d.count == 1;
+        Poly back = PolyDistToPoly(&d);
+        res &= PolyIsEq(&back, &c);
+        PolyDistDestroy(&d);
+        res &= !PolyDistFromPoly(&c, 200, POLY_LEX, &d);
+    }
+    PolyDestroy(&a);
+    PolyDestroy(&a_term);
+    PolyDestroy(&a_full);
+    PolyDestroy(&b);
+    if (!res)
+        fprintf(stderr, "[SimpleDistTest] fail\n");
+    return res;
+}
+
+bool CompactDistTest()
+{
+    bool res = true;
+    {
+        // -128 mieści się w jednym bajcie, 128 już nie
+        Poly p = P(C(-128), 1, C(127), 2);
+        Poly q = P(C(1), 2);
+        PolyDist dp, dq, sum;
+        res &= PolyDistFromPoly(&p, 1, POLY_LEX, &dp) && dp.coeff_bytes == 1;
+        res &= PolyDistCoeff(&dp, 0) == 127 && PolyDistCoeff(&dp, 1) == -128;
+        res &= PolyDistBytes(&dp) == 2 * (1 + sizeof(uint64_t));
+        res &= PolyDistFromPoly(&q, 1, POLY_LEX, &dq);
+        res &= PolyDistAdd(&dp, &dq, &sum) && sum.coeff_bytes == 2;
+        res &= PolyDistCoeff(&sum, 0) == 128 && PolyDistCoeff(&sum, 1) == -128;
+        PolyDistDestroy(&dp);
+        PolyDistDestroy(&dq);
+        PolyDistDestroy(&sum);
+        PolyDestroy(&p);
+        PolyDestroy(&q);
+    }
+    {
+        // kolejne potęgi x_0 + 100 poszerzają współczynniki do 2, 4 i 8 bajtów
+        Poly base = P(C(100), 0, C(1), 1);
+        Poly expected = PolyClone(&base);
+        PolyDist d, db;
+        res &= PolyDistFromPoly(&base, 1, POLY_LEX, &d);
+        res &= PolyDistFromPoly(&base, 1, POLY_LEX, &db);
+        const unsigned widths[] = {2, 4, 4, 8, 8};
+        for (int i = 0; i < 5; i++)
+        {
+            PolyDist next;
+            res &= PolyDistMul(&d, &db, &next) && next.coeff_bytes == widths[i];
+            PolyDistDestroy(&d);
+            d = next;
+            Poly mul = PolyMul(&expected, &base);
+            PolyDestroy(&expected);
+            expected = mul;
+            Poly got = PolyDistToPoly(&d);
+            res &= PolyIsEq(&got, &expected);
+            PolyDestroy(&got);
+        }
+        PolyDistDestroy(&d);
+        PolyDistDestroy(&db);
+        PolyDestroy(&base);
+        PolyDestroy(&expected);
+    }
+    if (!res)
+        fprintf(stderr, "[CompactDistTest] fail\n");
+    return res;
+}
+
+/**
+ * Tworzy w osobnym wątku wielomian, który przeżywa wątek.
+ * @param arg : miejsce na wielomian
+ * @return NULL
+ */
+static void *AllocStatsWorker(void *arg)
+{
+    Poly base = P(P(C(1), 1, C(2), 3), 1, C(3), 2);
+    Poly *out = (Poly *) arg;
+    *out = PolyMul(&base, &base);
+    PolyDestroy(&base);
+    return NULL;
+}
+
+bool AllocStatsTest()
+{
+    bool res = true;
+    PolyAllocResetStats();
+    PolyAllocStats before = PolyAllocGetStats(POLY_ALLOC_ELEMS);
+    PolyAllocStats thread_before = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS);
+    res &= before.allocs == 0 && before.peak_bytes == before.live_bytes;
+    {
+        Poly x = P(P(C(1), 1, C(-1), 4), 2, C(5), 3);
+        Poly p = PolyMul(&x, &x);
+        Poly copy = PolyClone(&p);
+        PolyAllocStats now = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS);
+        size_t usage = PolyMemoryUsage(&x) + PolyMemoryUsage(&p);
+        res &= usage > 0;
+        res &= PolyMemoryUsage(&copy) == PolyMemoryUsage(&p);
+        // wyniki pośrednie mnożenia są już zwolnione
+        res &= now.live_bytes - thread_before.live_bytes == (long long) usage;
+        res &= now.live_nodes - thread_before.live_nodes
+               == (long long) (PolyNodeCount(&x) + PolyNodeCount(&p));
+        res &= now.peak_bytes >= now.live_bytes && now.allocs > 0;
+        PolyAllocStats lib = PolyAllocGetStats(POLY_ALLOC_ELEMS);
+        res &= lib.live_bytes - before.live_bytes == (long long) usage;
+        res &= lib.allocs == now.allocs;
+        PolyDestroy(&x);
+        PolyDestroy(&p);
+        PolyDestroy(&copy);
+
+        PolyAllocStats after = PolyAllocGetStats(POLY_ALLOC_ELEMS);
+        res &= after.live_bytes == before.live_bytes;
+        res &= after.peak_bytes >= before.live_bytes + (long long) usage;
+        PolyAllocResetStats();
+        after = PolyAllocGetStats(POLY_ALLOC_ELEMS);
+        res &= after.allocs == 0 && after.peak_bytes == after.live_bytes;
+    }
+    {
+        // liczniki wątku trafiają do liczników biblioteki przy jego wyjściu
+        Poly p;
+        pthread_t thread;
+        res &= pthread_create(&thread, NULL, AllocStatsWorker, &p) == 0;
+        pthread_join(thread, NULL);
+        PolyAllocStats lib = PolyAllocGetStats(POLY_ALLOC_ELEMS);
+        PolyAllocStats local = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS);
+        res &= lib.live_bytes - before.live_bytes == (long long) PolyMemoryUsage(&p);
+        res &= local.allocs == 0 && lib.allocs > 0;
+        PolyDestroy(&p);
+        // ten wątek zwolnił elementy przydzielone przez inny
+        local = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS);
+        res &= local.live_bytes < thread_before.live_bytes;
+        lib = PolyAllocGetStats(POLY_ALLOC_ELEMS);
+        res &= lib.live_bytes == before.live_bytes;
+    }
+    {
+        PolyAllocStats slabs = PolyAllocGetStats(POLY_ALLOC_SLABS);
+        PolyAllocStats elems = PolyAllocGetStats(POLY_ALLOC_ELEMS);
+        res &= slabs.live_nodes > 0 && slabs.live_bytes >= elems.live_bytes;
+    }
+    if (!res)
+        fprintf(stderr, "[AllocStatsTest] fail\n");
+    return res;
+}
+
+/**
+ * Tworzy losowy wielomian o zadanej głębokości.
+ * @param depth : głębokość
+ * @param terms : największa liczba jednomianów na liście
+ * @return wielomian
+ */
+static Poly RandomPoly(unsigned depth, unsigned terms)
+{
+    if (depth == 0)
+        return PolyFromCoeff(rand() % 21 - 10);
+    unsigned count = (unsigned) rand() % (terms + 1);
+    Mono *monos = malloc((count + 1) * sizeof(Mono));
+    for (unsigned i = 0; i < count; i++)
+    {
+        Poly coeff = RandomPoly(depth - 1, terms);
+        monos[i] = MonoFromPoly(&coeff, rand() % 40);
+    }
+    Poly res = PolyAddMonos(count, monos);
+    free(monos);
+    return res;
+}
+
+bool ParallelMulTest()
+{
+    bool res = true;
+    srand(41);
+    for (int round = 0; round < 20; round++)
+    {
+        Poly p = RandomPoly(3, 12);
+        Poly q = RandomPoly(3, 12);
+        Poly expected = PolyMul(&p, &q);
+        for (unsigned threads = 0; threads <= 6; threads++)
+        {
+            Poly got = PolyMulParallel(&p, &q, threads);
+            res &= PolyIsEq(&got, &expected);
+            PolyDestroy(&got);
+        }
+        PolyDestroy(&p);
+        PolyDestroy(&q);
+        PolyDestroy(&expected);
+    }
+    {
+        // wyraz wolny, jednomian o wykładniku 0 i mało wykładników wyniku
+        Poly one = C(1);
+        Poly p = P(P(C(1), 1), 0, C(2), 1);
+        Poly q = PolyAdd(&p, &one);
+        Poly expected = PolyMul(&p, &q);
+        Poly got = PolyMulParallel(&p, &q, 64);
+        res &= PolyIsEq(&got, &expected);
+        PolyDestroy(&got);
+        PolyDestroy(&expected);
+        Poly zero = PolyZero();
+        got = PolyMulParallel(&p, &zero, 4);
+        res &= PolyIsZero(&got);
+        PolyDestroy(&got);
+        PolyDestroy(&p);
+        PolyDestroy(&q);
+    }
+    if (!res)
+        fprintf(stderr, "[ParallelMulTest] fail\n");
+    return res;
+}
+
+bool SchedTest()
+{
+    bool res = true;
+    srand(42);
+    for (unsigned threads = 1; threads <= 4; threads++)
+    {
+        PolySched *s = PolySchedNew(threads);
+        for (int round = 0; round < 8; round++)
+        {
+            Poly p = RandomPoly(4, 6);
+            Poly q = RandomPoly(4, 6);
+            Poly mul = PolyMul(&p, &q);
+            Poly add = PolyAdd(&p, &q);
+            Poly at = PolyAt(&mul, 3);
+
+            Poly got_mul = PolySchedMul(s, &p, &q);
+            Poly got_add = PolySchedAdd(s, &p, &q);
+            Poly got_at = PolySchedAt(s, &mul, 3);
+            res &= PolyIsEq(&got_mul, &mul);
+            res &= PolyIsEq(&got_add, &add);
+            res &= PolyIsEq(&got_at, &at);
+            // osobno policzone iloczyny nie współdzielą elementów list,
+            // więc porównanie schodzi w głąb
+            Poly one = PolyFromCoeff(1);
+            Poly shifted = PolyAdd(&got_mul, &one);
+            res &= PolySchedIsEq(s, &got_mul, &mul);
+            res &= !PolySchedIsEq(s, &shifted, &mul);
+
+            PolyDestroy(&shifted);
+            PolyDestroy(&got_mul);
+            PolyDestroy(&got_add);
+            PolyDestroy(&got_at);
+            PolyDestroy(&p);
+            PolyDestroy(&q);
+            PolyDestroy(&mul);
+            PolyDestroy(&add);
+            PolyDestroy(&at);
+        }
+        PolySchedDestroy(s);
+    }
+    if (!res)
+        fprintf(stderr, "[SchedTest] fail\n");
+    return res;
+}
+
+bool ErrorReturnTest()
+{
+    bool res = true;
+    PolyClearError();
+    Poly c = C(1);
+    Mono m2 = MonoFromPoly(&c, 2);
+    MonoList list = MonoListPrepend(&m2, NULL);
+    res &= PolyLastError() == POLY_OK;
+
+    // wykładnik 5 nie jest mniejszy od 2 - jednomian jest odrzucany
+    Poly x = P(C(1), 1);
+    Mono m5 = MonoFromPoly(&x, 5);
+    MonoList same = MonoListPrepend(&m5, list);
+    res &= same == list && PolyLastError() == POLY_ERR_UNSORTED;
+    PolyClearError();
+    res &= PolyLastError() == POLY_OK;
+
+    Poly p = {.list = list, .coeff = 3};
+    Poly q = PolyMul(&p, &p);
+    Poly expected = P(C(9), 0, C(6), 2, C(1), 4);
+    res &= PolyIsEq(&q, &expected) && PolyLastError() == POLY_OK;
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    PolyDestroy(&expected);
+    if (!res)
+        fprintf(stderr, "[ErrorReturnTest] fail\n");
+    return res;
+}
+
+/**
+ * Wspólne dane wątków testu obciążeniowego.
+ */
+typedef struct StressShared
+{
+    const Poly *p;
+    const Poly *q;
+    const Poly *sum;
+    const Poly *mul;
+    const Poly *at;
+} StressShared;
+
+/**
+ * Zadanie wątku testu obciążeniowego.
+ */
+typedef struct StressJob
+{
+    const StressShared *shared;
+    bool ok;
+} StressJob;
+
+/**
+ * Wielokrotnie liczy sumę, iloczyn i wartość wspólnych wielomianów
+ * i porównuje je z wynikami policzonymi wcześniej.
+ * @param arg : zadanie (StressJob)
+ * @return NULL
+ */
+static void *StressWorker(void *arg)
+{
+    StressJob *job = (StressJob *) arg;
+    const StressShared *s = job->shared;
+    job->ok = true;
+    for (int i = 0; i < 30; i++)
+    {
+        Poly sum = PolyAdd(s->p, s->q);
+        Poly mul = PolyMul(s->p, s->q);
+        Poly at = PolyAt(s->mul, 7);
+        Poly copy = PolyClone(s->mul);
+        job->ok &= PolyIsEq(&sum, s->sum) && PolyIsEq(&mul, s->mul);
+        job->ok &= PolyIsEq(&at, s->at) && PolyIsEq(&copy, &mul);
+        PolyDestroy(&copy);
+        PolyDestroy(&sum);
+        PolyDestroy(&mul);
+        PolyDestroy(&at);
+    }
+    job->ok &= PolyLastError() == POLY_OK;
+    return NULL;
+}
+
+bool ThreadStressTest()
+{
+    enum { THREAD_COUNT = 8 };
+    bool res = true;
+    srand(43);
+    Poly p = RandomPoly(3, 8);
+    Poly q = RandomPoly(3, 8);
+    Poly sum = PolyAdd(&p, &q);
+    Poly mul = PolyMul(&p, &q);
+    Poly at = PolyAt(&mul, 7);
+    StressShared shared = {.p = &p, .q = &q, .sum = &sum, .mul = &mul, .at = &at};
+    StressJob jobs[THREAD_COUNT];
+    pthread_t threads[THREAD_COUNT];
+    for (int t = 0; t < THREAD_COUNT; t++)
+    {
+        jobs[t] = (StressJob) {.shared = &shared, .ok = false};
+        res &= pthread_create(&threads[t], NULL, StressWorker, &jobs[t]) == 0;
+    }
+    for (int t = 0; t < THREAD_COUNT; t++)
+    {
+        pthread_join(threads[t], NULL);
+        res &= jobs[t].ok;
+    }
+    // wspólne wielomiany są nienaruszone
+    Poly again = PolyMul(&p, &q);
+    res &= PolyIsEq(&again, &mul);
+    PolyDestroy(&again);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    PolyDestroy(&sum);
+    PolyDestroy(&mul);
+    PolyDestroy(&at);
+    if (!res)
+        fprintf(stderr, "[ThreadStressTest] fail\n");
+    return res;
+}
+
+bool AddMonosBigTest()
+{
+    enum { COUNT = 1 << 20, EXPS = 1024 };
+    bool res = true;
+    // jednomiany o powtarzających się wykładnikach w losowej kolejności,
+    // połowa z nich ze współczynnikiem zależnym od x_1
+    Mono *monos = malloc(COUNT * sizeof(Mono));
+    srand(44);
+    for (int i = 0; i < COUNT; i++)
+    {
+        Poly coeff = ((i / EXPS) % 2 == 0) ? C(1) : P(C(1), 1);
+        monos[i] = MonoFromPoly(&coeff, i % EXPS);
+    }
+    for (int i = COUNT - 1; i > 0; i--)
+    {
+        int j = rand() % (i + 1);
+        Mono tmp = monos[i];
+        monos[i] = monos[j];
+        monos[j] = tmp;
+    }
+    Poly sum = PolyAddMonos(COUNT, monos);
+    free(monos);
+
+    Mono expected_monos[EXPS];
+    for (int e = 0; e < EXPS; e++)
+    {
+        Poly coeff = P(C(COUNT / EXPS / 2), 0, C(COUNT / EXPS / 2), 1);
+        expected_monos[e] = MonoFromPoly(&coeff, e);
+    }
+    Poly expected = PolyAddMonos(EXPS, expected_monos);
+    res &= PolyIsEq(&sum, &expected) && PolyDeg(&sum) == EXPS;
+
+    // iloczyn liczony w ramach planisty sortuje jednomiany równolegle
+    Poly q = PolySub(&expected, &sum);
+    res &= PolyIsZero(&q);
+    PolyDestroy(&q);
+    PolySched *sched = PolySchedNew(4);
+    Poly square = PolyMul(&sum, &sum);
+    Poly sched_square = PolySchedMul(sched, &sum, &sum);
+    res &= PolyIsEq(&square, &sched_square);
+    PolySchedDestroy(sched);
+    PolyDestroy(&square);
+    PolyDestroy(&sched_square);
+    PolyDestroy(&sum);
+    PolyDestroy(&expected);
+    if (!res)
+        fprintf(stderr, "[AddMonosBigTest] fail\n");
+    return res;
+}
+
+/**
+ * Sprawdza wynik operacji wsadowej, porównując go z bezpośrednim
+ * wywołaniem odpowiedniej funkcji.
+ * @param op : operacja
+ * @param r : wynik
+ * @return Czy wynik jest poprawny?
+ */
+static bool BatchResultCheck(const PolyBatchOp *op, const PolyBatchResult *r)
+{
+    Poly expected = PolyZero();
+    bool res = r->error == POLY_OK;
+    switch (op->kind)
+    {
+        case POLY_BATCH_ADD:
+            expected = PolyAdd(op->p, op->q);
+            break;
+        case POLY_BATCH_SUB:
+            expected = PolySub(op->p, op->q);
+            break;
+        case POLY_BATCH_MUL:
+            expected = PolyMul(op->p, op->q);
+            break;
+        case POLY_BATCH_NEG:
+            expected = PolyNeg(op->p);
+            break;
+        case POLY_BATCH_AT:
+            expected = PolyAt(op->p, op->x);
+            break;
+        case POLY_BATCH_DEG:
+            res &= r->deg == PolyDeg(op->p);
+            break;
+        case POLY_BATCH_DEG_BY:
+            res &= r->deg == PolyDegBy(op->p, op->var_idx);
+            break;
+        case POLY_BATCH_IS_EQ:
+            res &= r->eq == PolyIsEq(op->p, op->q);
+            break;
+    }
+    res &= PolyIsEq(&(r->poly), &expected);
+    PolyDestroy(&expected);
+    return res;
+}
+
+bool BatchTest()
+{
+    enum { POLYS = 64, OPS = 3000, KINDS = POLY_BATCH_IS_EQ + 1 };
+    bool res = true;
+    srand(45);
+    Poly polys[POLYS];
+    for (int i = 0; i < POLYS; i++)
+        polys[i] = RandomPoly(2 + i % 2, 4 + i % 5);
+    // operacje wszystkich rodzajów na losowych, współdzielonych argumentach,
+    // wśród nich kilka kosztownych mnożeń
+    PolyBatchOp ops[OPS];
+    for (int i = 0; i < OPS; i++)
+    {
+        ops[i] = (PolyBatchOp) {.kind = (PolyBatchKind) (i % KINDS),
+                                .p = &polys[rand() % POLYS], .q = &polys[rand() % POLYS],
+                                .x = rand() % 7 - 3, .var_idx = rand() % 3};
+        if (ops[i].kind == POLY_BATCH_IS_EQ && i % 2 == 0)
+            ops[i].q = ops[i].p;
+    }
+    Poly big = RandomPoly(3, 12);
+    ops[OPS / 2] = (PolyBatchOp) {.kind = POLY_BATCH_MUL, .p = &big, .q = &big};
+
+    PolyBatchResult results[OPS];
+    for (unsigned threads = 0; threads <= 4; threads += 2)
+    {
+        PolySched *sched = (threads == 0) ? NULL : PolySchedNew(threads);
+        PolyBatchRun(sched, ops, OPS, results);
+        for (int i = 0; i < OPS; i++)
+        {
+            if (!BatchResultCheck(&ops[i], &results[i]))
+            {
+                fprintf(stderr, "[BatchTest] op %d kind %d (threads %u)\n",
+                        i, ops[i].kind, threads);
+                res = false;
+                break;
+            }
+        }
+        PolyBatchResultsDestroy(results, OPS);
+        PolySchedDestroy(sched);
+    }
+    PolyBatchRun(NULL, ops, 0, results);
+
+    for (int i = 0; i < POLYS; i++)
+        PolyDestroy(&polys[i]);
+    PolyDestroy(&big);
+    if (!res)
+        fprintf(stderr, "[BatchTest] fail\n");
+    return res;
+}
+
+bool AsyncTest()
+{
+    bool res = true;
+    Poly p = P(C(1), 0, P(C(2), 1), 1, C(-1), 3);
+    Poly q = P(C(3), 0, C(1), 2);
+
+    // argumenty można usunąć zaraz po uruchomieniu operacji
+    Poly p_copy = PolyClone(&p);
+    Poly q_copy = PolyClone(&q);
+    PolyFuture *mul = PolyMulAsync(&p_copy, &q_copy);
+    PolyFuture *add = PolyAddAsync(&p_copy, &q_copy);
+    PolyFuture *pow = PolyPowAsync(&p_copy, 5);
+    PolyDestroy(&p_copy);
+    PolyDestroy(&q_copy);
+
+    Poly expected = PolyMul(&p, &q);
+    Poly r;
+    res &= PolyFutureWait(mul, &r) == POLY_FUTURE_DONE && PolyIsEq(&r, &expected);
+    res &= PolyFuturePoll(mul) == POLY_FUTURE_DONE;
+    PolyDestroy(&r);
+    PolyDestroy(&expected);
+    // wynik odbiera się tylko raz
+    res &= PolyFutureWait(mul, &r) == POLY_FUTURE_DONE && PolyIsZero(&r);
+
+    expected = PolyAdd(&p, &q);
+    res &= PolyFutureWait(add, &r) == POLY_FUTURE_DONE && PolyIsEq(&r, &expected);
+    PolyDestroy(&r);
+    PolyDestroy(&expected);
+
+    expected = PolyFromCoeff(1);
+    for (int i = 0; i < 5; i++)
+    {
+        Poly next = PolyMul(&expected, &p);
+        PolyDestroy(&expected);
+        expected = next;
+    }
+    res &= PolyFutureWait(pow, &r) == POLY_FUTURE_DONE && PolyIsEq(&r, &expected);
+    PolyDestroy(&r);
+    PolyDestroy(&expected);
+    PolyFutureDestroy(mul);
+    PolyFutureDestroy(add);
+    PolyFutureDestroy(pow);
+
+    // potęgowanie, które trwałoby bardzo długo, przerywamy w trakcie;
+    // częściowe wyniki są usuwane (sprawdza to ASan/valgrind)
+    Poly f = P(C(1), 0, C(1), 1, P(C(1), 1), 2, P(P(C(1), 1), 1), 3);
+    PolyFuture *slow = PolyPowAsync(&f, 1000000);
+    PolyFuture *slow_mul = PolyPowAsync(&f, 1000000);
+    for (int i = 0; i < 20; i++)
+        sched_yield();
+    PolyFutureCancel(slow);
+    res &= PolyFutureWait(slow, &r) == POLY_FUTURE_CANCELLED && PolyIsZero(&r);
+    res &= PolyFuturePoll(slow) == POLY_FUTURE_CANCELLED;
+    PolyFutureDestroy(slow);
+    // usunięcie uchwytu trwającej operacji również ją przerywa
+    PolyFutureDestroy(slow_mul);
+    PolyFutureDestroy(NULL);
+
+    // operacja podlega budżetowi wątku, który ją uruchomił; przekroczenie
+    // kończy ją błędem, a nie niepełnym wynikiem
+    PolyClearError();
+    PolyBudget terms = {.max_terms = 100};
+    PolyBudgetSet(&terms);
+    Poly dense = P(C(1), 0, C(1), 1, C(1), 2, C(1), 3, C(1), 4, C(1), 5, C(1), 6,
+                   C(1), 7, C(1), 8, C(1), 9, C(1), 10);
+    PolyFuture *over = PolyPowAsync(&dense, 20);
+    res &= PolyFutureWait(over, &r) == POLY_FUTURE_FAILED && PolyIsZero(&r);
+    res &= PolyFutureError(over) == POLY_ERR_BUDGET;
+    res &= PolyLastError() == POLY_OK;
+    PolyFutureDestroy(over);
+    PolyFuture *fits = PolyMulAsync(&dense, &dense);
+    res &= PolyFutureWait(fits, &r) == POLY_FUTURE_DONE && PolyDeg(&r) == 20;
+    res &= PolyFutureError(fits) == POLY_OK;
+    PolyDestroy(&r);
+    PolyFutureDestroy(fits);
+    PolyBudgetSet(NULL);
+    PolyDestroy(&dense);
+
+    PolyDestroy(&f);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    if (!res)
+        fprintf(stderr, "[AsyncTest] fail\n");
+    return res;
+}
+
+/**
+ * Tworzy gęsty wielomian zmiennej @f$x_0@f$ o współczynnikach 1.
+ * @param deg : stopień
+ * @return @f$1 + x_0 + \ldots + x_0^{deg}@f$
+ */
+static Poly DenseOnes(poly_exp_t deg)
+{
+    Mono *monos = malloc(((size_t) deg + 1) * sizeof(Mono));
+    for (poly_exp_t i = 0; i <= deg; i++)
+    {
+        Poly c = C(1);
+        monos[i] = MonoFromPoly(&c, i);
+    }
+    Poly p = PolyAddMonos((unsigned) deg + 1, monos);
+    free(monos);
+    return p;
+}
+
+bool BudgetTest()
+{
+    bool res = true;
+    PolyClearError();
+    Poly small = DenseOnes(5);
+    Poly p = DenseOnes(300);
+    Poly q = RandomPoly(3, 10);
+
+    // limit liczby jednomianów wyniku
+    PolyBudget terms = {.max_terms = 100};
+    PolyBudgetSet(&terms);
+    Poly r = PolyMul(&small, &small);
+    res &= PolyDeg(&r) == 10 && PolyLastError() == POLY_OK;
+    PolyDestroy(&r);
+    r = PolyMul(&p, &p);
+    res &= PolyIsZero(&r) && PolyLastError() == POLY_ERR_BUDGET;
+    // do wyzerowania błędu kolejne operacje kończą się od razu
+    r = PolyAdd(&small, &p);
+    res &= PolyIsZero(&r);
+    // zadania planisty zaczynają bez błędu wątku i go nie zmieniają
+    PolySched *sched = PolySchedNew(2);
+    PolyBatchOp ops[2] = {{.kind = POLY_BATCH_ADD, .p = &small, .q = &small},
+                          {.kind = POLY_BATCH_NEG, .p = &small}};
+    PolyBatchResult results[2];
+    PolyBatchRun(sched, ops, 2, results);
+    res &= results[0].error == POLY_OK && PolyDeg(&results[0].poly) == 5;
+    res &= results[1].error == POLY_OK && PolyDeg(&results[1].poly) == 5;
+    res &= PolyLastError() == POLY_ERR_BUDGET;
+    PolyBatchResultsDestroy(results, 2);
+    PolySchedDestroy(sched);
+    PolyClearError();
+    r = PolyMulParallel(&p, &p, 4);
+    res &= PolyIsZero(&r) && PolyLastError() == POLY_ERR_BUDGET;
+    PolyClearError();
+    // błąd operacji wsadu trafia tylko do jej wyniku
+    PolyBatchOp mixed[2] = {{.kind = POLY_BATCH_ADD, .p = &small, .q = &small},
+                            {.kind = POLY_BATCH_MUL, .p = &p, .q = &p}};
+    PolyBatchRun(NULL, mixed, 2, results);
+    res &= results[0].error == POLY_OK && PolyDeg(&results[0].poly) == 5;
+    res &= results[1].error == POLY_ERR_BUDGET && PolyIsZero(&results[1].poly);
+    res &= PolyLastError() == POLY_OK;
+    PolyBatchResultsDestroy(results, 2);
+
+    // limit pamięci; częściowe wyniki są usuwane (liczniki wątku
+    // porównujemy dopiero tutaj, bo elementy z wątków PolyMulParallel
+    // zwalniane są w bieżącym wątku)
+    long long live = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes;
+    PolyBudget bytes = {.max_bytes = 16 * 1024};
+    PolyBudgetSet(&bytes);
+    r = PolyMul(&q, &q);
+    Poly r2 = PolyMul(&r, &q);
+    Poly r3 = PolyMul(&r2, &r2);
+    res &= PolyIsZero(&r3) && PolyLastError() == POLY_ERR_BUDGET;
+    PolyDestroy(&r);
+    PolyDestroy(&r2);
+    res &= PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes == live;
+    PolyClearError();
+
+    // limit czasu
+    Poly big = DenseOnes(3000);
+    live = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes;
+    PolyBudget time = {.max_seconds = 0.02};
+    PolyBudgetSet(&time);
+    r = PolyMul(&big, &big);
+    res &= PolyIsZero(&r) && PolyLastError() == POLY_ERR_BUDGET;
+    res &= PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes == live;
+    PolyClearError();
+
+    // bez budżetu operacje działają jak zwykle
+    PolyBudgetSet(NULL);
+    r = PolyMul(&p, &p);
+    res &= PolyDeg(&r) == 600 && PolyLastError() == POLY_OK;
+    PolyDestroy(&r);
+
+    PolyDestroy(&big);
+    PolyDestroy(&small);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+    if (!res)
+        fprintf(stderr, "[BudgetTest] fail\n");
+    return res;
+}
+
+/**
+ * Sprawdza pasy wektora z wielomianami i ich wartości w punkcie.
+ * @param v : wektor
+ * @param expected : spodziewane wielomiany pasów
+ * @param x : punkt (3 zmienne)
+ * @return Czy wszystkie pasy się zgadzają?
+ */
+static bool VecCheck(const PolyVec *v, const Poly expected[], const poly_coeff_t x[])
+{
+    bool res = true;
+    poly_coeff_t *values = malloc((v->lanes + 1) * sizeof(poly_coeff_t));
+    PolyVecAt(v, x, values);
+    for (size_t l = 0; l < v->lanes; l++)
+    {
+        Poly got = PolyVecGet(v, l);
+        res &= PolyIsEq(&got, &expected[l]);
+        PolyDestroy(&got);
+
+        Poly at0 = PolyAt(&expected[l], x[0]);
+        Poly at1 = PolyAt(&at0, x[1]);
+        Poly at2 = PolyAt(&at1, x[2]);
+        res &= PolyIsCoeff(&at2) && at2.coeff == values[l];
+        PolyDestroy(&at0);
+        PolyDestroy(&at1);
+        PolyDestroy(&at2);
+    }
+    free(values);
+    return res;
+}
+
+bool VecTest()
+{
+    bool res = true;
+    srand(48);
+    enum { LANES = 37 };
+    Poly a[LANES], b[LANES], sum[LANES], prod[LANES];
+    for (size_t l = 0; l < LANES; l++)
+    {
+        a[l] = RandomPoly(3, 4);
+        b[l] = RandomPoly(3, 4);
+        sum[l] = PolyAdd(&a[l], &b[l]);
+        prod[l] = PolyMul(&a[l], &b[l]);
+    }
+    // wartości zmiennych są małe, żeby PolyAt nie przepełniało
+    const poly_coeff_t x[3] = {-1, 1, -1};
+
+    PolyVec va, vb, too_short;
+    res &= PolyVecFromPolys(a, LANES, 3, &va);
+    res &= PolyVecFromPolys(b, LANES, 3, &vb);
+    res &= !PolyVecFromPolys(a, LANES, 2, &too_short);
+    res &= VecCheck(&va, a, x);
+
+    // jądra AVX2 (jeśli są dostępne) i skalarne dają te same wyniki
+    for (int simd = 1; simd >= 0; simd--)
+    {
+        PolyVecEnableSimd(simd);
+        PolyVec vs, vp;
+        res &= PolyVecAdd(&va, &vb, &vs) && VecCheck(&vs, sum, x);
+        res &= PolyVecMul(&va, &vb, &vp) && VecCheck(&vp, prod, x);
+        PolyVecDestroy(&vs);
+        PolyVecDestroy(&vp);
+    }
+    PolyVecEnableSimd(true);
+
+    // a + (-a) daje wektor bez wyrazów
+    Poly neg[LANES];
+    for (size_t l = 0; l < LANES; l++)
+        neg[l] = PolyNeg(&a[l]);
+    PolyVec vn, vz;
+    res &= PolyVecFromPolys(neg, LANES, 3, &vn);
+    res &= PolyVecAdd(&va, &vn, &vz) && vz.terms == 0;
+    Poly zero = PolyVecGet(&vz, 0);
+    res &= PolyIsZero(&zero);
+    PolyDestroy(&zero);
+    PolyVecDestroy(&vz);
+    // niezgodne wektory
+    PolyVec vbad;
+    res &= PolyVecFromPolys(a, LANES - 1, 3, &vbad);
+    res &= !PolyVecAdd(&va, &vbad, &vz) && !PolyVecMul(&va, &vbad, &vz);
+    PolyVecDestroy(&vbad);
+    PolyVecDestroy(&vn);
+    PolyVecDestroy(&va);
+    PolyVecDestroy(&vb);
+
+    for (size_t l = 0; l < LANES; l++)
+    {
+        PolyDestroy(&a[l]);
+        PolyDestroy(&b[l]);
+        PolyDestroy(&sum[l]);
+        PolyDestroy(&prod[l]);
+        PolyDestroy(&neg[l]);
+    }
+    if (!res)
+        fprintf(stderr, "[VecTest] fail\n");
+    return res;
+}
+
+bool SumDotTest()
+{
+    bool res = true;
+    srand(49);
+    long long live = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes;
+    enum { N = 40 };
+    Poly a[N], b[N];
+    for (unsigned i = 0; i < N; i++)
+    {
+        a[i] = RandomPoly(3, 6);
+        b[i] = RandomPoly(3, 6);
+    }
+    // wielomiany, które się znoszą, i sam wyraz wolny
+    PolyDestroy(&a[7]);
+    a[7] = PolyNeg(&a[3]);
+    PolyDestroy(&a[11]);
+    a[11] = C(5);
+
+    for (unsigned n = 0; n <= N; n += (n < 4) ? 1 : 9)
+    {
+        Poly sum = PolyZero();
+        Poly dot = PolyZero();
+        for (unsigned i = 0; i < n; i++)
+        {
+            Poly next = PolyAdd(&sum, &a[i]);
+            PolyDestroy(&sum);
+            sum = next;
+            Poly mul = PolyMul(&a[i], &b[i]);
+            next = PolyAdd(&dot, &mul);
+            PolyDestroy(&dot);
+            PolyDestroy(&mul);
+            dot = next;
+        }
+        Poly got_sum = PolySumN(a, n);
+        Poly got_dot = PolyDot(a, b, n);
+        res &= PolyIsEq(&got_sum, &sum);
+        res &= PolyIsEq(&got_dot, &dot);
+        PolyDestroy(&got_sum);
+        PolyDestroy(&got_dot);
+        PolyDestroy(&sum);
+        PolyDestroy(&dot);
+    }
+
+    // p + (-p) + 0 daje zero
+    Poly cancel[3] = {PolyClone(&a[3]), PolyNeg(&a[3]), PolyZero()};
+    Poly zero = PolySumN(cancel, 3);
+    res &= PolyIsZero(&zero);
+    zero = PolyDot(cancel, cancel + 1, 2);
+    Poly square = PolyMul(&cancel[0], &cancel[1]);
+    res &= PolyIsEq(&zero, &square);
+    PolyDestroy(&zero);
+    PolyDestroy(&square);
+    for (unsigned i = 0; i < 3; i++)
+        PolyDestroy(&cancel[i]);
+
+    // iloczyny sumowane w kilku porcjach
+    Poly dense[3] = {DenseOnes(200), DenseOnes(150), DenseOnes(250)};
+    Poly dot = PolyDot(dense, dense, 3);
+    Poly parts[3];
+    for (unsigned i = 0; i < 3; i++)
+        parts[i] = PolyMul(&dense[i], &dense[i]);
+    Poly sum = PolySumN(parts, 3);
+    res &= PolyIsEq(&dot, &sum) && PolyDeg(&dot) == 500;
+    PolyDestroy(&dot);
+    PolyDestroy(&sum);
+    for (unsigned i = 0; i < 3; i++)
+    {
+        PolyDestroy(&dense[i]);
+        PolyDestroy(&parts[i]);
+    }
+
+    for (unsigned i = 0; i < N; i++)
+    {
+        PolyDestroy(&a[i]);
+        PolyDestroy(&b[i]);
+    }
+    // wyniki częściowe nie zostają w pamięci
+    res &= PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes == live;
+    if (!res)
+        fprintf(stderr, "[SumDotTest] fail\n");
+    return res;
+}
+
+/**
+ * Porównuje wielomian ze spodziewanym razem z parametrami pamiętanymi
+ * w elementach list (po zmianach w miejscu muszą być przeliczone).
+ * @param p : wielomian
+ * @param expected : spodziewany wielomian
+ * @return Czy wielomiany i ich parametry są równe?
+ */
+static bool FmaCheck(const Poly *p, const Poly *expected)
+{
+    return PolyIsEq(p, expected) && PolyHash(p) == PolyHash(expected)
+           && PolyTermCount(p) == PolyTermCount(expected)
+           && PolyNodeCount(p) == PolyNodeCount(expected)
+           && PolyDepth(p) == PolyDepth(expected) && PolyDeg(p) == PolyDeg(expected)
+           && PolyDegBy(p, 0) == PolyDegBy(expected, 0);
+}
+
+bool FmaTest()
+{
+    bool res = true;
+    srand(50);
+    long long live = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes;
+
+    // acc = acc + p * q dla losowych wielomianów, także współdzielonych
+    Poly acc = RandomPoly(3, 6);
+    Poly expected = PolyClone(&acc);
+    for (int round = 0; round < 30; round++)
+    {
+        Poly p = RandomPoly(3, 5);
+        Poly q = (round % 5 == 0) ? C(rand() % 7 - 3) : RandomPoly(3, 5);
+        Poly mul = PolyMul(&p, &q);
+        Poly next = PolyAdd(&expected, &mul);
+        PolyDestroy(&expected);
+        expected = next;
+
+        Poly shared = (round % 3 == 0) ? PolyClone(&acc) : PolyZero();
+        Poly shared_before = PolyClone(&shared);
+        PolyFma(&acc, &p, &q);
+        res &= FmaCheck(&acc, &expected);
+        // wielomian współdzielący elementy z acc się nie zmienia
+        res &= FmaCheck(&shared, &shared_before);
+        PolyDestroy(&shared);
+        PolyDestroy(&shared_before);
+        PolyDestroy(&mul);
+        PolyDestroy(&p);
+        PolyDestroy(&q);
+    }
+
+    // acc jako czynnik
+    Poly q = RandomPoly(2, 4);
+    Poly mul = PolyMul(&acc, &q);
+    Poly next = PolyAdd(&acc, &mul);
+    PolyFma(&acc, &acc, &q);
+    res &= FmaCheck(&acc, &next);
+    PolyDestroy(&mul);
+    PolyDestroy(&next);
+
+    // iloczyn znoszący się z acc
+    PolyDestroy(&acc);
+    Poly neg_q = PolyNeg(&q);
+    acc = PolyMul(&q, &neg_q);
+    PolyFma(&acc, &q, &q);
+    res &= PolyIsZero(&acc);
+    PolyDestroy(&neg_q);
+    PolyDestroy(&q);
+    PolyDestroy(&expected);
+
+    // wykładniki iloczynu już są w acc - nie powstają nowe elementy
+    acc = DenseOnes(100);
+    Poly p = DenseOnes(10);
+    expected = PolyMul(&p, &p);
+    next = PolyAdd(&acc, &expected);
+    long long before = PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes;
+    PolyFma(&acc, &p, &p);
+    res &= PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes == before;
+    res &= FmaCheck(&acc, &next);
+    PolyDestroy(&acc);
+    PolyDestroy(&next);
+    PolyDestroy(&expected);
+    PolyDestroy(&p);
+
+    res &= PolyAllocGetThreadStats(POLY_ALLOC_ELEMS).live_nodes == live;
+    if (!res)
+        fprintf(stderr, "[FmaTest] fail\n");
+    return res;
+}